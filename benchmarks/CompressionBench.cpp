@@ -0,0 +1,348 @@
+#include "Atometa/Network/Compression.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ── AtometaCompressionBench ───────────────────────────────────────────────
+// What deflating the control and bulk lanes costs per student, frame by
+// frame, without the network in the way. Every student has its own
+// deflate streams, so the host pays the deflate time below once per
+// student for every frame, and each student the inflate time once.
+// One result row per (payload, level):
+//
+//   AtometaCompressionBench [--payload snapshot,delta,mesh,noise]
+//                           [--levels 1,6] [--models 200] [--frames 200]
+//                           [--output csv|json]
+//
+//   snapshot  SceneSnapshot of --models models, as sent on every join
+//   delta     SceneDelta moving a handful of them, as sent every tick
+//             the professor drags something
+//   mesh      64 KB AssetChunk of interleaved vertex data (positions,
+//             normals, UVs) on a smooth surface
+//   noise     64 KB AssetChunk of random bytes: already-compressed
+//             textures, the worst case
+//
+// Frames of a row go through one stream in order, so later ones are
+// compressed against the window of earlier ones, as on a connection.
+// Frames the deflater leaves raw (see FrameDeflater) count as sent raw;
+// the inflate check compares every frame that was compressed with the
+// original.
+// ─────────────────────────────────────────────────────────────────────────
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+    using namespace Atometa;
+
+    // ── Options ───────────────────────────────────────────────────────────
+
+    struct BenchOptions {
+        std::vector<std::string> Payloads = { "snapshot", "delta", "mesh", "noise" };
+        std::vector<size_t>      Levels   = { 1, 6 };
+        size_t                   Models   = 200;
+        size_t                   Frames   = 200;
+        bool                     Json     = false;   // output format
+    };
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: AtometaCompressionBench [--payload snapshot,delta,mesh,noise]\n"
+                     "                               [--levels 1,6] [--models 200] [--frames 200]\n"
+                     "                               [--output csv|json]\n";
+    }
+
+    std::vector<std::string> ParseNames(const char* text)
+    {
+        std::vector<std::string> names;
+        std::istringstream iss(text);
+        std::string token;
+        while (std::getline(iss, token, ','))
+            if (!token.empty()) names.push_back(token);
+        return names;
+    }
+
+    std::vector<size_t> ParseList(const char* text)
+    {
+        std::vector<size_t> values;
+        for (const auto& token : ParseNames(text))
+            if (auto v = std::strtoul(token.c_str(), nullptr, 10); v > 0 && v <= 9)
+                values.push_back(v);
+        return values;
+    }
+
+    bool ParseArgs(int argc, char** argv, BenchOptions& opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg  = argv[i];
+            const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (!std::strcmp(arg, "--help") || !std::strcmp(arg, "-h"))
+                return false;
+            if (!next) {
+                std::cerr << "Missing value for " << arg << '\n';
+                return false;
+            }
+
+            if      (!std::strcmp(arg, "--payload")) opts.Payloads = ParseNames(next);
+            else if (!std::strcmp(arg, "--levels"))  opts.Levels   = ParseList(next);
+            else if (!std::strcmp(arg, "--models"))  opts.Models   = std::strtoul(next, nullptr, 10);
+            else if (!std::strcmp(arg, "--frames"))  opts.Frames   = std::strtoul(next, nullptr, 10);
+            else if (!std::strcmp(arg, "--output"))  opts.Json     = !std::strcmp(next, "json");
+            else {
+                std::cerr << "Unknown option " << arg << '\n';
+                return false;
+            }
+            ++i;
+        }
+        return !opts.Payloads.empty() && !opts.Levels.empty() && opts.Frames > 0 &&
+               opts.Models > 0 && opts.Models <= UINT16_MAX;
+    }
+
+    // ── Payloads ──────────────────────────────────────────────────────────
+
+    NetNode Model(size_t i, float t)
+    {
+        NetNode node;
+        node.Index    = static_cast<uint16_t>(i);
+        node.Fields   = kNodeFieldAll;
+        node.Position = { std::sin(i * 0.7f) * 4.f + t, 0.25f * i, std::cos(i * 0.3f) };
+        node.Rotation = { 0.f, std::fmod(i * 37.f + t * 90.f, 360.f), 0.f };
+        node.Scale    = 1.f + (i % 5) * 0.1f;
+        node.Name     = "Anatomy/Thorax/Structure_" + std::to_string(i);
+        return node;
+    }
+
+    std::string Snapshot(size_t models, size_t frame)
+    {
+        NetMessage msg;
+        msg.Type      = NetMsgType::SceneSnapshot;
+        msg.Sequence  = static_cast<uint32_t>(frame + 1);
+        msg.NodeCount = static_cast<uint16_t>(models);
+        msg.NodeIndex = static_cast<int32_t>(frame % models);
+        for (size_t i = 0; i < models; ++i)
+            msg.Nodes.push_back(Model(i, i == frame % models ? frame * 0.01f : 0.f));
+        return msg.Serialize(WireFormat::Binary);
+    }
+
+    // The professor drags a few models: their transforms change
+    std::string Delta(size_t models, size_t frame)
+    {
+        NetMessage msg;
+        msg.Type      = NetMsgType::SceneDelta;
+        msg.Sequence  = static_cast<uint32_t>(frame + 1);
+        msg.NodeCount = static_cast<uint16_t>(models);
+        msg.NodeIndex = 3 % static_cast<int32_t>(models);
+        for (size_t k = 0; k < std::min<size_t>(models, 8); ++k) {
+            NetNode node  = Model((k * 13) % models, frame * 0.01f);
+            node.Fields   = kNodeFieldPosition | kNodeFieldRotation;
+            msg.Nodes.push_back(node);
+        }
+        return msg.Serialize(WireFormat::Binary);
+    }
+
+    std::string Chunk(std::string blob, size_t frame)
+    {
+        NetMessage msg;
+        msg.Type      = NetMsgType::AssetChunk;
+        msg.ChunkHash = std::to_string(1000000 + frame);
+        msg.Blob      = std::move(blob);
+        return msg.Serialize(WireFormat::Binary);
+    }
+
+    // Position, normal and UV of points on a rippled sphere, in the order
+    // a mesh exporter writes them
+    std::string Mesh(size_t frame)
+    {
+        constexpr size_t kVertices = 64 * 1024 / 32;
+        std::string blob(kVertices * 32, '\0');
+        for (size_t v = 0; v < kVertices; ++v) {
+            size_t n     = frame * kVertices + v;
+            float  theta = (n % 256) / 256.f * 3.14159f;
+            float  phi   = (n / 256 % 512) / 512.f * 6.28318f;
+            float  r     = 1.f + 0.02f * std::sin(phi * 9.f);
+            float  attr[8] = {
+                r * std::sin(theta) * std::cos(phi), r * std::cos(theta),
+                r * std::sin(theta) * std::sin(phi),
+                std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi),
+                phi / 6.28318f, theta / 3.14159f,
+            };
+            std::memcpy(&blob[v * 32], attr, sizeof(attr));
+        }
+        return Chunk(std::move(blob), frame);
+    }
+
+    std::string Noise(size_t frame)
+    {
+        std::string blob(64 * 1024, '\0');
+        uint32_t    state = static_cast<uint32_t>(frame * 2654435761u + 1);
+        for (auto& c : blob) {
+            state = state * 1664525u + 1013904223u;
+            c     = static_cast<char>(state >> 24);
+        }
+        return Chunk(std::move(blob), frame);
+    }
+
+    bool MakeFrames(const std::string& payload, const BenchOptions& opts,
+                    std::vector<std::string>& frames)
+    {
+        for (size_t i = 0; i < opts.Frames; ++i) {
+            if      (payload == "snapshot") frames.push_back(Snapshot(opts.Models, i));
+            else if (payload == "delta")    frames.push_back(Delta(opts.Models, i));
+            else if (payload == "mesh")     frames.push_back(Mesh(i));
+            else if (payload == "noise")    frames.push_back(Noise(i));
+            else return false;
+        }
+        return true;
+    }
+
+    // ── One run ───────────────────────────────────────────────────────────
+
+    struct BenchResult {
+        std::string Payload;
+        size_t      Level       = 0;
+        size_t      Frames      = 0;
+        size_t      Compressed  = 0;   // sent as Compressed frames, the rest raw
+        double      FrameBytes  = 0;   // average, uncompressed
+        double      WireBytes   = 0;   // average, as sent
+        double      Ratio       = 0;   // wire / frame
+        double      DeflateUs   = 0;   // per frame: host CPU per student
+        double      InflateUs   = 0;   // per frame: student CPU
+        double      DeflateMBps = 0;   // uncompressed MB per second of one core
+        bool        Ok          = true;
+    };
+
+    double Micros(Clock::duration d)
+    {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+
+    BenchResult RunOnce(const std::vector<std::string>& frames, const std::string& payload,
+                        size_t level)
+    {
+        BenchResult result;
+        result.Payload = payload;
+        result.Level   = level;
+        result.Frames  = frames.size();
+
+        FrameDeflater            deflater(1, static_cast<int>(level));
+        std::vector<std::string> wire(frames.size());
+        uint64_t                 in = 0, out = 0;
+
+        // Frames the deflater passes on go out as they are, as the host
+        // sends them
+        auto start = Clock::now();
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (deflater.Compress(frames[i], wire[i]))
+                ++result.Compressed;
+            else
+                wire[i] = frames[i];
+        }
+        double deflateUs = Micros(Clock::now() - start);
+
+        FrameInflater inflater;
+        std::string   frame;
+        NetMessage    msg;
+        start = Clock::now();
+        for (size_t i = 0; i < wire.size(); ++i) {
+            result.Ok &= NetMessage::Deserialize(wire[i], msg);
+            if (msg.Type == NetMsgType::Compressed)
+                result.Ok &= inflater.Expand(msg, frame) && frame == frames[i];
+        }
+        double inflateUs = Micros(Clock::now() - start);
+
+        for (size_t i = 0; i < frames.size(); ++i) {
+            in  += frames[i].size();
+            out += wire[i].size();
+        }
+
+        double n           = static_cast<double>(frames.size());
+        result.FrameBytes  = in / n;
+        result.WireBytes   = out / n;
+        result.Ratio       = in ? double(out) / in : 0.0;
+        result.DeflateUs   = deflateUs / n;
+        result.InflateUs   = inflateUs / n;
+        result.DeflateMBps = deflateUs > 0.0 ? in / deflateUs : 0.0;
+        return result;
+    }
+
+    // ── Output ────────────────────────────────────────────────────────────
+
+    void PrintCsvHeader()
+    {
+        std::cout << "payload,level,frames,compressed,frame_bytes,wire_bytes,ratio,deflate_us,inflate_us,"
+                     "deflate_mb_per_sec,ok\n";
+    }
+
+    void PrintCsv(const BenchResult& r)
+    {
+        std::cout << r.Payload << ',' << r.Level << ',' << r.Frames << ',' << r.Compressed << ','
+                  << r.FrameBytes << ',' << r.WireBytes << ',' << r.Ratio << ','
+                  << r.DeflateUs << ',' << r.InflateUs << ',' << r.DeflateMBps << ','
+                  << (r.Ok ? 1 : 0) << std::endl;
+    }
+
+    json ToJson(const BenchResult& r)
+    {
+        return {
+            { "payload",            r.Payload },
+            { "level",              r.Level },
+            { "frames",             r.Frames },
+            { "compressed",         r.Compressed },
+            { "frame_bytes",        r.FrameBytes },
+            { "wire_bytes",         r.WireBytes },
+            { "ratio",              r.Ratio },
+            { "deflate_us",         r.DeflateUs },
+            { "inflate_us",         r.InflateUs },
+            { "deflate_mb_per_sec", r.DeflateMBps },
+            { "ok",                 r.Ok },
+        };
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    BenchOptions opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    json runs = json::array();
+    if (!opts.Json) PrintCsvHeader();
+
+    for (const auto& payload : opts.Payloads) {
+        std::vector<std::string> frames;
+        if (!MakeFrames(payload, opts, frames)) {
+            std::cerr << "Unknown payload " << payload << '\n';
+            return 1;
+        }
+        for (size_t level : opts.Levels) {
+            BenchResult result = RunOnce(frames, payload, level);
+            if (opts.Json) runs.push_back(ToJson(result));
+            else           PrintCsv(result);
+        }
+    }
+
+    if (opts.Json) {
+        json report = {
+            { "models", opts.Models },
+            { "frames", opts.Frames },
+            { "runs",   runs },
+        };
+        std::cout << report.dump(2) << std::endl;
+    }
+
+    return 0;
+}
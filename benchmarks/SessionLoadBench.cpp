@@ -0,0 +1,701 @@
+#include "Atometa/Network/NetworkLayer.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/beast/http.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(ATOMETA_PLATFORM_LINUX) || defined(ATOMETA_PLATFORM_MACOS)
+    #include <pthread.h>
+    #include <sys/resource.h>
+    #include <time.h>
+#endif
+
+// ── AtometaSessionBench ───────────────────────────────────────────────────
+// Load generator for the host side of NetworkLayer. Starts a host on
+// loopback, connects N synthetic students (lightweight async WebSocket
+// clients on the benchmark's own threads) and broadcasts CameraSync at a
+// fixed rate. One result row per (clients, io threads) combination:
+// end-to-end latency percentiles, host CPU, bytes/s and dropped frames.
+// All students connect at once, like a class starting; join latency is
+// the time from a student's connect() to the join snapshot's camera frame.
+//
+//   AtometaSessionBench [--clients 50,200,1000] [--io-threads 1,2,4]
+//                       [--rate 60] [--duration 5] [--format binary|json]
+//                       [--client-threads 2] [--port 18631] [--output csv|json]
+//                       [--uplink-rate 0] [--noisy 0]
+//                       [--scene 0] [--scene-rate 0] [--compress on|off|both]
+//
+// With --uplink-rate, every student also sends the host a ChatMessage
+// that often while the camera runs, and --noisy of them instead send as
+// fast as their socket takes it. The host's per-student rate limit is
+// left at its default; the uplink columns show what got through, how
+// long a well-behaved student's messages took to reach OnMessage, and
+// how evenly the well-behaved students were served (Jain's index, 1 =
+// all alike).
+//
+// With --scene, the host replicates that many models and broadcasts a
+// SceneDelta --scene-rate times a second, a tenth of the models moved in
+// each; every student also gets the scene's snapshot on join. --compress
+// both runs each combination with and without deflate (Compression.h), so
+// the bytes/s and host CPU columns show what it saves on the wire and
+// what it costs per student. Students only decode the camera frames.
+//
+// Each frame carries its sequence number in Camera.Yaw (exact for any
+// run shorter than 2^24 frames), so the students can look up the send
+// time without a protocol change. A student that never sees a frame —
+// coalesced away in a slow queue, or lost with a dropped connection —
+// counts it as dropped.
+// ─────────────────────────────────────────────────────────────────────────
+
+namespace beast = boost::beast;
+namespace http  = beast::http;
+namespace ws    = beast::websocket;
+namespace asio  = boost::asio;
+using     tcp   = asio::ip::tcp;
+using     Clock = std::chrono::steady_clock;
+
+namespace {
+
+    // ── Options ───────────────────────────────────────────────────────────
+
+    struct BenchOptions {
+        std::vector<size_t> Clients       = { 50, 200, 1000 };
+        std::vector<size_t> IOThreads     = { 1, 2, 4 };
+        double              RateHz        = 60.0;
+        double              Duration      = 5.0;   // seconds of broadcasting
+        bool                Binary        = true;
+        size_t              ClientThreads = 2;
+        uint16_t            Port          = 18631;
+        bool                Json          = false; // output format
+        double              UplinkHz      = 0.0;   // per student, 0 = none
+        size_t              Noisy         = 0;     // students flooding instead
+        size_t              SceneModels   = 0;     // 0 = no replicated scene
+        double              SceneHz       = 0.0;   // SceneDelta broadcasts per second
+        std::vector<bool>   Compress      = { true };
+    };
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: AtometaSessionBench [--clients 50,200,1000] [--io-threads 1,2,4]\n"
+                     "                           [--rate 60] [--duration 5] [--format binary|json]\n"
+                     "                           [--client-threads 2] [--port 18631] [--output csv|json]\n"
+                     "                           [--uplink-rate 0] [--noisy 0]\n"
+                     "                           [--scene 0] [--scene-rate 0] [--compress on|off|both]\n";
+    }
+
+    std::vector<size_t> ParseList(const char* text)
+    {
+        std::vector<size_t> values;
+        std::istringstream iss(text);
+        std::string token;
+        while (std::getline(iss, token, ','))
+            if (auto v = std::strtoul(token.c_str(), nullptr, 10); v > 0)
+                values.push_back(v);
+        return values;
+    }
+
+    std::vector<bool> ParseCompress(const char* text)
+    {
+        if (!std::strcmp(text, "both")) return { false, true };
+        return { std::strcmp(text, "off") != 0 };
+    }
+
+    bool ParseArgs(int argc, char** argv, BenchOptions& opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg  = argv[i];
+            const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (!std::strcmp(arg, "--help") || !std::strcmp(arg, "-h"))
+                return false;
+            if (!next) {
+                std::cerr << "Missing value for " << arg << '\n';
+                return false;
+            }
+
+            if      (!std::strcmp(arg, "--clients"))        opts.Clients       = ParseList(next);
+            else if (!std::strcmp(arg, "--io-threads"))     opts.IOThreads     = ParseList(next);
+            else if (!std::strcmp(arg, "--rate"))           opts.RateHz        = std::atof(next);
+            else if (!std::strcmp(arg, "--duration"))       opts.Duration      = std::atof(next);
+            else if (!std::strcmp(arg, "--format"))         opts.Binary        = std::strcmp(next, "json") != 0;
+            else if (!std::strcmp(arg, "--client-threads")) opts.ClientThreads = std::max(1, std::atoi(next));
+            else if (!std::strcmp(arg, "--port"))           opts.Port          = static_cast<uint16_t>(std::atoi(next));
+            else if (!std::strcmp(arg, "--output"))         opts.Json          = !std::strcmp(next, "json");
+            else if (!std::strcmp(arg, "--uplink-rate"))    opts.UplinkHz      = std::atof(next);
+            else if (!std::strcmp(arg, "--noisy"))          opts.Noisy         = std::strtoul(next, nullptr, 10);
+            else if (!std::strcmp(arg, "--scene"))          opts.SceneModels   = std::strtoul(next, nullptr, 10);
+            else if (!std::strcmp(arg, "--scene-rate"))     opts.SceneHz       = std::atof(next);
+            else if (!std::strcmp(arg, "--compress"))       opts.Compress      = ParseCompress(next);
+            else {
+                std::cerr << "Unknown option " << arg << '\n';
+                return false;
+            }
+            ++i;
+        }
+        return !opts.Clients.empty() && !opts.IOThreads.empty()
+            && opts.RateHz > 0.0 && opts.Duration > 0.0 && opts.SceneModels <= UINT16_MAX;
+    }
+
+    // ── CPU time ──────────────────────────────────────────────────────────
+    // Host CPU = process CPU minus the CPU the synthetic students burned on
+    // their own threads. Not available on Windows (reported as -1).
+
+    double ProcessCpuSeconds()
+    {
+#if defined(ATOMETA_PLATFORM_LINUX) || defined(ATOMETA_PLATFORM_MACOS)
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        auto tv = [](const timeval& t) { return t.tv_sec + t.tv_usec / 1e6; };
+        return tv(usage.ru_utime) + tv(usage.ru_stime);
+#else
+        return -1.0;
+#endif
+    }
+
+    double ThreadCpuSeconds(std::thread& thread)
+    {
+#if defined(ATOMETA_PLATFORM_LINUX)
+        clockid_t id;
+        timespec  ts{};
+        if (pthread_getcpuclockid(thread.native_handle(), &id) == 0
+            && clock_gettime(id, &ts) == 0)
+            return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+        (void)thread;
+#endif
+        return 0.0;
+    }
+
+    void RaiseFileLimit()
+    {
+        // Every student costs two sockets on loopback
+#if defined(ATOMETA_PLATFORM_LINUX) || defined(ATOMETA_PLATFORM_MACOS)
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+#endif
+    }
+
+    // ── Synthetic students ────────────────────────────────────────────────
+
+    // Send time of every frame, indexed by sequence number
+    struct SendTimes {
+        explicit SendTimes(size_t frames) : Times(frames) {}
+
+        void   Stamp(size_t seq)     { Times[seq].store(Now(), std::memory_order_release); }
+        int64_t Get(size_t seq) const
+        {
+            return seq < Times.size() ? Times[seq].load(std::memory_order_acquire) : 0;
+        }
+
+        static int64_t Now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       Clock::now().time_since_epoch()).count();
+        }
+
+        std::vector<std::atomic<int64_t>> Times;
+    };
+
+    // Per client thread, so recording needs no locks
+    struct ShardStats {
+        std::vector<uint32_t> LatencyUs;
+        std::vector<uint32_t> JoinUs;
+        uint64_t              Received  = 0;
+        uint64_t              QuietSent = 0;   // uplink messages written by quiet students
+        std::atomic<size_t>   Connected = 0;
+    };
+
+    // What the host's OnMessage saw of the students' uplink traffic; it
+    // runs on one io thread, the lock only guards the final read
+    struct UplinkLog {
+        explicit UplinkLog(size_t clients) : Delivered(clients) {}
+
+        void Record(const Atometa::NetMessage& msg, size_t noisy)
+        {
+            if (msg.Type != Atometa::NetMsgType::ChatMessage) return;
+            size_t  client = msg.Data.value("c", SIZE_MAX);
+            int64_t sent   = msg.Data.value("t", int64_t(0));
+            if (client >= Delivered.size()) return;
+
+            std::lock_guard<std::mutex> lock(Mutex);
+            ++Delivered[client];
+            if (client >= noisy)
+                LatencyUs.push_back(static_cast<uint32_t>((SendTimes::Now() - sent) / 1000));
+        }
+
+        std::mutex            Mutex;
+        std::vector<uint64_t> Delivered;   // per student
+        std::vector<uint32_t> LatencyUs;   // quiet students only
+    };
+
+    struct BenchClient : std::enable_shared_from_this<BenchClient> {
+        ws::stream<tcp::socket> Socket;
+        beast::flat_buffer      Buffer;
+        ShardStats&             Stats;
+        const SendTimes&        Times;
+        bool                    Binary;
+        bool                    Compress  = false;   // ask for Compressed frames
+        int64_t                 StartedAt = 0;
+        bool                    Joined    = false;
+
+        // Uplink: Index names the student to the host; Active is raised
+        // while the camera broadcast runs
+        size_t                    Index    = 0;
+        double                    UplinkHz = 0.0;
+        bool                      Noisy    = false;
+        const std::atomic<bool>*  Active   = nullptr;
+        std::unique_ptr<asio::steady_timer> UplinkTimer;
+        std::string               Outgoing;
+        bool                      Writing  = false;
+
+        BenchClient(asio::io_context& ctx, ShardStats& stats,
+                    const SendTimes& times, bool binary)
+            : Socket(ctx), Stats(stats), Times(times), Binary(binary) {}
+
+        void Start(const tcp::endpoint& endpoint)
+        {
+            StartedAt = SendTimes::Now();
+            Socket.next_layer().async_connect(endpoint,
+                [self = shared_from_this()](beast::error_code ec) {
+                    if (ec) return; // reported as not connected
+                    self->Handshake();
+                });
+        }
+
+        void Handshake()
+        {
+            Socket.set_option(ws::stream_base::decorator(
+                [binary = Binary, compress = Compress](ws::request_type& req) {
+                    req.set(http::field::sec_websocket_protocol,
+                            binary ? Atometa::kBinarySubprotocol
+                                   : Atometa::kJsonSubprotocol);
+                    if (compress)
+                        req.set(Atometa::kCompressHeader, Atometa::kCompressDeflate);
+                }));
+            Socket.async_handshake("127.0.0.1", "/",
+                [self = shared_from_this()](beast::error_code ec) {
+                    if (ec) return; // reported as not connected
+                    ++self->Stats.Connected;
+                    self->Socket.binary(self->Binary);
+                    self->Read();
+                    if (self->UplinkHz > 0.0 || self->Noisy)
+                        self->ScheduleUplink();
+                });
+        }
+
+        // Quiet students send at UplinkHz; noisy ones poll for the start
+        // and then write back to back
+        void ScheduleUplink()
+        {
+            if (!UplinkTimer)
+                UplinkTimer = std::make_unique<asio::steady_timer>(Socket.get_executor());
+
+            auto period = Noisy ? std::chrono::duration<double>(0.01)
+                                : std::chrono::duration<double>(1.0 / UplinkHz);
+            UplinkTimer->expires_after(std::chrono::duration_cast<Clock::duration>(period));
+            UplinkTimer->async_wait([self = shared_from_this()](beast::error_code ec) {
+                if (ec) return;
+                if (self->Active->load() && !self->Writing)
+                    self->WriteUplink();
+                self->ScheduleUplink();
+            });
+        }
+
+        void WriteUplink()
+        {
+            Atometa::NetMessage msg;
+            msg.Type = Atometa::NetMsgType::ChatMessage;
+            msg.Data = { { "c", Index }, { "t", SendTimes::Now() } };
+            Outgoing = msg.Serialize(Binary ? Atometa::WireFormat::Binary
+                                            : Atometa::WireFormat::Json);
+
+            Writing = true;
+            Socket.async_write(asio::buffer(Outgoing),
+                [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                    self->Writing = false;
+                    if (ec) return;
+                    if (!self->Noisy)
+                        ++self->Stats.QuietSent;
+                    else if (self->Active->load())
+                        self->WriteUplink();
+                });
+        }
+
+        void Read()
+        {
+            Socket.async_read(Buffer,
+                [self = shared_from_this()](beast::error_code ec, std::size_t) {
+                    if (ec) return self->Close();
+                    self->OnFrame();
+                    self->Read();
+                });
+        }
+
+        void OnFrame()
+        {
+            int64_t received = SendTimes::Now();
+            Atometa::NetMessage msg;
+            bool ok = Atometa::NetMessage::Deserialize(beast::buffers_to_string(Buffer.data()), msg);
+            Buffer.consume(Buffer.size());
+            if (!ok || msg.Type != Atometa::NetMsgType::CameraSync)
+                return;
+
+            if (!Joined) {
+                Joined = true;
+                Stats.JoinUs.push_back(static_cast<uint32_t>((received - StartedAt) / 1000));
+            }
+
+            int64_t sent = Times.Get(static_cast<size_t>(msg.Camera.Yaw));
+            if (sent == 0) return;
+            ++Stats.Received;
+            Stats.LatencyUs.push_back(static_cast<uint32_t>((received - sent) / 1000));
+        }
+
+        void Close()
+        {
+            --Stats.Connected;
+            if (UplinkTimer) UplinkTimer->cancel();
+        }
+    };
+
+    // ── One run ───────────────────────────────────────────────────────────
+
+    struct BenchResult {
+        size_t   Clients       = 0;
+        size_t   IOThreads     = 0;
+        bool     Compress      = false;
+        size_t   Connected     = 0;
+        uint64_t FramesSent    = 0;
+        uint64_t Expected      = 0;
+        uint64_t Received      = 0;
+        uint64_t Dropped       = 0;
+        uint64_t DroppedClients = 0;
+        double   P50Ms = 0, P90Ms = 0, P99Ms = 0, MaxMs = 0;
+        double   JoinP50Ms = 0, JoinP99Ms = 0, JoinMaxMs = 0;
+        double   HostCpuPercent = -1.0;   // of one core
+        double   HostCpuMsPerStudent = -1.0;   // host CPU ms per second, per student
+        double   BytesPerSec   = 0;
+        double   DeflateInPerSec  = 0;    // bytes of frames compressed, before
+        double   DeflateOutPerSec = 0;    // and after
+        double   UplinkPerSec  = 0;       // delivered to OnMessage, all students
+        double   NoisyPerSec   = 0;       // per noisy student
+        double   QuietDeliveredPct = 0;
+        double   QuietP99Ms    = 0;
+        double   QuietFairness = 0;       // Jain's index over quiet students
+        uint64_t UplinkThrottled = 0;
+    };
+
+    double Percentile(std::vector<uint32_t>& v, double p)
+    {
+        if (v.empty()) return 0.0;
+        size_t k = std::min(v.size() - 1, static_cast<size_t>(p * (v.size() - 1) + 0.5));
+        std::nth_element(v.begin(), v.begin() + k, v.end());
+        return v[k] / 1000.0;
+    }
+
+    // Models spread over a classroom scene, with names like an imported
+    // anatomy set; t moves them
+    Atometa::NetNode SceneModel(size_t i, float t)
+    {
+        Atometa::NetNode node;
+        node.Position = { std::sin(i * 0.7f) * 4.f + t, 0.25f * i, std::cos(i * 0.3f) };
+        node.Rotation = { 0.f, std::fmod(i * 37.f + t * 90.f, 360.f), 0.f };
+        node.Scale    = 1.f + (i % 5) * 0.1f;
+        node.Name     = "Anatomy/Thorax/Structure_" + std::to_string(i);
+        return node;
+    }
+
+    BenchResult RunOnce(const BenchOptions& opts, size_t clients, size_t ioThreads, bool compress)
+    {
+        BenchResult result;
+        result.Clients   = clients;
+        result.IOThreads = ioThreads;
+        result.Compress  = compress;
+
+        size_t frames = static_cast<size_t>(opts.RateHz * opts.Duration);
+        SendTimes times(frames);
+
+        std::atomic<bool> uplinkActive = false;
+        size_t            noisy        = std::min(opts.Noisy, clients);
+        UplinkLog         uplink(clients);
+
+        Atometa::NetworkLayer host;
+        host.SetIOThreadCount(ioThreads);
+        host.SetCompression(compress);
+        host.SetOnMessage([&uplink, noisy](const Atometa::NetMessage& m) {
+            uplink.Record(m, noisy);
+        });
+        if (!host.StartHost(opts.Port)) {
+            std::cerr << "Could not listen on port " << opts.Port << '\n';
+            return result;
+        }
+
+        // Camera state for the join snapshot; its Yaw is past the last
+        // sequence number, so it never counts as a broadcast frame
+        Atometa::NetMessage msg;
+        msg.Type       = Atometa::NetMsgType::CameraSync;
+        msg.Camera.Yaw = static_cast<float>(frames);
+        host.Send(msg);
+
+        // The scene's first delta carries everything: it is what joiners
+        // get as their snapshot
+        Atometa::SceneReplicator scene;
+        Atometa::NetMessage      delta;
+        scene.SetNodeCount(opts.SceneModels);
+        for (size_t i = 0; i < opts.SceneModels; ++i)
+            scene.SetNode(i, SceneModel(i, 0.f));
+        if (scene.BuildDelta(delta))
+            host.Send(delta);
+        size_t sceneEvery = opts.SceneModels && opts.SceneHz > 0.0
+                          ? std::max<size_t>(1, static_cast<size_t>(opts.RateHz / opts.SceneHz + 0.5))
+                          : 0;
+
+        // Synthetic students on their own contexts and threads
+        std::vector<std::unique_ptr<asio::io_context>> contexts;
+        std::vector<std::unique_ptr<ShardStats>>       shards;
+        std::vector<std::thread>                       threads;
+        for (size_t i = 0; i < opts.ClientThreads; ++i) {
+            contexts.push_back(std::make_unique<asio::io_context>(1));
+            shards.push_back(std::make_unique<ShardStats>());
+            shards.back()->LatencyUs.reserve(frames * (clients / opts.ClientThreads + 1));
+        }
+
+        tcp::endpoint endpoint(asio::ip::make_address("127.0.0.1"), opts.Port);
+        for (size_t i = 0; i < clients; ++i) {
+            size_t shard  = i % contexts.size();
+            auto   client = std::make_shared<BenchClient>(*contexts[shard], *shards[shard],
+                                                          times, opts.Binary);
+            client->Index    = i;
+            client->Compress = compress;
+            client->UplinkHz = opts.UplinkHz;
+            client->Noisy    = i < noisy;
+            client->Active   = &uplinkActive;
+            client->Start(endpoint);
+        }
+        for (auto& ctx : contexts)
+            threads.emplace_back([ctx = ctx.get()] { ctx->run(); });
+
+        auto connected = [&] {
+            size_t n = 0;
+            for (auto& s : shards) n += s->Connected.load();
+            return n;
+        };
+        auto deadline = Clock::now() + std::chrono::seconds(30);
+        while (Clock::now() < deadline
+               && (connected() < clients || host.GetClientCount() < clients))
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        result.Connected = connected();
+
+        // ── Broadcast at the requested rate ──
+        double   cpuBefore = ProcessCpuSeconds();
+        double   clientCpuBefore = 0.0;
+        for (auto& t : threads) clientCpuBefore += ThreadCpuSeconds(t);
+        auto     statsBefore = host.GetStats();
+        auto     start = Clock::now();
+        auto     period = std::chrono::duration_cast<Clock::duration>(
+                              std::chrono::duration<double>(1.0 / opts.RateHz));
+
+        uplinkActive = true;
+        for (size_t seq = 0; seq < frames; ++seq) {
+            std::this_thread::sleep_until(start + period * static_cast<long>(seq));
+            msg.Camera.Yaw   = static_cast<float>(seq);
+            msg.Camera.Pitch = 15.f;
+            times.Stamp(seq);
+            host.Send(msg);
+
+            if (sceneEvery && seq % sceneEvery == 0) {
+                size_t moved = std::max<size_t>(1, opts.SceneModels / 10);
+                for (size_t k = 0; k < moved; ++k) {
+                    size_t i = (seq / sceneEvery * moved + k) % opts.SceneModels;
+                    scene.SetNode(i, SceneModel(i, seq * 0.01f));
+                }
+                if (scene.BuildDelta(delta))
+                    host.Send(delta);
+            }
+        }
+        uplinkActive = false;
+
+        // Let the last frames arrive before measuring
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        auto   statsAfter = host.GetStats();
+
+        double clientCpuAfter = 0.0;
+        for (auto& t : threads) clientCpuAfter += ThreadCpuSeconds(t);
+        double cpuAfter = ProcessCpuSeconds();
+        if (cpuBefore >= 0.0) {
+            double hostCpu = (cpuAfter - cpuBefore) - (clientCpuAfter - clientCpuBefore);
+            result.HostCpuPercent = 100.0 * std::max(0.0, hostCpu) / elapsed;
+            if (result.Connected)
+                result.HostCpuMsPerStudent = 1000.0 * std::max(0.0, hostCpu) / elapsed
+                                           / result.Connected;
+        }
+
+        host.StopHost();
+        for (auto& ctx : contexts) ctx->stop();
+        for (auto& t : threads) t.join();
+
+        std::vector<uint32_t> latencies, joins;
+        for (auto& s : shards) {
+            result.Received += s->Received;
+            latencies.insert(latencies.end(), s->LatencyUs.begin(), s->LatencyUs.end());
+            joins.insert(joins.end(), s->JoinUs.begin(), s->JoinUs.end());
+        }
+
+        result.FramesSent     = frames;
+        result.Expected       = frames * result.Connected;
+        result.Dropped        = result.Expected > result.Received
+                              ? result.Expected - result.Received : 0;
+        result.DroppedClients = statsAfter.DroppedClients - statsBefore.DroppedClients;
+        result.BytesPerSec    = (statsAfter.BytesSent - statsBefore.BytesSent) / elapsed;
+        result.DeflateInPerSec  = (statsAfter.CompressedIn - statsBefore.CompressedIn) / elapsed;
+        result.DeflateOutPerSec = (statsAfter.CompressedOut - statsBefore.CompressedOut) / elapsed;
+        result.P50Ms          = Percentile(latencies, 0.50);
+        result.P90Ms          = Percentile(latencies, 0.90);
+        result.P99Ms          = Percentile(latencies, 0.99);
+        result.MaxMs          = latencies.empty() ? 0.0
+                              : *std::max_element(latencies.begin(), latencies.end()) / 1000.0;
+        result.JoinP50Ms      = Percentile(joins, 0.50);
+        result.JoinP99Ms      = Percentile(joins, 0.99);
+        result.JoinMaxMs      = joins.empty() ? 0.0
+                              : *std::max_element(joins.begin(), joins.end()) / 1000.0;
+
+        // ── Uplink ──
+        std::lock_guard<std::mutex> lock(uplink.Mutex);
+        uint64_t quietSent = 0, quietGot = 0, noisyGot = 0;
+        double   sum = 0.0, squares = 0.0;
+        for (auto& s : shards) quietSent += s->QuietSent;
+        for (size_t i = 0; i < clients; ++i) {
+            double got = static_cast<double>(uplink.Delivered[i]);
+            if (i < noisy) {
+                noisyGot += uplink.Delivered[i];
+                continue;
+            }
+            quietGot += uplink.Delivered[i];
+            sum      += got;
+            squares  += got * got;
+        }
+        result.UplinkPerSec      = (quietGot + noisyGot) / elapsed;
+        result.NoisyPerSec       = noisy ? noisyGot / elapsed / noisy : 0.0;
+        result.QuietDeliveredPct = quietSent ? 100.0 * quietGot / quietSent : 0.0;
+        result.QuietP99Ms        = Percentile(uplink.LatencyUs, 0.99);
+        result.QuietFairness     = squares > 0.0 ? sum * sum / ((clients - noisy) * squares) : 0.0;
+        result.UplinkThrottled   = statsAfter.StudentMessages.Throttled
+                                 - statsBefore.StudentMessages.Throttled;
+        return result;
+    }
+
+    // ── Output ────────────────────────────────────────────────────────────
+
+    void PrintCsvHeader()
+    {
+        std::cout << "clients,io_threads,connected,frames_sent,expected,received,dropped,"
+                     "dropped_clients,p50_ms,p90_ms,p99_ms,max_ms,join_p50_ms,join_p99_ms,join_max_ms,"
+                     "host_cpu_pct,bytes_per_sec,uplink_per_sec,noisy_per_sec,quiet_delivered_pct,"
+                     "quiet_p99_ms,quiet_fairness,uplink_throttled,compress,host_cpu_ms_per_student,"
+                     "deflate_in_per_sec,deflate_out_per_sec\n";
+    }
+
+    void PrintCsv(const BenchResult& r)
+    {
+        std::cout << r.Clients << ',' << r.IOThreads << ',' << r.Connected << ','
+                  << r.FramesSent << ',' << r.Expected << ',' << r.Received << ','
+                  << r.Dropped << ',' << r.DroppedClients << ','
+                  << r.P50Ms << ',' << r.P90Ms << ',' << r.P99Ms << ',' << r.MaxMs << ','
+                  << r.JoinP50Ms << ',' << r.JoinP99Ms << ',' << r.JoinMaxMs << ','
+                  << r.HostCpuPercent << ',' << static_cast<uint64_t>(r.BytesPerSec) << ','
+                  << r.UplinkPerSec << ',' << r.NoisyPerSec << ',' << r.QuietDeliveredPct << ','
+                  << r.QuietP99Ms << ',' << r.QuietFairness << ',' << r.UplinkThrottled << ','
+                  << (r.Compress ? 1 : 0) << ',' << r.HostCpuMsPerStudent << ','
+                  << static_cast<uint64_t>(r.DeflateInPerSec) << ','
+                  << static_cast<uint64_t>(r.DeflateOutPerSec) << std::endl;
+    }
+
+    json ToJson(const BenchResult& r)
+    {
+        return {
+            { "clients",         r.Clients },
+            { "io_threads",      r.IOThreads },
+            { "connected",       r.Connected },
+            { "frames_sent",     r.FramesSent },
+            { "expected",        r.Expected },
+            { "received",        r.Received },
+            { "dropped",         r.Dropped },
+            { "dropped_clients", r.DroppedClients },
+            { "latency_ms",      { { "p50", r.P50Ms }, { "p90", r.P90Ms },
+                                   { "p99", r.P99Ms }, { "max", r.MaxMs } } },
+            { "join_ms",         { { "p50", r.JoinP50Ms }, { "p99", r.JoinP99Ms },
+                                   { "max", r.JoinMaxMs } } },
+            { "host_cpu_pct",    r.HostCpuPercent },
+            { "host_cpu_ms_per_student", r.HostCpuMsPerStudent },
+            { "bytes_per_sec",   r.BytesPerSec },
+            { "compress",        { { "on", r.Compress }, { "in_per_sec", r.DeflateInPerSec },
+                                   { "out_per_sec", r.DeflateOutPerSec } } },
+            { "uplink",          { { "per_sec", r.UplinkPerSec }, { "noisy_per_sec", r.NoisyPerSec },
+                                   { "quiet_delivered_pct", r.QuietDeliveredPct },
+                                   { "quiet_p99_ms", r.QuietP99Ms },
+                                   { "quiet_fairness", r.QuietFairness },
+                                   { "throttled", r.UplinkThrottled } } },
+        };
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    BenchOptions opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        PrintUsage();
+        return 1;
+    }
+
+    // No Logger::Init(): stdout carries only the CSV / JSON report
+    RaiseFileLimit();
+    std::cout << std::fixed << std::setprecision(3);
+
+    json runs = json::array();
+    if (!opts.Json) PrintCsvHeader();
+
+    for (size_t clients : opts.Clients) {
+        for (size_t ioThreads : opts.IOThreads) {
+            for (bool compress : opts.Compress) {
+                BenchResult result = RunOnce(opts, clients, ioThreads, compress);
+                if (opts.Json) runs.push_back(ToJson(result));
+                else           PrintCsv(result);
+            }
+        }
+    }
+
+    if (opts.Json) {
+        json report = {
+            { "rate_hz",  opts.RateHz },
+            { "duration", opts.Duration },
+            { "format",   opts.Binary ? "binary" : "json" },
+            { "uplink_hz", opts.UplinkHz },
+            { "noisy",    opts.Noisy },
+            { "scene",    opts.SceneModels },
+            { "scene_hz", opts.SceneHz },
+            { "runs",     runs },
+        };
+        std::cout << report.dump(2) << std::endl;
+    }
+
+    return 0;
+}
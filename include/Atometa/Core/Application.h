@@ -3,6 +3,8 @@
 #include "Core.h"
 #include "Window.h"
 
+#include <glm/glm.hpp>
+
 namespace Atometa {
 
     class ImGuiLayer;
@@ -10,6 +12,17 @@ namespace Atometa {
     class Shader;
     class Camera;
     class NetworkLayer;
+    class CameraSyncPolicy;
+    class InboundQueue;
+    class CameraJitterBuffer;
+    class PointerStream;
+    class PointerTrack;
+    class Mesh;
+    class SceneReplicator;
+    class SceneMirror;
+    class SessionRecorder;
+    class SessionPlayer;
+    struct NetMessage;
 
     class Application {
     public:
@@ -28,6 +41,18 @@ namespace Atometa {
         void RenderUI(float& cameraSensitivity);
         void RenderSessionWindow();
         void BroadcastCamera();
+        void BroadcastPointer();
+        void RenderPointer();
+        void ProcessNetworkMessages();
+        void ShareSceneAssets();
+        void LoadStreamedAssets(const NetMessage& manifest);
+        void ReplicateScene();
+        void ApplyReplicatedScene();
+        void RenderRecordingControls();
+        void StartRecording();
+        void StopRecording();
+        void PlayRecording(float deltaTime);
+        bool ApplyRecordedMessage(const NetMessage& msg);
 
     private:
         Scope<Window>       m_Window;
@@ -35,7 +60,18 @@ namespace Atometa {
         Scope<Scene>        m_Scene;
         Scope<Shader>       m_Shader;
         Scope<Camera>       m_Camera;
+        // Declared before m_Network so it outlives the io threads pushing to it
+        Scope<InboundQueue> m_Inbound;
         Scope<NetworkLayer> m_Network;
+        Scope<CameraSyncPolicy> m_CameraSync;
+        Scope<CameraJitterBuffer> m_CameraJitter;
+        Scope<PointerStream>      m_PointerStream;
+        Scope<PointerTrack>       m_PointerTrack;
+        Scope<Mesh>               m_PointerMesh;
+        Scope<SceneReplicator>    m_SceneReplicator;
+        Scope<SceneMirror>        m_SceneMirror;
+        Ref<SessionRecorder>      m_Recorder;
+        Scope<SessionPlayer>      m_Player;
 
         bool  m_Running         = true;
         bool  m_ShowSession     = true;
@@ -44,6 +80,9 @@ namespace Atometa {
         bool  m_ShowProperties  = true;
         int   m_SelectedModel   = -1;
         float m_LastFrameTime   = 0.0f;
+        double m_LastSceneSync  = 0.0;
+        bool      m_PointerVisible  = false;            // host: L held; student: shown
+        glm::vec3 m_PointerPosition = glm::vec3(0.0f);
 
         static Application* s_Instance;
     };
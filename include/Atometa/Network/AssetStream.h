@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Atometa {
+
+    // Hex SHA-1 of a byte range: the address of a chunk or a whole file
+    std::string ContentHash(const void* data, size_t size);
+
+    // True for a 40-digit lowercase hex string (safe to use as a file name)
+    bool IsContentHash(const std::string& hash);
+
+    // ── AssetInfo ─────────────────────────────────────────────────────────
+    // One file the host offers, as listed in an AssetManifest. Chunks are
+    // addressed by content, so a student keeps any chunk it has already
+    // seen, whichever lecture or file it came from.
+    // ─────────────────────────────────────────────────────────────────────
+    struct AssetInfo {
+        std::string              Name;            // display name in the scene
+        std::string              FileName;        // keeps the extension for the loader
+        std::string              Hash;            // whole file
+        uint64_t                 Size      = 0;
+        uint32_t                 ChunkSize = 0;
+        std::vector<std::string> Chunks;          // hashes, in file order
+
+        json ToJson() const;
+        static bool FromJson(const json& j, AssetInfo& out);
+    };
+
+    // ── AssetStore (host) ─────────────────────────────────────────────────
+    // Indexes files into fixed-size chunks. Chunk bytes are read back from
+    // the original file on demand, so serving a 200 MB model keeps one
+    // chunk in memory per student. Build it once, then share it read-only.
+    // ─────────────────────────────────────────────────────────────────────
+    class AssetStore {
+    public:
+        static constexpr uint32_t kDefaultChunkSize = 64 * 1024;
+
+        explicit AssetStore(uint32_t chunkSize = kDefaultChunkSize);
+
+        // Hashes the file chunk by chunk. Returns false if it can't be read.
+        bool AddFile(const std::string& path, const std::string& name = "");
+
+        const std::vector<AssetInfo>& GetAssets() const { return m_Assets; }
+        size_t   GetChunkCount() const { return m_Chunks.size(); }
+        uint32_t GetChunkSize()  const { return m_ChunkSize; }
+
+        bool HasChunk(const std::string& hash) const;
+        bool ReadChunk(const std::string& hash, std::string& out) const;
+
+        // AssetManifest listing every file, Data = { "assets": [...] }
+        NetMessage MakeManifest() const;
+
+    private:
+        struct ChunkLocation {
+            std::string Path;
+            uint64_t    Offset = 0;
+            uint32_t    Size   = 0;
+        };
+
+        uint32_t                                       m_ChunkSize;
+        std::vector<AssetInfo>                         m_Assets;
+        std::unordered_map<std::string, ChunkLocation> m_Chunks;
+    };
+
+    // ── AssetCache (student) ──────────────────────────────────────────────
+    // Content-addressed disk cache that outlives the session:
+    //   <root>/chunks/<hash>               one file per chunk
+    //   <root>/files/<hash>/<FileName>     assembled, verified assets
+    // ─────────────────────────────────────────────────────────────────────
+    class AssetCache {
+    public:
+        explicit AssetCache(std::string root = "cache/assets");
+
+        void               SetRoot(const std::string& root) { m_Root = root; }
+        const std::string& GetRoot() const                  { return m_Root; }
+
+        bool HasChunk(const std::string& hash) const;
+
+        // Stores the chunk only if its bytes match the hash
+        bool PutChunk(const std::string& hash, const std::string& data);
+
+        // Chunks of the asset that still have to be fetched (none once the
+        // asset has been assembled before)
+        std::vector<std::string> MissingChunks(const AssetInfo& asset) const;
+
+        // Joins the cached chunks into the asset file and checks its hash.
+        // Returns the file path, or "" if chunks are missing or corrupt.
+        std::string Assemble(const AssetInfo& asset) const;
+
+    private:
+        std::string ChunkPath(const std::string& hash) const;
+        std::string FilePath(const AssetInfo& asset) const;
+
+    private:
+        std::string m_Root;
+    };
+
+} // namespace Atometa
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+
+#include <cstdint>
+#include <deque>
+
+namespace Atometa {
+
+    struct CameraJitterSettings {
+        float  MinDelay         = 0.05f;  // playout delay bounds (s)
+        float  MaxDelay         = 0.25f;
+        float  MaxExtrapolation = 0.10f;  // how far past the newest sample to predict (s)
+        size_t Capacity         = 32;     // samples kept ahead of the playout point
+    };
+
+    struct CameraJitterStats {
+        uint64_t Received     = 0;
+        uint64_t Lost         = 0;   // sequence gaps
+        uint64_t Late         = 0;   // duplicates / arrived after a newer sample
+        uint64_t Interpolated = 0;   // Sample() calls between two samples
+        uint64_t Extrapolated = 0;   // Sample() calls past the newest sample
+        float    Delay        = 0.f; // current playout delay (s)
+        float    Jitter       = 0.f; // interarrival jitter estimate (s)
+    };
+
+    // ── CameraJitterBuffer ────────────────────────────────────────────────
+    // Student side of a stamped CameraSync stream. Samples are played out
+    // a short, adaptive delay behind the host clock and interpolated, so
+    // bunched or 20–30 Hz updates still render as smooth motion. When the
+    // stream runs dry the last velocity is extrapolated for at most
+    // MaxExtrapolation, after which the newest received pose is held.
+    // The delay tracks the measured send interval plus a few times the
+    // RFC 3550 interarrival jitter.
+    // Usage (render thread):
+    //   on message: buffer.Push(msg.Sequence, msg.Timestamp * 1e-6, now, msg.Camera);
+    //   per frame:  if (buffer.Sample(now, cam)) camera.SetFromNetwork(...);
+    // ─────────────────────────────────────────────────────────────────────
+    class CameraJitterBuffer {
+    public:
+        explicit CameraJitterBuffer(const CameraJitterSettings& settings = {});
+
+        // hostTime: sender clock (s); localTime: receiver clock at arrival (s)
+        void Push(uint32_t sequence, double hostTime, double localTime,
+                  const NetCamera& camera);
+
+        // Camera to show at localTime. Returns false when there is nothing
+        // new to apply (no samples yet, or holding a pose already returned),
+        // which leaves the student free to orbit while the host is idle.
+        bool Sample(double localTime, NetCamera& out);
+
+        void Reset();
+        bool Empty() const { return m_Samples.empty(); }
+
+        CameraJitterSettings&       GetSettings()       { return m_Settings; }
+        const CameraJitterSettings& GetSettings() const { return m_Settings; }
+        const CameraJitterStats&    GetStats()    const { return m_Stats; }
+
+    private:
+        struct Entry {
+            uint32_t  Sequence = 0;
+            double    HostTime = 0.0;
+            NetCamera Camera;
+        };
+
+        float PlayoutDelay() const;
+        bool  Emit(const NetCamera& camera, NetCamera& out);
+
+    private:
+        CameraJitterSettings m_Settings;
+        CameraJitterStats    m_Stats;
+
+        std::deque<Entry> m_Samples;    // ascending HostTime
+        Entry             m_Previous;   // last sample dropped behind the playout point
+        bool              m_HasPrevious = false;
+
+        // Clock / timing estimates
+        double   m_Offset      = 0.0;   // min(localTime - hostTime): one-way baseline
+        double   m_LastTransit = 0.0;
+        double   m_Interval    = 0.0;   // smoothed host send interval
+        uint32_t m_LastSeq     = 0;
+        double   m_LastHost    = 0.0;
+
+        NetCamera m_LastOut;
+        bool      m_HasOut = false;
+    };
+
+} // namespace Atometa
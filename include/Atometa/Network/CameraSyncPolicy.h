@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+
+#include <cstdint>
+
+namespace Atometa {
+
+    struct CameraSyncSettings {
+        float AngleStep        = 0.01f;  // yaw/pitch quantization (degrees)
+        float DistanceStep     = 0.001f; // distance quantization (world units)
+        float Epsilon          = 0.005f; // min change of any field to count as motion
+        float MaxRateHz        = 30.0f;  // send-rate cap; 0 = every frame
+        float KeyframeInterval = 1.0f;   // resend unchanged state this often (s)
+    };
+
+    struct CameraSyncStats {
+        uint64_t FramesOffered = 0;   // frames BroadcastCamera ran on
+        uint64_t MessagesSent  = 0;   // including keyframes
+        uint64_t KeyframesSent = 0;   // sent only because the interval elapsed
+        uint64_t Suppressed    = 0;   // frames that produced no message
+        uint64_t BytesSent     = 0;   // bytes queued for all recipients
+
+        // Bytes a per-frame sender would have queued on top of BytesSent,
+        // estimated from the average message cost so far
+        uint64_t BytesSaved() const
+        {
+            return MessagesSent ? Suppressed * BytesSent / MessagesSent : 0;
+        }
+    };
+
+    // ── CameraSyncPolicy ──────────────────────────────────────────────────
+    // Decides, once per frame, whether the host's camera is worth sending.
+    // State is quantized first so sub-step jitter never counts as motion,
+    // changes are rate-limited to MaxRateHz, and the last state is repeated
+    // every KeyframeInterval so students recover from a dropped update.
+    // Usage:
+    //   NetCamera q;
+    //   if (policy.Update(now, camera, q))
+    //       policy.RecordSent(network.Send(MakeCameraSync(q)));
+    // ─────────────────────────────────────────────────────────────────────
+    class CameraSyncPolicy {
+    public:
+        explicit CameraSyncPolicy(const CameraSyncSettings& settings = {});
+
+        // now: monotonic seconds. Returns true if out (quantized) should be sent.
+        bool Update(double now, const NetCamera& camera, NetCamera& out);
+
+        // Report how many bytes the accepted update cost on the wire
+        void RecordSent(size_t bytes) { m_Stats.BytesSent += bytes; }
+
+        // Forget the last sent state so the next Update always sends
+        // (e.g. when a new session starts)
+        void Reset();
+
+        CameraSyncSettings&       GetSettings()       { return m_Settings; }
+        const CameraSyncSettings& GetSettings() const { return m_Settings; }
+        const CameraSyncStats&    GetStats()    const { return m_Stats; }
+
+    private:
+        NetCamera Quantize(const NetCamera& camera) const;
+        bool      HasMoved(const NetCamera& camera) const;
+
+    private:
+        CameraSyncSettings m_Settings;
+        CameraSyncStats    m_Stats;
+
+        NetCamera m_LastSent;
+        double    m_LastSendTime = 0.0;
+        bool      m_HasSent      = false;
+    };
+
+} // namespace Atometa
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Atometa {
+
+    // ── Frame compression ────────────────────────────────────────────────
+    // Scene snapshots, deltas and asset chunks sent to a student that asks
+    // for it go out as Compressed frames: the original binary frame, raw-
+    // deflated. Each lane is one deflate stream for the life of the
+    // connection, so a frame is compressed against the 32 KB of its lane
+    // that went before it — the node names every delta repeats, the mesh
+    // data a chunk continues. Both ends start the streams with the
+    // connection and drop them with it; nothing is ever re-synchronized.
+    //
+    // A student asks with the kCompressHeader request header. Camera,
+    // pointer and probe frames are never compressed: they are small, and
+    // sent the moment they are made.
+    // ─────────────────────────────────────────────────────────────────────
+    constexpr const char* kCompressHeader  = "X-Atometa-Compress";
+    constexpr const char* kCompressDeflate = "deflate";
+
+    // Frames below this are sent as they are: deflate saves little on them
+    // and each one costs a sync marker
+    constexpr size_t kMinCompressSize = 256;
+
+    // A Compressed frame may not claim to inflate past this
+    constexpr uint32_t kMaxInflatedSize = 32u << 20;
+
+    // Every student pays for its own streams, so the fastest level: the
+    // slower ones take twice the CPU or more for a few percent on deltas
+    // and mesh data (see benchmarks/CompressionBench.cpp)
+    constexpr int kCompressLevel = 1;
+
+    // ── FrameDeflater ────────────────────────────────────────────────────
+    // Sender side of one stream. Not thread-safe: a session only touches
+    // its deflaters on its own io thread, in the order frames are queued.
+    //
+    // A frame sent raw never enters the stream, so the deflater is free
+    // to skip any. After a frame that shrank by less than a tenth (an
+    // already-compressed texture, say) it skips the next one, then 2, 4 …
+    // up to kMaxRest frames between tries, until one shrinks again.
+    class FrameDeflater {
+    public:
+        static constexpr uint32_t kMaxRest = 64;
+
+        explicit FrameDeflater(uint8_t stream, int level = kCompressLevel);
+        ~FrameDeflater();
+
+        FrameDeflater(const FrameDeflater&)            = delete;
+        FrameDeflater& operator=(const FrameDeflater&) = delete;
+
+        // Compressed frame carrying frame — false if frame is to be sent
+        // as it is (too large, resting, or the stream broke). A frame once
+        // compressed must be sent: the receiver's window has to see it too.
+        bool Compress(const std::string& frame, std::string& out);
+
+        uint8_t GetStream() const { return m_Stream; }
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_Impl;
+        uint8_t               m_Stream  = 0;
+        bool                  m_Broken  = false;
+        uint32_t              m_Rest    = 0;   // frames still to skip
+        uint32_t              m_Backoff = 0;   // length of the last rest
+    };
+
+    // ── FrameInflater ────────────────────────────────────────────────────
+    // Receiver side of one stream
+    class FrameInflater {
+    public:
+        FrameInflater();
+        ~FrameInflater();
+
+        FrameInflater(const FrameInflater&)            = delete;
+        FrameInflater& operator=(const FrameInflater&) = delete;
+
+        // The frame a Compressed message carries — false if its bytes do
+        // not inflate to exactly the size announced. The stream is then
+        // out of step with the sender and the connection must be dropped.
+        bool Expand(const NetMessage& compressed, std::string& frame);
+
+        // New connection: forget the window
+        void Reset();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> m_Impl;
+    };
+
+} // namespace Atometa
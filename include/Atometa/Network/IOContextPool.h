@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Atometa {
+
+    // ── IOContextPool ─────────────────────────────────────────────────────
+    // One io_context per thread ("io_context-per-core"). Work is spread by
+    // handing out contexts round-robin with Next(); everything bound to a
+    // context runs on that context's single thread.
+    // Contexts are created fresh by every Start(), so a pool can be
+    // stopped and started again.
+    // ─────────────────────────────────────────────────────────────────────
+    class IOContextPool {
+    public:
+        // One OS thread each; past a few per core they only contend, and
+        // a mistyped thread count should not spawn thousands
+        static constexpr size_t kMaxThreads = 64;
+
+        explicit IOContextPool(size_t threadCount = 1);
+        ~IOContextPool();
+
+        IOContextPool(const IOContextPool&)            = delete;
+        IOContextPool& operator=(const IOContextPool&) = delete;
+
+        // Takes effect on the next Start()
+        void   SetThreadCount(size_t count);
+        size_t GetThreadCount() const { return m_ThreadCount; }
+
+        void Start();
+        // Stops every context and joins its thread. Contexts stay alive
+        // (so sockets bound to them can still be destroyed) until Reset().
+        void Stop();
+        void Reset();
+
+        bool IsRunning() const { return !m_Threads.empty(); }
+
+        // Valid between Start() and Reset()
+        size_t                   NextIndex()       { return m_Next++ % m_Contexts.size(); }
+        boost::asio::io_context& Next()            { return Get(NextIndex()); }
+        boost::asio::io_context& Get(size_t index) { return *m_Contexts[index]; }
+        size_t                   Size() const      { return m_Contexts.size(); }
+
+    private:
+        using WorkGuard = boost::asio::executor_work_guard<
+                              boost::asio::io_context::executor_type>;
+
+        size_t                                                m_ThreadCount;
+        std::vector<std::unique_ptr<boost::asio::io_context>> m_Contexts;
+        std::vector<WorkGuard>                                m_Guards;
+        std::vector<std::thread>                              m_Threads;
+        std::atomic<size_t>                                   m_Next = 0;
+    };
+
+} // namespace Atometa
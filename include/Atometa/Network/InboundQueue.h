@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace Atometa {
+
+    struct InboundQueueStats {
+        uint64_t Pushed        = 0;
+        uint64_t Dropped       = 0;   // queue full when the io thread pushed
+        uint64_t Delivered     = 0;   // handed to the drain callback
+        uint64_t Collapsed     = 0;   // camera updates superseded in one drain
+        double   LastLatencyUs = 0.0; // push → drain of the newest message
+        double   MaxLatencyUs  = 0.0;
+        double   AvgLatencyUs  = 0.0; // running average over drained messages
+    };
+
+    // ── InboundQueue ──────────────────────────────────────────────────────
+    // Bounded lock-free MPSC ring between the io threads (producers) and
+    // the render thread (single consumer), so network callbacks never touch
+    // render state. Drain() runs once per frame; of the CameraSync messages
+    // drained together only the newest is delivered, after everything else
+    // (pass collapseCamera = false when a jitter buffer wants every sample).
+    // Push never blocks: a full queue drops the message and counts it.
+    // Usage:
+    //   network.SetOnMessage([&](const NetMessage& m) { queue.Push(m); });
+    //   queue.Drain([&](const NetMessage& m) { Apply(m); });   // per frame
+    // ─────────────────────────────────────────────────────────────────────
+    class InboundQueue {
+    public:
+        // capacity is rounded up to a power of two
+        explicit InboundQueue(size_t capacity = 256);
+
+        InboundQueue(const InboundQueue&)            = delete;
+        InboundQueue& operator=(const InboundQueue&) = delete;
+
+        // Any thread. Returns false (and counts a drop) when full.
+        bool Push(const NetMessage& msg);
+
+        // Consumer thread only. Returns false when empty.
+        bool Pop(NetMessage& out);
+
+        // Consumer thread only. Returns the number of messages delivered.
+        template<typename Fn>
+        size_t Drain(Fn&& deliver, bool collapseCamera = true);
+
+        size_t Capacity() const { return m_Mask + 1; }
+
+        // Consumer-side fields are only meaningful on the consumer thread
+        InboundQueueStats GetStats() const;
+
+    private:
+        struct Cell {
+            std::atomic<size_t> Sequence = 0;
+            NetMessage          Msg;
+            int64_t             PushedNs = 0;
+        };
+
+        bool PopCell(NetMessage& out, int64_t& pushedNs);
+        void RecordLatency(int64_t pushedNs, int64_t nowNs);
+
+        static int64_t NowNs()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        std::unique_ptr<Cell[]> m_Cells;
+        size_t                  m_Mask = 0;
+
+        // Producers claim slots on m_Head; the consumer owns m_Tail
+        alignas(64) std::atomic<size_t> m_Head = 0;
+        alignas(64) size_t              m_Tail = 0;
+
+        std::atomic<uint64_t> m_Pushed  = 0;
+        std::atomic<uint64_t> m_Dropped = 0;
+
+        // Consumer thread only
+        InboundQueueStats m_ConsumerStats;
+        uint64_t          m_LatencySamples = 0;
+    };
+
+    template<typename Fn>
+    size_t InboundQueue::Drain(Fn&& deliver, bool collapseCamera)
+    {
+        NetMessage msg;
+        NetMessage camera;
+        bool       hasCamera = false;
+        size_t     delivered = 0;
+        int64_t    pushedNs  = 0;
+        int64_t    now       = NowNs();
+
+        // Bounded by one ring's worth so busy producers cannot stall a frame
+        for (size_t i = 0; i <= m_Mask && PopCell(msg, pushedNs); ++i) {
+            RecordLatency(pushedNs, now);
+            if (collapseCamera && msg.Type == NetMsgType::CameraSync) {
+                if (hasCamera) ++m_ConsumerStats.Collapsed;
+                camera    = std::move(msg);
+                hasCamera = true;
+                continue;
+            }
+            deliver(static_cast<const NetMessage&>(msg));
+            ++delivered;
+        }
+
+        if (hasCamera) {
+            deliver(static_cast<const NetMessage&>(camera));
+            ++delivered;
+        }
+        m_ConsumerStats.Delivered += delivered;
+        return delivered;
+    }
+
+} // namespace Atometa
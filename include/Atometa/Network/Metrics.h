@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Atometa {
+
+    // ── LatencyHistogram ─────────────────────────────────────────────────
+    // Fixed buckets from 100 µs to 1 s. Observe() is two relaxed atomic
+    // adds, so the render and io threads record without ever waiting on
+    // each other or on a scrape. A scrape racing a writer may count a
+    // sample whose time is not in the sum yet; the next one is exact.
+    // ─────────────────────────────────────────────────────────────────────
+    class LatencyHistogram {
+    public:
+        static constexpr std::array<uint32_t, 15> kBoundsUs = {
+            100, 250, 500, 1'000, 2'500, 5'000, 8'333, 16'667, 33'333,
+            50'000, 100'000, 250'000, 500'000, 1'000'000, 2'500'000,
+        };
+        static constexpr size_t kBuckets = kBoundsUs.size() + 1;   // last: +Inf
+
+        struct Snapshot {
+            std::array<uint64_t, kBuckets> Counts = {};   // per bucket, not cumulative
+            uint64_t Count = 0;
+            uint64_t SumUs = 0;
+        };
+
+        void     Observe(uint64_t us);
+        Snapshot Read() const;
+
+    private:
+        std::array<std::atomic<uint64_t>, kBuckets> m_Counts = {};
+        std::atomic<uint64_t>                       m_SumUs  = 0;
+    };
+
+    // ── MetricsText ──────────────────────────────────────────────────────
+    // Builds a Prometheus text exposition (format 0.0.4). Declare a family
+    // once, then write its samples; labels are passed preformatted, e.g.
+    // lane="bulk".
+    // ─────────────────────────────────────────────────────────────────────
+    class MetricsText {
+    public:
+        void Family(const char* name, const char* type, const char* help);
+        void Sample(const char* name, double value, const std::string& labels = "");
+        void Sample(const char* name, uint64_t value, const std::string& labels = "");
+
+        // _bucket / _sum / _count of a histogram family, in seconds
+        void Histogram(const char* name, const LatencyHistogram::Snapshot& snapshot,
+                       const std::string& labels = "");
+
+        const std::string& Str() const { return m_Out; }
+
+    private:
+        void Name(const char* name, const char* suffix, const std::string& labels);
+
+        std::string m_Out;
+    };
+
+} // namespace Atometa
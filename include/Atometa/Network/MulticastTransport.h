@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Atometa {
+
+    // ── Multicast datagram ───────────────────────────────────────────────
+    //   [0]  magic   0xA8     — told apart from a WebSocket binary frame
+    //   [1]  flags   (kMulticastFlag*)
+    //   [2]  reserved (u16)
+    //   [4]  u32 stream id    — random per host session
+    //   [8]  u32 sequence     — per datagram, from 1
+    //   [12…] one NetMessage in the binary wire format (none in a heartbeat)
+    constexpr uint8_t kMulticastMagic      = 0xA8;
+    constexpr size_t  kMulticastHeaderSize = 12;
+
+    // Payload-free datagram repeating the last sequence sent, so a student
+    // notices a lost datagram even when nothing follows it
+    constexpr uint8_t kMulticastFlagHeartbeat = 0x01;
+
+    // Keeps header + payload under a typical 1500-byte Ethernet MTU
+    constexpr size_t kMaxMulticastPayload = 1200;
+
+    // Latest-wins state that may go over multicast: a lost frame is made
+    // good by the next one. Scene deltas stay on the WebSocket because each
+    // one builds on the last.
+    inline bool IsMulticastType(NetMsgType type)
+    {
+        return type == NetMsgType::CameraSync || type == NetMsgType::NodeSelect ||
+               type == NetMsgType::Pointer;
+    }
+
+    struct MulticastConfig {
+        bool        Enabled   = false;
+        std::string Group     = "239.255.77.1";   // administratively scoped
+        uint16_t    Port      = 30077;
+        uint8_t     Ttl       = 1;                // stay on the local subnet
+        std::string Interface;                    // host NIC address, "" = default route
+    };
+
+    struct MulticastHeader {
+        uint8_t  Flags    = 0;
+        uint32_t Stream   = 0;
+        uint32_t Sequence = 0;
+
+        bool IsHeartbeat() const { return (Flags & kMulticastFlagHeartbeat) != 0; }
+    };
+
+    // Parses a datagram; msg is left alone for heartbeats
+    bool DecodeMulticast(const void* data, size_t size, MulticastHeader& header, NetMessage& msg);
+
+    struct MulticastSenderStats {
+        uint64_t Datagrams  = 0;
+        uint64_t Bytes      = 0;
+        uint64_t Heartbeats = 0;
+        uint64_t Oversize   = 0;   // too big for one datagram, left to the WebSocket
+        uint64_t Repaired   = 0;   // NACKed datagrams resent over the WebSocket
+        uint64_t Superseded = 0;   // NACKs not answered: a newer frame of that type went out
+    };
+
+    // ── MulticastSender (host) ────────────────────────────────────────────
+    // Numbers datagrams and remembers the last kHistory of them so NACKs can
+    // be answered. Only the newest frame of each type is worth repairing; a
+    // student missing an older camera already has (or will ask for) a newer
+    // one. Thread-safe.
+    // ─────────────────────────────────────────────────────────────────────
+    class MulticastSender {
+    public:
+        static constexpr size_t kHistory = 1024;
+
+        explicit MulticastSender(uint32_t stream);
+
+        uint32_t GetStream() const { return m_Stream; }
+
+        // Datagram carrying msg under the next sequence number, or "" if
+        // msg does not fit in one
+        std::string Encode(const NetMessage& msg);
+
+        std::string Heartbeat();
+
+        // The message sent as sequence, if it is still in the history and
+        // still the newest of its type
+        bool Repair(uint32_t sequence, NetMessage& out);
+
+        MulticastSenderStats GetStats() const;
+
+    private:
+        struct Entry {
+            uint32_t   Sequence = 0;
+            NetMessage Msg;
+        };
+
+        std::string Header(uint8_t flags, uint32_t sequence) const;
+
+    private:
+        mutable std::mutex        m_Mutex;
+        uint32_t                  m_Stream;
+        uint32_t                  m_Sequence = 0;
+        std::vector<Entry>        m_History;
+        std::array<uint32_t, 256> m_Latest{};   // newest sequence per NetMsgType
+        MulticastSenderStats      m_Stats;
+    };
+
+    struct MulticastTrackerStats {
+        uint64_t Received   = 0;   // datagrams with a payload
+        uint64_t Heartbeats = 0;
+        uint64_t Lost       = 0;   // sequence numbers NACKed
+        uint64_t Late       = 0;   // arrived after being NACKed
+        uint64_t Duplicates = 0;
+    };
+
+    // ── MulticastTracker (student) ────────────────────────────────────────
+    // Follows one stream's sequence numbers: each gap is NACKed once, a
+    // late arrival for a gap is still delivered, duplicates are not.
+    // ─────────────────────────────────────────────────────────────────────
+    class MulticastTracker {
+    public:
+        // NACK at most this many sequence numbers per gap (the newest ones;
+        // anything older has long been superseded)
+        static constexpr uint32_t kMaxNack    = 64;
+        static constexpr size_t   kMaxMissing = 256;
+
+        // Returns true if the datagram's message should be delivered.
+        // Sequence numbers to NACK are appended to nacks.
+        bool Accept(const MulticastHeader& header, std::vector<uint32_t>& nacks);
+
+        uint32_t GetHighest() const { return m_Highest; }
+        const MulticastTrackerStats& GetStats() const { return m_Stats; }
+
+        void Reset();
+
+    private:
+        bool                  m_Started = false;
+        uint32_t              m_Highest = 0;
+        std::set<uint32_t>    m_Missing;
+        MulticastTrackerStats m_Stats;
+    };
+
+} // namespace Atometa
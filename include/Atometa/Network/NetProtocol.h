@@ -0,0 +1,264 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace Atometa {
+
+    // ── Message types sent over the wire ─────────────────────────────────
+    enum class NetMsgType : uint8_t {
+        CameraSync   = 0,   // Professor → Students: camera transform
+        NodeSelect   = 1,   // Professor → Students: selected node index (legacy,
+                            // selection now rides in SceneSnapshot / SceneDelta)
+        ChatMessage  = 2,   // Any → All: text message
+        SessionInfo  = 3,   // Server → new client: session metadata
+        Ping         = 4,
+        Pong         = 5,
+        AssetManifest = 6,  // Host → Student: files in the scene (see AssetStream.h)
+        AssetRequest  = 7,  // Student → Host: chunk hashes missing from its cache
+        AssetChunk    = 8,  // Host → Student: one content-addressed chunk (bulk lane)
+        SceneSnapshot = 9,  // Host → Student on join: every model's replicated state
+        SceneDelta    = 10, // Host → Students: fields changed since the last delta
+        MulticastControl = 11, // Student → Host: multicast subscribe / NACKs (see MulticastTransport.h)
+        TreeControl      = 12, // Relay tree: load reports up, redirects and path latency down
+        Fragment         = 13, // Piece of a larger binary frame (see PriorityLanes.h)
+        Batch            = 14, // Host → Students: one tick's messages in one frame
+        Pointer          = 15, // Host → Students: laser-pointer samples (see PointerStream.h)
+        Compressed       = 16, // Host → Student: a deflated binary frame (see Compression.h)
+    };
+
+    // ── Wire format ──────────────────────────────────────────────────────
+    // Negotiated per connection through the Sec-WebSocket-Protocol header
+    // during the WebSocket handshake. Peers that don't offer a subprotocol
+    // (clients older than the binary format) are served Json.
+    enum class WireFormat : uint8_t { Json = 0, Binary = 1 };
+
+    constexpr const char* kJsonSubprotocol   = "atometa.json";
+    constexpr const char* kBinarySubprotocol = "atometa.bin.v1";
+
+    // Binary frame layout (all multi-byte fields little-endian):
+    //   [0] magic   0xA7     — never a valid first byte of JSON text
+    //   [1] version
+    //   [2] NetMsgType
+    //   [3] flags   (kWireFlag*, unknown bits ignored)
+    //   [4…] payload:
+    //        CameraSync   f32 yaw, f32 pitch, f32 dist
+    //                     [+ u32 seq, u64 host time µs   if kWireFlagStamped]
+    //        NodeSelect   i32 index
+    //        Ping         u64 timestamp  [+ u32 rtt µs       if kWireFlagProbe]
+    //        Pong         u64 timestamp  [+ u64 echoed ping  if kWireFlagProbe]
+    //        AssetChunk   u8 hash length, hash (hex), chunk bytes
+    //        Fragment     u32 message id, u32 total size, u32 offset, bytes
+    //        Batch        per message: u32 length, complete binary frame
+    //        Compressed   u32 stream, u32 inflated size, raw deflate bytes
+    //                     (sync-flushed, its 00 00 FF FF tail left off)
+    //        Pointer      u32 seq, u64 host time µs of the first sample,
+    //                     u8 samples (0 = hidden), first sample f32×3,
+    //                     then per sample: u16 time since the previous one
+    //                     (100 µs units), i16×3 position change
+    //                     (kPointerStep units)
+    //        SceneSnapshot / SceneDelta
+    //                     u32 seq, u16 model count, i32 selection, u16 updates,
+    //                     then per update: u16 index, u8 kNodeField* mask and
+    //                     only the fields in the mask, in bit order —
+    //                     f32×3 position, f32×3 rotation, f32 scale,
+    //                     u8 visible, u8 length + UTF-8 name
+    //        ChatMessage / SessionInfo / AssetManifest / AssetRequest /
+    //        MulticastControl / TreeControl
+    //                     UTF-8 JSON text
+    constexpr uint8_t kWireMagic      = 0xA7;
+    constexpr uint8_t kWireVersion    = 1;
+    constexpr size_t  kWireHeaderSize = 4;
+
+    // CameraSync carries the host's sequence number and clock. Decoders
+    // that predate the flag read the first 12 bytes and ignore the rest.
+    constexpr uint8_t kWireFlagStamped = 0x01;
+
+    // Ping / Pong carry the round-trip fields used for RTT and clock-offset
+    // estimation (see NetMessage::RoundTrip / EchoTimestamp)
+    constexpr uint8_t kWireFlagProbe   = 0x02;
+
+    // Pointer positions travel as deltas from the previous sample in steps
+    // of this many world units (±16 units per sample at most)
+    constexpr float    kPointerStep       = 0.0005f;
+    constexpr uint32_t kPointerTimeStepUs = 100;
+
+    // Wire header plus the Fragment fields; the slice of the original
+    // frame follows it
+    constexpr size_t kFragmentHeaderSize = kWireHeaderSize + 12;
+
+    // ── Little-endian packing helpers ────────────────────────────────────
+    class WireWriter {
+    public:
+        explicit WireWriter(std::string& out) : m_Out(out) {}
+
+        void U8 (uint8_t v)  { m_Out.push_back(static_cast<char>(v)); }
+        void U16(uint16_t v) { PutLE(v, 2); }
+        void U32(uint32_t v) { PutLE(v, 4); }
+        void U64(uint64_t v) { PutLE(v, 8); }
+        void I32(int32_t v)  { U32(static_cast<uint32_t>(v)); }
+        void F32(float v)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            U32(bits);
+        }
+        void Bytes(const void* data, size_t size)
+        {
+            m_Out.append(static_cast<const char*>(data), size);
+        }
+
+    private:
+        void PutLE(uint64_t v, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+                m_Out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+        }
+
+        std::string& m_Out;
+    };
+
+    // Reads never run past the end: once a read would overflow, Ok() turns
+    // false and every later read returns 0.
+    class WireReader {
+    public:
+        WireReader(const void* data, size_t size)
+            : m_Data(static_cast<const uint8_t*>(data)), m_Size(size) {}
+
+        uint8_t  U8()  { return static_cast<uint8_t>(GetLE(1)); }
+        uint16_t U16() { return static_cast<uint16_t>(GetLE(2)); }
+        uint32_t U32() { return static_cast<uint32_t>(GetLE(4)); }
+        uint64_t U64() { return GetLE(8); }
+        int32_t  I32() { return static_cast<int32_t>(U32()); }
+        float F32()
+        {
+            uint32_t bits = U32();
+            float v;
+            std::memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+
+        void Skip(size_t bytes)
+        {
+            if (!m_Ok || m_Size - m_Pos < bytes) { m_Ok = false; return; }
+            m_Pos += bytes;
+        }
+
+        const uint8_t* Current()   const { return m_Data + m_Pos; }
+        size_t         Remaining() const { return m_Size - m_Pos; }
+        bool           Ok()        const { return m_Ok; }
+
+    private:
+        uint64_t GetLE(size_t bytes)
+        {
+            if (!m_Ok || m_Size - m_Pos < bytes) { m_Ok = false; return 0; }
+            uint64_t v = 0;
+            for (size_t i = 0; i < bytes; ++i)
+                v |= static_cast<uint64_t>(m_Data[m_Pos + i]) << (8 * i);
+            m_Pos += bytes;
+            return v;
+        }
+
+        const uint8_t* m_Data;
+        size_t         m_Size;
+        size_t         m_Pos = 0;
+        bool           m_Ok  = true;
+    };
+
+    // ── Typed payloads ───────────────────────────────────────────────────
+    struct NetCamera {
+        float Yaw      = 0.0f;
+        float Pitch    = 0.0f;
+        float Distance = 10.0f;
+    };
+
+    // One laser-pointer position; OffsetUs is relative to the message's
+    // Timestamp (the first sample's host time)
+    struct NetPointerSample {
+        uint32_t             OffsetUs = 0;
+        std::array<float, 3> Position = { 0.f, 0.f, 0.f };
+    };
+
+    // ── Replicated scene state ───────────────────────────────────────────
+    // Fields of one model that SceneSnapshot / SceneDelta can carry
+    constexpr uint8_t kNodeFieldPosition = 0x01;
+    constexpr uint8_t kNodeFieldRotation = 0x02;
+    constexpr uint8_t kNodeFieldScale    = 0x04;
+    constexpr uint8_t kNodeFieldVisible  = 0x08;
+    constexpr uint8_t kNodeFieldName     = 0x10;
+    constexpr uint8_t kNodeFieldAll      = 0x1F;
+
+    struct NetNode {
+        uint16_t             Index    = 0;    // position in the host's scene
+        uint8_t              Fields   = 0;    // kNodeField* present in this update
+        std::array<float, 3> Position = { 0.f, 0.f, 0.f };
+        std::array<float, 3> Rotation = { 0.f, 0.f, 0.f };  // Euler degrees
+        float                Scale    = 1.f;
+        bool                 Visible  = true;
+        std::string          Name;           // at most 255 bytes on the wire
+    };
+
+    // ── NetMessage ───────────────────────────────────────────────────────
+    // Hot-path types (CameraSync, NodeSelect, Ping/Pong, Scene*, Pointer) carry typed
+    // fields so the binary codec never touches json. ChatMessage, SessionInfo and
+    // the asset manifest / request keep their free-form payload in Data.
+    struct NetMessage {
+        NetMsgType  Type      = NetMsgType::Ping;
+        json        Data;               // ChatMessage / SessionInfo
+                                        // Batch (json): array of messages
+        NetCamera   Camera;             // CameraSync
+        int32_t     NodeIndex = -1;     // NodeSelect / scene: selected model
+        uint64_t    Timestamp = 0;      // Ping / Pong / CameraSync (sender clock, µs)
+        uint32_t    Sequence  = 0;      // CameraSync: host counter from 1, 0 = unstamped
+                                        // Scene*: delta counter (snapshot: last included)
+        uint32_t    RoundTrip = 0;      // Ping: sender's latest RTT to this peer (µs)
+        uint64_t    EchoTimestamp = 0;  // Pong: Timestamp of the Ping answered
+        std::string ChunkHash;          // AssetChunk: content hash (hex SHA-1)
+        std::string Blob;               // AssetChunk / Fragment: raw bytes
+                                        // Batch (binary): the length-prefixed frames
+                                        // Compressed: the deflated frame
+        uint32_t    FragmentTotal  = 0; // Fragment: size of the whole frame (id in Sequence)
+        uint32_t    FragmentOffset = 0; // Fragment: where Blob starts in it
+        uint32_t    InflatedSize   = 0; // Compressed: size of the frame in Blob (stream in Sequence)
+        uint16_t    NodeCount = 0;      // Scene*: models in the host's scene
+        std::vector<NetNode> Nodes;     // Scene*: per-model updates
+        std::vector<NetPointerSample> Pointer; // Pointer: oldest first, empty = hidden
+                                        // (Sequence / Timestamp as for CameraSync)
+
+        bool IsStamped() const { return Sequence != 0; }
+        bool IsProbe()   const { return RoundTrip != 0 || EchoTimestamp != 0; }
+
+        // Serialize in the given wire format
+        std::string Serialize(WireFormat format = WireFormat::Json) const;
+
+        // Deserialize either wire format (detected from the first byte)
+        // — returns false on parse error
+        static bool Deserialize(const std::string& raw, NetMessage& out);
+
+        // Same, straight from a receive buffer: binary frames decode in
+        // place, and camera / selection / probe Json frames skip the DOM
+        static bool Deserialize(const void* data, size_t size, NetMessage& out);
+    };
+
+    // Binary Fragment header; sent with the slice as a second buffer, so a
+    // large frame is split without copying it
+    std::string EncodeFragmentHeader(uint32_t id, uint32_t total, uint32_t offset);
+
+    // Batch frame from frames already serialized in format. A Json batch is
+    // {"type":14,"data":[<message>, …]}, spliced together without re-parsing.
+    std::string EncodeBatch(WireFormat format, const std::vector<std::string>& frames);
+
+    // The messages of a received Batch, in order — false if any is malformed
+    // or itself a Batch / Fragment / Compressed
+    bool UnpackBatch(const NetMessage& batch, std::vector<NetMessage>& out);
+
+} // namespace Atometa
@@ -1,16 +1,27 @@
 #pragma once
 
 #include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+#include "Atometa/Network/Compression.h"
+#include "Atometa/Network/IOContextPool.h"
+#include "Atometa/Network/Metrics.h"
+#include "Atometa/Network/AssetStream.h"
+#include "Atometa/Network/MulticastTransport.h"
+#include "Atometa/Network/PriorityLanes.h"
+#include "Atometa/Network/SceneReplication.h"
+#include "Atometa/Network/SessionRecorder.h"
+#include "Atometa/Network/StudentInbox.h"
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ip/udp.hpp>
 #include <boost/asio/strand.hpp>
 
-#include <nlohmann/json.hpp>
-
+#include <array>
 #include <string>
 #include <thread>
+#include <unordered_set>
 #include <atomic>
 #include <functional>
 #include <vector>
@@ -20,29 +31,105 @@
 namespace beast = boost::beast;
 namespace asio  = boost::asio;
 using     tcp   = asio::ip::tcp;
-using     json  = nlohmann::json;
+using     udp   = asio::ip::udp;
 
 namespace Atometa {
 
-    // ── Message types sent over the wire ─────────────────────────────────
-    enum class NetMsgType : uint8_t {
-        CameraSync   = 0,   // Professor → Students: camera transform
-        NodeSelect   = 1,   // Professor → Students: selected node index
-        ChatMessage  = 2,   // Any → All: text message
-        SessionInfo  = 3,   // Server → new client: session metadata
-        Ping         = 4,
-        Pong         = 5,
+    // ── Round-trip probe results ─────────────────────────────────────────
+    // Over the last RTT window. ClockOffsetMs = peer clock − local clock,
+    // taken from the fastest probe (NTP-style, one-way delay = RTT / 2).
+    struct RoundTripStats {
+        uint32_t Samples       = 0;
+        float    MinMs         = 0.f;
+        float    AvgMs         = 0.f;
+        float    P99Ms         = 0.f;
+        float    ClockOffsetMs = 0.f;
+    };
+
+    // ── Per-student send metrics (Host role) ─────────────────────────────
+    struct SessionStats {
+        std::string PeerIp;
+        WireFormat  Format        = WireFormat::Json;
+        uint32_t    QueueDepth    = 0;   // realtime + control frames waiting
+        uint32_t    MaxQueueDepth = 0;   // high-water mark
+        uint64_t    MessagesSent  = 0;
+        uint64_t    BytesSent     = 0;
+        uint64_t    Coalesced     = 0;   // camera frames replaced before sending
+        RoundTripStats RoundTrip;        // from periodic Ping / Pong
+        uint64_t    AssetChunksSent    = 0;
+        uint32_t    AssetChunksPending = 0;  // requested, not yet sent
+        bool        TreeRelay   = false;     // passes the stream on (relay tree)
+        uint32_t    TreeSubtree = 0;         // students below it
+        std::array<LaneStats, kLaneCount> Lanes; // indexed by Lane
+        StudentInboxStats Inbox;             // messages it sent the host
+    };
+
+    // ── Asset download progress (Client role) ────────────────────────────
+    struct AssetProgress {
+        uint32_t ChunksTotal    = 0;   // missing from the cache at join
+        uint32_t ChunksReceived = 0;
+        uint64_t BytesReceived  = 0;
+
+        bool Complete() const { return ChunksReceived >= ChunksTotal; }
     };
 
-    struct NetMessage {
-        NetMsgType  Type;
-        json        Data;
+    // ── Reconnection (Client role) ──────────────────────────────────────
+    // Since Connect(). Reconnect time runs from losing the connection until
+    // the host's join burst has been received again.
+    struct ReconnectStats {
+        uint32_t Drops          = 0;   // established connections lost
+        uint32_t FailedAttempts = 0;   // connects / handshakes that failed
+        uint32_t Resumed        = 0;   // rejoined from the missed deltas
+        uint32_t FullResyncs    = 0;   // rejoined from a full snapshot
+        float    LastMs         = 0.f;
+        float    MaxMs          = 0.f;
+    };
 
-        // Serialize to JSON string
-        std::string Serialize() const;
+    // ── Multicast transport ──────────────────────────────────────────────
+    struct MulticastStats {
+        bool                  Active      = false;   // host: sending / student: hearing the group
+        uint32_t              Subscribers = 0;       // host: students served by multicast only
+        MulticastSenderStats  Sent;                  // host
+        MulticastTrackerStats Received;              // student
+    };
 
-        // Deserialize from JSON string — returns false on parse error
-        static bool Deserialize(const std::string& raw, NetMessage& out);
+    // ── Relay tree ───────────────────────────────────────────────────────
+    // Where a node of the tree accepts students
+    struct TreeAddress {
+        std::string Host;
+        uint16_t    Port = 0;
+    };
+
+    // Latencies are one-way estimates (RTT / 2), summed hop by hop from the
+    // host down to this node
+    struct TreeStats {
+        bool     Relaying      = false;   // passing the stream on to students of its own
+        uint32_t Depth         = 0;       // hops below the host (0 = the host)
+        uint32_t Children      = 0;       // students connected here directly
+        uint32_t Subtree       = 0;       // students below this node, all levels
+        uint64_t Redirects     = 0;       // joiners handed down to a relay child
+        uint32_t Repairs       = 0;       // re-attached to an ancestor after a relay left
+        float    HopLatencyMs  = 0.f;     // to the parent
+        float    PathLatencyMs = 0.f;     // from the host
+    };
+
+    // ── Totals since the layer was created ───────────────────────────────
+    struct NetworkStats {
+        uint32_t Clients          = 0;
+        uint64_t MessagesSent     = 0;   // frames written, all connections
+        uint64_t BytesSent        = 0;
+        uint64_t MessagesReceived = 0;
+        uint64_t BytesReceived    = 0;
+        uint64_t MessagesRelayed  = 0;   // upstream messages fanned out (relay)
+        uint64_t DroppedClients   = 0;
+        uint64_t JoinSnapshots    = 0;   // students sent the full join snapshot
+        uint64_t ResumedJoins     = 0;   // students caught up from missed deltas
+        uint64_t Batches          = 0;   // per-tick frames written, all students
+        uint64_t BatchedMessages  = 0;   // messages they carried
+        StudentInboxStats StudentMessages;   // from students, all of them (host / relay)
+        uint64_t UplinkDropped    = 0;   // client: Send() with the outbox full
+        uint64_t CompressedIn     = 0;   // frames deflated for students: bytes before
+        uint64_t CompressedOut    = 0;   // and after
     };
 
     // ── Callbacks the Application registers ──────────────────────────────
@@ -51,12 +138,15 @@ namespace Atometa {
     using OnDisconnectCallback = std::function<void(const std::string& peerIp)>;
 
     // ── Role ──────────────────────────────────────────────────────────────
-    enum class NetworkRole { None, Host, Client };
+    // Publisher: the professor's app feeding a relay instead of hosting
+    enum class NetworkRole { None, Host, Client, Publisher };
 
     // ── NetworkLayer ──────────────────────────────────────────────────────
     // Single class that can act as either an embedded WS server (Host)
-    // or a WS client (Student).  Both run on a background thread so the
-    // render loop is never blocked.
+    // or a WS client (Student).  Both run asynchronously on a pool of io
+    // threads, so the render loop is never blocked. The host spreads
+    // students round-robin over the pool; a student's connection lives
+    // on its first context.
     class NetworkLayer {
     public:
         NetworkLayer();
@@ -67,19 +157,171 @@ namespace Atometa {
         bool StartHost(uint16_t port = 8080);
         void StopHost();
 
+        // Relay mode (headless AtometaRelay): a peer connecting to
+        // /publish[?key=...] becomes the upstream, and everything it sends
+        // is rebroadcast to the students. Call before StartHost.
+        void SetRelayMode(bool enabled, const std::string& publishKey = "");
+
+        // Number of io threads the host uses (takes effect on StartHost)
+        void   SetIOThreadCount(size_t count) { m_IOPool.SetThreadCount(count); }
+        size_t GetIOThreadCount() const       { return m_IOPool.GetThreadCount(); }
+
+        // ── Publisher (Professor → relay) ─────────────────────────────
+        // Opens a single upstream connection to an AtometaRelay; Send()
+        // then goes to the relay, which does the fan-out. Stop with
+        // Disconnect().
+        bool Publish(const std::string& relayHost, uint16_t port = 8080,
+                     const std::string& publishKey = "");
+
         // ── Client (Student) ──────────────────────────────────────────
-        // Connects to professor's machine
+        // Connects to professor's machine. A lost connection is retried
+        // with exponential backoff until Disconnect(); on rejoining, the
+        // host replays just the scene deltas missed while away, if it
+        // still has them. Both return at once: the connection is made,
+        // and on leaving closed with a WebSocket close handshake (1 s at
+        // most), on the io thread. Connect() may follow Disconnect()
+        // straight away; starting again cuts that handshake short.
         bool Connect(const std::string& host, uint16_t port = 8080);
         void Disconnect();
 
+        // ── Relay tree (very large audiences) ─────────────────────────
+        // Client: also accept students on port and pass the host's stream
+        // on to them. advertiseHost is the address students should dial
+        // (default: the address the parent sees this peer on). Call before
+        // Connect.
+        void SetTreeRelay(uint16_t port, const std::string& advertiseHost = "");
+
+        // Host / relay: at most this many direct students (0 = no limit).
+        // Past that, a joiner is redirected to the relay child with the
+        // smallest subtree, which in turn may pass it further down. A
+        // student whose relay leaves climbs back up its ancestors and
+        // resumes from the deltas it missed.
+        void SetTreeFanout(uint32_t children) { m_TreeFanout = children; }
+
+        TreeStats GetTreeStats() const;
+
+        // Delay before the first retry, doubling up to maxMs (±25% jitter
+        // so a classroom that lost Wi-Fi together doesn't return in step)
+        void SetReconnectBackoff(uint32_t minMs, uint32_t maxMs);
+        ReconnectStats GetReconnectStats() const;
+
         // ── Shared ────────────────────────────────────────────────────
-        // Send to all connected peers (host broadcasts; client sends to host)
-        void Send(const NetMessage& msg);
+        // Send to all connected peers (host broadcasts; client sends to host).
+        // Returns the number of bytes queued across all recipients.
+        // A student's messages go through an outbox (at most kMaxUplink)
+        // that the io thread writes out right away; what is still there
+        // when the connection drops is sent after the reconnect.
+        size_t Send(const NetMessage& msg);
+
+        static constexpr size_t kMaxUplink = 64;
+
+        // ── Student messages (Host role) ──────────────────────────────
+        // What students send reaches OnMessage through a per-student token
+        // bucket and a round-robin inbox drained by one io thread, so a
+        // student flooding the host is throttled without delaying anyone
+        // else. A tree relay passes its students' messages up to its
+        // parent, and a relay (SetRelayMode) to the publisher, instead of
+        // delivering them. Any time.
+        void             SetStudentRateLimit(const StudentRateLimit& limit) { m_StudentInbox.SetLimit(limit); }
+        StudentRateLimit GetStudentRateLimit() const { return m_StudentInbox.GetLimit(); }
 
         NetworkRole GetRole()        const { return m_Role; }
         bool        IsConnected()    const { return m_Connected.load(); }
         uint32_t    GetClientCount() const;
 
+        NetworkStats GetStats() const;
+
+        // Per-student queue metrics and the number of students dropped for
+        // falling more than the max queue depth behind (Host role)
+        std::vector<SessionStats> GetSessionStats() const;
+        uint64_t    GetDroppedClientCount() const { return m_DroppedClients.load(); }
+
+        // Frames a student may have pending before being disconnected
+        void        SetMaxQueueDepth(size_t depth) { m_MaxQueueDepth = depth; }
+
+        // How often the host pings each student (0 = never). Takes effect
+        // for students connecting afterwards.
+        void        SetPingInterval(uint32_t ms) { m_PingIntervalMs = ms; }
+
+        // Host / relay: hold broadcasts for one tick and send each student
+        // a single frame with everything from that tick (per lane; a
+        // camera moved twice in a tick goes once). 0 = send each message
+        // as it comes (default). Send() then returns only the multicast
+        // bytes; the rest goes out with the tick. Any time.
+        void        SetTickRate(uint32_t hz) { m_TickRate = hz; }
+        uint32_t    GetTickRate() const      { return m_TickRate.load(); }
+
+        // Deflate scene and asset frames (see Compression.h). Host / relay:
+        // for students that ask; client: ask the host. On by default;
+        // takes effect for connections made afterwards.
+        void        SetCompression(bool enabled) { m_Compression = enabled; }
+        bool        GetCompression() const       { return m_Compression.load(); }
+
+        // Client role: RTT reported by the host in its pings, and this
+        // machine's clock offset from the host
+        RoundTripStats GetRoundTrip() const;
+
+        // Format agreed with the host during the handshake (Client role)
+        WireFormat  GetWireFormat()  const { return m_ClientFormat.load(); }
+
+        // ── Asset streaming ───────────────────────────────────────────
+        // Host: offer these files to students. The manifest goes out on
+        // join; chunks a student is missing follow on a low-priority lane
+        // that only writes when no camera / control frame is waiting.
+        void SetAssetStore(std::shared_ptr<const AssetStore> store);
+
+        // Client: chunk cache kept across sessions (call before Connect).
+        // Once every listed file is cached, OnMessage receives the
+        // AssetManifest with a "localPath" on each asset.
+        void SetAssetCacheDir(const std::string& dir) { m_AssetCache.SetRoot(dir); }
+        AssetProgress GetAssetProgress() const;
+
+        // ── Join snapshot ─────────────────────────────────────────────
+        // Host / relay: the latest CameraSync and the scene state carried
+        // by SceneSnapshot / SceneDelta are tracked as they go out. A new
+        // student gets them right after its handshake, led by a SessionInfo
+        // frame and ahead of any later broadcast. Each frame is encoded at
+        // most once per change, however many students join.
+        // Client: ms from Connect() until that burst has arrived (0 = not yet)
+        float GetJoinLatencyMs() const { return m_JoinLatencyMs.load(); }
+
+        // ── Multicast (same-LAN classrooms) ───────────────────────────
+        // Host / relay: CameraSync and NodeSelect also go to a UDP multicast
+        // group, one datagram each however many students listen. SessionInfo
+        // advertises the group; a student that hears it says so over its
+        // WebSocket and stops getting those frames unicast, and NACKs any
+        // gap for the host to repair over the WebSocket. Call before StartHost.
+        void SetMulticast(const MulticastConfig& config) { m_MulticastConfig = config; }
+
+        // Client: join a group the host advertises (default on; call
+        // before Connect). Multicast frames reach OnMessage from the
+        // listener's own thread.
+        void SetAcceptMulticast(bool accept) { m_AcceptMulticast = accept; }
+
+        MulticastStats GetMulticastStats() const;
+
+        // ── Metrics (lab monitoring) ──────────────────────────────────
+        // Host / relay: serve GET /metrics in the Prometheus text format on
+        // its own plain-HTTP port (0 = off, the default), so it can be
+        // firewalled apart from the students' port. Call before StartHost.
+        // Clients, bytes in / out, per-lane queue depth, queue-to-wire
+        // latency per lane, frame time and dropped students; all of them
+        // atomics, so recording never waits on a scrape or on another
+        // thread.
+        void     SetMetricsPort(uint16_t port) { m_MetricsPort = port; }
+        uint16_t GetMetricsPort() const        { return m_MetricsPort; }
+
+        // Render thread: how long the last frame took
+        void RecordFrameTime(float seconds);
+
+        // What /metrics serves. Any thread.
+        std::string GetMetricsText() const;
+
+        // ── Recording ─────────────────────────────────────────────────
+        // Host / relay / publisher: every message sent from now on is also
+        // handed to the recorder (nullptr stops). Any thread.
+        void SetRecorder(std::shared_ptr<SessionRecorder> recorder);
+
         // ── Callbacks (call before Start/Connect) ─────────────────────
         void SetOnMessage(OnMessageCallback cb)    { m_OnMessage    = std::move(cb); }
         void SetOnConnect(OnConnectCallback cb)    { m_OnConnect    = std::move(cb); }
@@ -87,30 +329,186 @@ namespace Atometa {
 
     private:
         // ── Server internals ──────────────────────────────────────────
-        void RunIOContext();
         void DoAccept();
+        void OpenMetrics();
+        void DoAcceptMetrics();
 
         struct WsSession;
-        void BroadcastRaw(const std::string& text);
+        struct RttWindow;
+        struct AssetOffer;
+        struct JoinState;
+        struct MulticastChannel;
+        struct MulticastListener;
+        struct TickBatch;
+        struct MetricsSession;
+        struct ClientLink;
+        using SessionList = std::vector<std::shared_ptr<WsSession>>;
+        using ShardList   = std::vector<std::shared_ptr<const SessionList>>;
+
+        size_t Broadcast(const NetMessage& msg);
+        void AddSession(const std::shared_ptr<WsSession>& session);
         void RemoveSession(WsSession* session);
+        void StoreSessions(std::shared_ptr<SessionList> sessions);
+        void SetUpstream(const std::shared_ptr<WsSession>& session);
+        void ClearUpstream(WsSession* session);
+        bool OpenListener(uint16_t port);
+        void CloseListener();
+        void ShutdownPool();
+        void ReleasePool();
+        void StartMulticast();
+        void FlushTick();
+        void QueueStudentMessage(const WsSession& from, NetMessage&& msg);
+        void DrainStudents();
+        void DeliverStudentMessage(const NetMessage& msg);
+        std::shared_ptr<const TreeAddress> PickRedirect() const;
+        uint32_t TreeSubtree() const;
 
         // ── Client internals ──────────────────────────────────────────
-        void RunClient(const std::string& host, uint16_t port);
-        void ClientReadLoop(beast::websocket::stream<tcp::socket>& ws);
+        void ResetClientState();
+        void TrackJoin(const NetMessage& msg);
+        bool DispatchClient(NetMessage& msg, ClientLink& link);
+        std::string ClientTarget() const;
+        bool HandleClientAssets(const NetMessage& msg, ClientLink& link);
+        void FinishAssets();
+        void UpdateMulticast(const NetMessage& info, ClientLink& link);
+        void FlushMulticastControl(ClientLink& link);
+        void UpdateTree(const NetMessage& info);
+        bool HandleTreeControl(const NetMessage& msg);
+        void FlushTreeControl(ClientLink& link);
+        size_t QueueUplink(const NetMessage& msg);
+        void FlushUplink(ClientLink& link);
+        void ForwardToChildren(const NetMessage& msg);
 
     private:
-        NetworkRole          m_Role      = NetworkRole::None;
+        // Written by the UI thread, read by io threads still winding down
+        // after Disconnect() (a relaying student's own students, say)
+        std::atomic<NetworkRole> m_Role  = NetworkRole::None;
         std::atomic<bool>    m_Connected = false;
         std::atomic<bool>    m_Running   = false;
+        std::atomic<WireFormat> m_ClientFormat = WireFormat::Json;
 
-        // Boost.Asio
-        asio::io_context     m_IOContext;
-        std::thread          m_IOThread;
+        // Boost.Asio — host sessions and the client connection all live
+        // on the pool. Contexts are made fresh by every Start().
+        IOContextPool        m_IOPool;
+
+        // Client: the connection to the host (atomic shared_ptr access)
+        std::shared_ptr<ClientLink> m_Client;
 
         // Server state
         std::unique_ptr<tcp::acceptor>  m_Acceptor;
-        std::vector<std::shared_ptr<WsSession>> m_Sessions;
+        // Copy-on-write: readers take an atomic snapshot, writers (accept /
+        // remove) build a new list under m_SessionMutex and swap it in
+        std::shared_ptr<const SessionList> m_Sessions;
+        std::shared_ptr<const ShardList>   m_Shards;   // m_Sessions by io thread
         std::mutex                      m_SessionMutex;
+        std::atomic<size_t>             m_MaxQueueDepth  = 64;
+        std::atomic<uint32_t>           m_PingIntervalMs = 1000;
+        std::atomic<uint32_t>           m_ClientCount    = 0;   // size of m_Sessions
+
+        // Prometheus endpoint (host / relay)
+        std::unique_ptr<tcp::acceptor>  m_MetricsAcceptor;
+        uint16_t                        m_MetricsPort = 0;
+
+        // Broadcasts waiting for the next tick (atomic shared_ptr access)
+        std::shared_ptr<TickBatch>      m_Tick;
+        std::atomic<uint32_t>           m_TickRate = 0;
+        std::atomic<bool>               m_Compression = true;
+
+        // Messages from students, waiting for the dispatcher on pool
+        // context 0 (scheduled while m_InboxDraining is set)
+        StudentInbox                    m_StudentInbox;
+        std::atomic<bool>               m_InboxDraining = false;
+        std::atomic<uint64_t>           m_NextSessionId = 1;
+
+        // Client: frames for the host, written by the io thread
+        std::mutex                      m_UplinkMutex;
+        std::vector<std::string>        m_Uplink;
+        std::atomic<uint64_t>           m_UplinkDropped = 0;
+
+        // Client-side view of the host's probes
+        std::unique_ptr<RttWindow>      m_ClientRtt;
+
+        // Assets offered by the host (atomic shared_ptr access)
+        std::shared_ptr<const AssetOffer> m_AssetOffer;
+
+        // State a joining student starts from (host / relay)
+        std::unique_ptr<JoinState>      m_Join;
+
+        // Multicast: the host's sending side and the student's group
+        // listener (atomic shared_ptr access)
+        MulticastConfig                    m_MulticastConfig;
+        std::shared_ptr<MulticastChannel>  m_McChannel;
+        std::shared_ptr<MulticastListener> m_McListener;
+        std::atomic<bool>                  m_AcceptMulticast = true;
+        bool                               m_McSubscribed    = false;   // client io thread only
+
+        // Relay tree. m_TreeUp lists the ancestors of the node the client
+        // dials, root first; a redirect pushes the redirecting node, a
+        // climb pops one (client io thread only, like the other m_Tree* that
+        // are not atomic).
+        uint16_t                        m_TreePort = 0;
+        std::string                     m_TreeAdvertise;
+        std::atomic<uint32_t>           m_TreeFanout    = 0;
+        std::atomic<bool>               m_TreeListening = false;
+        std::vector<TreeAddress>        m_TreeUp;
+        TreeAddress                     m_TreeUpstream;   // the node we dial now
+        std::unique_ptr<TreeAddress>    m_TreeRedirect;
+        json                            m_TreeReported;
+        std::atomic<uint32_t>           m_TreeDepth     = 0;
+        std::atomic<uint32_t>           m_TreeRepairs   = 0;
+        std::atomic<uint64_t>           m_TreeRedirects = 0;
+        std::atomic<uint32_t>           m_TreeParentLatencyUs = 0;
+
+        // Session log of outgoing messages (atomic shared_ptr access)
+        std::shared_ptr<SessionRecorder> m_Recorder;
+
+        // Client: join burst still expected, and how long it took
+        uint64_t                        m_JoinStartUs = 0;
+        int                             m_JoinPending = -1;   // -1 = no SessionInfo yet, -2 = done
+        std::atomic<float>              m_JoinLatencyMs = 0.f;
+
+        // Client: where to resume after a drop (client io thread only)
+        std::string                     m_ResumeToken;
+        uint32_t                        m_ResumeSeq    = 0;
+        bool                            m_Reconnecting = false;
+        bool                            m_JoinResumed  = false;
+        std::atomic<uint32_t>           m_ReconnectMinMs = 250;
+        std::atomic<uint32_t>           m_ReconnectMaxMs = 8000;
+        mutable std::mutex              m_ReconnectStatsMutex;
+        ReconnectStats                  m_ReconnectStats;
+
+        // Client download state (client io thread only, except counters)
+        AssetCache                      m_AssetCache;
+        std::vector<AssetInfo>          m_PendingAssets;
+        std::unordered_set<std::string> m_MissingChunks;
+        std::atomic<uint32_t>           m_AssetChunksTotal    = 0;
+        std::atomic<uint32_t>           m_AssetChunksReceived = 0;
+        std::atomic<uint64_t>           m_AssetBytesReceived  = 0;
+
+        // Relay / publisher upstream link (atomic shared_ptr access)
+        std::shared_ptr<WsSession>      m_Upstream;
+        bool                            m_RelayMode = false;
+        std::string                     m_PublishKey;
+
+        // Counters
+        std::atomic<uint64_t> m_MessagesSent     = 0;
+        std::atomic<uint64_t> m_BytesSent        = 0;
+        std::atomic<uint64_t> m_MessagesReceived = 0;
+        std::atomic<uint64_t> m_BytesReceived    = 0;
+        std::atomic<uint64_t> m_MessagesRelayed  = 0;
+        std::atomic<uint64_t> m_DroppedClients   = 0;
+        std::atomic<uint64_t> m_JoinSnapshots    = 0;
+        std::atomic<uint64_t> m_ResumedJoins     = 0;
+        std::atomic<uint64_t> m_Batches          = 0;
+        std::atomic<uint64_t> m_BatchedMessages  = 0;
+        std::atomic<uint64_t> m_CompressedIn     = 0;
+        std::atomic<uint64_t> m_CompressedOut    = 0;
+
+        // Exported by /metrics: frames queued per lane, all sessions, and
+        // how long they waited for the wire
+        std::array<std::atomic<int64_t>, kLaneCount> m_LaneQueued = {};
+        std::array<LatencyHistogram, kLaneCount>     m_SendLatency;
+        LatencyHistogram                             m_FrameTime;
 
         // Callbacks
         OnMessageCallback    m_OnMessage;
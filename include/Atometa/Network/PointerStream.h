@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+#include "Atometa/Network/TokenBucket.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+
+namespace Atometa {
+
+    struct PointerStreamSettings {
+        float  TickHz           = 30.0f;   // Pointer messages per second at most
+        float  BudgetBytes      = 2048.f;  // per student per second, framing included
+        float  MinMove          = 0.001f;  // smaller moves are not new samples (world units)
+        float  KeyframeInterval = 0.5f;    // resend a resting pointer this often (s)
+        size_t Capacity         = 256;     // samples held between ticks
+    };
+
+    struct PointerStreamStats {
+        uint64_t SamplesOffered = 0;   // AddSample calls
+        uint64_t SamplesSent    = 0;
+        uint64_t SamplesDropped = 0;   // thinned out to stay in budget, or over Capacity
+        uint64_t MessagesSent   = 0;
+        uint64_t BytesSent      = 0;   // per student, as counted against the budget
+    };
+
+    // ── PointerStream ─────────────────────────────────────────────────────
+    // Host side of the laser pointer. Samples come in at input rate and
+    // leave once per tick as one Pointer message, delta-coded against the
+    // previous sample (see NetProtocol.h). A token bucket holds every
+    // student's share of the stream to BudgetBytes a second: when a tick
+    // has more samples than it can pay for, they are thinned evenly and
+    // the newest is always kept, so a fast sweep loses detail, never
+    // currency.
+    // Usage (render thread):
+    //   per input event: stream.AddSample(now, position);   // or Hide(now)
+    //   per frame:       if (stream.Update(now, msg)) network.Send(msg);
+    // ─────────────────────────────────────────────────────────────────────
+    class PointerStream {
+    public:
+        explicit PointerStream(const PointerStreamSettings& settings = {});
+
+        // now: monotonic seconds
+        void AddSample(double now, const std::array<float, 3>& position);
+        void Hide(double now);
+
+        // Returns true with a stamped Pointer message in out when one is due
+        bool Update(double now, NetMessage& out);
+
+        // Next Update repeats a visible pointer, whatever the timers say
+        // (e.g. when a new session starts)
+        void Reset();
+
+        bool IsVisible() const { return m_Visible; }
+
+        // Bytes a Pointer message of that many samples costs a binary
+        // student, WebSocket framing included
+        static size_t WireCost(size_t samples);
+
+        PointerStreamSettings&       GetSettings()       { return m_Settings; }
+        const PointerStreamSettings& GetSettings() const { return m_Settings; }
+        const PointerStreamStats&    GetStats()    const { return m_Stats; }
+
+    private:
+        struct Sample {
+            uint64_t             TimeUs   = 0;
+            std::array<float, 3> Position = { 0.f, 0.f, 0.f };
+        };
+
+        double Burst() const;
+
+    private:
+        PointerStreamSettings m_Settings;
+        PointerStreamStats    m_Stats;
+        TokenBucket           m_Budget;
+
+        std::deque<Sample> m_Pending;
+        Sample             m_Last;           // newest sample taken, sent or not
+        bool               m_HasLast  = false;
+        bool               m_Visible  = false;
+        bool               m_Changed  = false;   // shown / hidden since the last message
+        double             m_LastSend = 0.0;
+        bool               m_HasSent  = false;
+        uint32_t           m_Sequence = 0;
+    };
+
+    struct PointerTrackSettings {
+        float  MinDelay  = 0.05f;   // playout delay bounds (s)
+        float  MaxDelay  = 0.25f;
+        float  HideAfter = 2.0f;    // hide when nothing arrived for this long (s)
+        size_t Capacity  = 512;     // samples kept ahead of the playout point
+    };
+
+    struct PointerTrackStats {
+        uint64_t Received = 0;   // messages
+        uint64_t Lost     = 0;   // sequence gaps
+        uint64_t Late     = 0;   // duplicates / arrived after a newer message
+        uint64_t Samples  = 0;
+        float    Delay    = 0.f; // current playout delay (s)
+        float    Jitter   = 0.f; // interarrival jitter estimate (s)
+    };
+
+    // ── PointerTrack ──────────────────────────────────────────────────────
+    // Student side of the Pointer stream. Like CameraJitterBuffer, samples
+    // are played out an adaptive delay behind the host clock and
+    // interpolated between; unlike the camera nothing is extrapolated, so
+    // the pointer never overshoots what the professor pointed at.
+    // Usage (render thread):
+    //   on message: track.Push(msg, now);
+    //   per frame:  if (track.Sample(now, position)) DrawPointer(position);
+    // ─────────────────────────────────────────────────────────────────────
+    class PointerTrack {
+    public:
+        explicit PointerTrack(const PointerTrackSettings& settings = {});
+
+        // localTime: receiver clock at arrival (s)
+        void Push(const NetMessage& msg, double localTime);
+
+        // Pointer position at localTime; false while it is hidden
+        bool Sample(double localTime, std::array<float, 3>& out);
+
+        void Reset();
+
+        PointerTrackSettings&       GetSettings()       { return m_Settings; }
+        const PointerTrackSettings& GetSettings() const { return m_Settings; }
+        const PointerTrackStats&    GetStats()    const { return m_Stats; }
+
+    private:
+        struct Entry {
+            double               HostTime = 0.0;
+            std::array<float, 3> Position = { 0.f, 0.f, 0.f };
+            bool                 Visible  = false;
+        };
+
+        float PlayoutDelay() const;
+
+    private:
+        PointerTrackSettings m_Settings;
+        PointerTrackStats    m_Stats;
+
+        std::deque<Entry> m_Entries;     // ascending HostTime
+        Entry             m_Previous;    // last entry dropped behind the playout point
+        bool              m_HasPrevious = false;
+
+        double   m_Offset      = 0.0;    // min(localTime - hostTime)
+        double   m_LastTransit = 0.0;
+        double   m_Interval    = 0.0;    // smoothed host message interval
+        double   m_LastHost    = 0.0;
+        double   m_LastArrival = 0.0;
+        uint32_t m_LastSeq     = 0;
+    };
+
+} // namespace Atometa
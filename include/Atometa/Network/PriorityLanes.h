@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Atometa {
+
+    // Encoded frame shared by every recipient of a broadcast. Immutable once
+    // built, so sessions can write from it without copying.
+    using SharedPayload = std::shared_ptr<const std::string>;
+
+    // ── Send lanes ───────────────────────────────────────────────────────
+    //   Realtime  camera, pointer, selection, probes — strict priority, latest wins
+    //   Control   join info, scene, chat, control — weighted share
+    //   Bulk      asset chunks — weighted share, whatever is left
+    // A binary frame larger than kMaxFragment goes out as Fragment messages,
+    // so a realtime frame waits at most one fragment behind a large one.
+    enum class Lane : uint8_t {
+        Realtime = 0,
+        Control  = 1,
+        Bulk     = 2,
+    };
+    constexpr size_t kLaneCount = 3;
+
+    Lane        LaneFor(NetMsgType type);
+    const char* LaneName(Lane lane);
+
+    constexpr size_t kMaxFragment = 16 * 1024;
+
+    // Deficit round-robin weights: per turn a lane may send weight ×
+    // fragment size bytes
+    struct LaneWeights {
+        uint32_t Control = 4;
+        uint32_t Bulk    = 1;
+    };
+
+    // ── Per-lane send metrics ────────────────────────────────────────────
+    // Latency runs from queuing a message until its last byte was written,
+    // over the last LaneScheduler::kWindow messages of the lane.
+    struct LaneStats {
+        uint64_t Messages  = 0;
+        uint64_t Bytes     = 0;
+        uint64_t Fragments = 0;
+        uint32_t Queued    = 0;
+        float    P50Ms     = 0.f;
+        float    P99Ms     = 0.f;
+        float    MaxMs     = 0.f;
+    };
+
+    // One write: a whole frame, or a Fragment header plus a slice of it
+    struct LaneSlice {
+        SharedPayload Payload;
+        std::string   Header;          // empty unless a fragment
+        size_t        Offset     = 0;
+        size_t        Size       = 0;
+        Lane          From       = Lane::Control;
+        NetMsgType    Type       = NetMsgType::ChatMessage;
+        bool          Last       = true;   // completes the message
+        uint64_t      EnqueuedUs = 0;
+
+        bool IsFragment() const { return !Header.empty(); }
+    };
+
+    // ── LaneScheduler ────────────────────────────────────────────────────
+    // Orders one connection's outgoing frames. Push / Next / Done belong to
+    // the connection's io thread; GetStats may be called from anywhere.
+    // ─────────────────────────────────────────────────────────────────────
+    class LaneScheduler {
+    public:
+        static constexpr size_t kWindow = 256;
+
+        enum class PushResult { Queued, Coalesced };
+
+        explicit LaneScheduler(LaneWeights weights = {}, size_t maxFragment = kMaxFragment);
+
+        // Binary connections only: a JSON frame cannot be sliced
+        void SetFragmenting(bool fragmenting) { m_Fragmenting = fragmenting; }
+        bool IsFragmenting() const { return m_Fragmenting; }
+
+        // Queues on LaneFor(type), or on an explicit lane to keep a frame in
+        // order with others. A CameraSync replaces one still waiting there
+        // instead of queuing behind it.
+        PushResult Push(SharedPayload payload, NetMsgType type, uint64_t nowUs)
+        {
+            return Push(std::move(payload), type, LaneFor(type), nowUs);
+        }
+        PushResult Push(SharedPayload payload, NetMsgType type, Lane lane, uint64_t nowUs);
+
+        // Takes the next slice to write; false if every lane is empty
+        bool Next(LaneSlice& out);
+
+        // The slice's write completed
+        void Done(const LaneSlice& slice, uint64_t nowUs);
+
+        // Realtime + control messages waiting (the bulk lane refills on demand)
+        size_t Pending() const;
+        // Messages waiting on one lane, a partly sent one included
+        size_t Pending(Lane lane) const { return m_Lanes[static_cast<size_t>(lane)].size(); }
+        bool   IsEmpty(Lane lane) const { return m_Lanes[static_cast<size_t>(lane)].empty(); }
+        bool   IsEmpty() const;
+
+        void Clear();
+
+        std::array<LaneStats, kLaneCount> GetStats() const;
+
+    private:
+        struct Entry {
+            SharedPayload Payload;
+            NetMsgType    Type;
+            uint64_t      EnqueuedUs = 0;
+            size_t        Sent       = 0;   // bytes already taken as fragments
+            uint32_t      Id         = 0;
+        };
+
+        struct History {
+            std::array<uint32_t, kWindow> LatencyUs{};
+            size_t                        Count = 0;
+            size_t                        Next  = 0;
+        };
+
+        size_t SliceSize(const Entry& entry) const;
+        Lane   PickWeighted();
+        void   Take(Lane lane, LaneSlice& out);
+
+    private:
+        LaneWeights                               m_Weights;
+        size_t                                    m_MaxFragment;
+        bool                                      m_Fragmenting = false;
+        std::array<std::deque<Entry>, kLaneCount> m_Lanes;
+        std::array<uint64_t, kLaneCount>          m_Deficit{};
+        Lane                                      m_Turn   = Lane::Control;
+        bool                                      m_Fresh  = true;   // m_Turn not yet credited
+        uint32_t                                  m_NextId = 0;
+
+        mutable std::mutex                        m_StatsMutex;
+        std::array<LaneStats, kLaneCount>         m_Stats;
+        std::array<History, kLaneCount>           m_History;
+    };
+
+    // ── FragmentAssembler ────────────────────────────────────────────────
+    // Rebuilds frames from Fragment messages. A sender writes the slices
+    // of one frame in order, so each frame is appended to as it arrives;
+    // anything out of place is dropped.
+    // ─────────────────────────────────────────────────────────────────────
+    class FragmentAssembler {
+    public:
+        static constexpr size_t   kMaxOpen  = 8;
+        static constexpr uint32_t kMaxFrame = 64u << 20;
+
+        enum class Result { Partial, Complete, Invalid };
+
+        // On Complete, frame holds the reassembled wire frame
+        Result Add(const NetMessage& fragment, std::string& frame);
+
+        size_t GetOpen() const { return m_Open.size(); }
+        void   Reset() { m_Open.clear(); }
+
+    private:
+        struct Partial {
+            uint32_t    Id    = 0;
+            uint32_t    Total = 0;
+            std::string Data;
+        };
+
+        std::vector<Partial> m_Open;
+    };
+
+} // namespace Atometa
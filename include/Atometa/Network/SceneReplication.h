@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Atometa {
+
+    struct SceneReplicatorStats {
+        uint64_t DeltasBuilt    = 0;
+        uint64_t NodesSent      = 0;   // node updates across all deltas
+        uint64_t FieldsSent     = 0;   // individual fields across all deltas
+        uint64_t SnapshotsBuilt = 0;
+    };
+
+    // ── SceneReplicator (host) ────────────────────────────────────────────
+    // Keeps the last replicated state of every model with per-field dirty
+    // bits. Feed it the scene each frame; whenever something changed,
+    // BuildDelta() emits only the changed fields under the next sequence
+    // number and BuildSnapshot() the full state late joiners start from.
+    // Usage:
+    //   replicator.SetNodeCount(scene.GetModelCount());
+    //   for (i ...) replicator.SetNode(i, ToNetNode(scene.GetModel(i)));
+    //   replicator.SetSelection(selected);
+    //   if (replicator.BuildDelta(delta))
+    //       network.Send(delta);   // also kept for late joiners
+    // ─────────────────────────────────────────────────────────────────────
+    class SceneReplicator {
+    public:
+        // Models beyond count are dropped; new ones start fully dirty
+        void SetNodeCount(size_t count);
+
+        // Marks the fields of state that differ from the replicated copy.
+        // state.Index and state.Fields are ignored.
+        void SetNode(size_t index, const NetNode& state);
+
+        void SetSelection(int32_t index);
+
+        bool HasChanges() const;
+
+        // SceneDelta holding every dirty field; clears the dirty bits.
+        // Returns false (and leaves out alone) if nothing changed.
+        bool BuildDelta(NetMessage& out);
+
+        // SceneSnapshot of the whole scene as of the last delta built
+        NetMessage BuildSnapshot();
+
+        uint32_t GetSequence() const { return m_Sequence; }
+        const SceneReplicatorStats& GetStats() const { return m_Stats; }
+
+        // Forgets everything (new session); the next delta restarts at 1
+        void Reset();
+
+    private:
+        std::vector<NetNode> m_Nodes;          // NetNode::Fields = dirty bits
+        int32_t              m_Selection      = -1;
+        bool                 m_SelectionDirty = true;   // first delta is a full baseline
+        bool                 m_CountDirty     = true;
+        uint32_t             m_Sequence       = 0;
+
+        SceneReplicatorStats m_Stats;
+    };
+
+    struct SceneMirrorStats {
+        uint64_t Snapshots = 0;
+        uint64_t Deltas    = 0;   // applied
+        uint64_t Stale     = 0;   // already covered by the snapshot, or early
+        uint64_t Gaps      = 0;   // deltas missing between two applied ones
+    };
+
+    // ── SceneMirror (student) ─────────────────────────────────────────────
+    // The student's copy of the replicated state. A snapshot replaces it;
+    // deltas merge their fields on top. Deltas the snapshot already covers
+    // (sequence ≤ snapshot's) are skipped, so the host may send a snapshot
+    // and keep broadcasting deltas without coordinating the two.
+    // ─────────────────────────────────────────────────────────────────────
+    class SceneMirror {
+    public:
+        // Returns true if msg was a SceneSnapshot / SceneDelta that changed
+        // the mirrored state
+        bool Apply(const NetMessage& msg);
+
+        // Nothing can be applied before the first snapshot (or the host's
+        // very first delta, which carries every field)
+        bool HasState() const { return m_HasState; }
+
+        const std::vector<NetNode>& GetNodes()     const { return m_Nodes; }
+        int32_t                     GetSelection() const { return m_Selection; }
+        uint32_t                    GetSequence()  const { return m_Sequence; }
+        const SceneMirrorStats&     GetStats()     const { return m_Stats; }
+
+        // Full state as a SceneSnapshot (e.g. for a relay's late joiners)
+        NetMessage ToSnapshot() const;
+
+        void Reset();
+
+    private:
+        std::vector<NetNode> m_Nodes;          // NetNode::Fields = kNodeFieldAll
+        int32_t              m_Selection = -1;
+        uint32_t             m_Sequence  = 0;
+        bool                 m_HasState  = false;
+
+        SceneMirrorStats m_Stats;
+    };
+
+} // namespace Atometa
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+#include "Atometa/Network/SceneReplication.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Atometa {
+
+    // ── Recording file (.atrec) ──────────────────────────────────────────
+    // Append-only, little-endian, varints (LEB128) where marked:
+    //   header   "ATRC" | u16 version | u16 reserved | u64 start (unix µs)
+    //   record   u8 kind | varint Δt µs since previous record
+    //            | varint length | payload
+    //     kRecordMessage   payload = one NetMessage in the binary wire format
+    //     kRecordKeyframe  payload = varint count, then count × (varint
+    //                      length | NetMessage): the SceneSnapshot and
+    //                      CameraSync a viewer needs to start from here
+    //     kRecordIndex     payload = varint duration µs, varint count, then
+    //                      count × (varint time µs | varint file offset)
+    //   trailer  u64 offset of the index record | "ATRI"
+    // Index and trailer are written on Stop(). A file cut short by a crash
+    // has neither; the player then rebuilds the index by scanning.
+    constexpr char     kRecordingMagic[4]      = { 'A', 'T', 'R', 'C' };
+    constexpr char     kRecordingIndexMagic[4] = { 'A', 'T', 'R', 'I' };
+    constexpr uint16_t kRecordingVersion       = 1;
+    constexpr size_t   kRecordingHeaderSize    = 16;
+    constexpr size_t   kRecordingTrailerSize   = 12;
+
+    constexpr uint8_t kRecordMessage  = 1;
+    constexpr uint8_t kRecordKeyframe = 2;
+    constexpr uint8_t kRecordIndex    = 3;
+
+    struct RecordingKeyframe {
+        uint64_t TimeUs = 0;   // since the start of the recording
+        uint64_t Offset = 0;   // of the kRecordKeyframe record
+    };
+
+    struct RecorderSettings {
+        double KeyframeInterval = 10.0;   // seconds between keyframes
+        double FlushInterval    = 0.25;   // longest a record waits in memory
+        size_t MaxPending       = 8192;   // queued messages before drops
+    };
+
+    struct RecorderStats {
+        uint64_t Messages  = 0;   // written to the file
+        uint64_t Keyframes = 0;
+        uint64_t Bytes     = 0;   // file size so far
+        uint64_t Dropped   = 0;   // writer fell MaxPending behind
+    };
+
+    // ── SessionRecorder (host) ────────────────────────────────────────────
+    // Logs every outgoing NetMessage with its time. Record() only copies the
+    // message into a pending list; a writer thread encodes it, tracks the
+    // camera and scene state for keyframes and flushes to disk in batches,
+    // so recording costs the render thread one short lock per message.
+    // Usage:
+    //   auto recorder = std::make_shared<SessionRecorder>();
+    //   recorder->Start("recordings/anatomy.atrec");
+    //   network.SetRecorder(recorder);      // records every Send()
+    //   ...
+    //   network.SetRecorder(nullptr);
+    //   recorder->Stop();                   // writes the keyframe index
+    // ─────────────────────────────────────────────────────────────────────
+    class SessionRecorder {
+    public:
+        explicit SessionRecorder(RecorderSettings settings = {});
+        ~SessionRecorder();
+
+        SessionRecorder(const SessionRecorder&)            = delete;
+        SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+        // Creates (truncates) the file and starts the writer thread
+        bool Start(const std::string& path);
+
+        // Drains pending messages, appends the index and closes the file
+        void Stop();
+
+        bool IsRecording() const { return m_Recording.load(); }
+        const std::string& GetPath() const { return m_Path; }
+
+        // Any thread. Stamped with the time since Start().
+        void Record(const NetMessage& msg);
+
+        // Any thread, explicit time since Start() (µs). Times must not go
+        // backwards; earlier ones are clamped to the last recorded time.
+        void Record(const NetMessage& msg, uint64_t timeUs);
+
+        double        GetElapsed() const;
+        RecorderStats GetStats() const;
+
+    private:
+        struct Pending {
+            uint64_t   TimeUs = 0;
+            NetMessage Msg;
+        };
+
+        void WriterLoop();
+        void WriteBatch(std::vector<Pending>& batch);
+        void AppendRecord(uint8_t kind, uint64_t timeUs, const std::string& payload);
+        void AppendKeyframe(uint64_t timeUs);
+        void FlushBuffer();
+        void WriteIndex();
+
+    private:
+        RecorderSettings                      m_Settings;
+        std::string                           m_Path;
+        std::atomic<bool>                     m_Recording = false;
+        std::chrono::steady_clock::time_point m_Start;
+
+        // Producer side
+        mutable std::mutex      m_Mutex;
+        std::condition_variable m_Wake;
+        std::vector<Pending>    m_Pending;
+        bool                    m_Stopping = false;
+        uint64_t                m_Dropped  = 0;
+
+        // Writer thread only
+        std::thread                    m_Writer;
+        std::ofstream                  m_File;
+        std::string                    m_Buffer;
+        uint64_t                       m_Offset       = 0;   // file size incl. m_Buffer
+        uint64_t                       m_LastTimeUs   = 0;
+        uint64_t                       m_LastKeyframe = 0;
+        NetMessage                     m_Camera;
+        bool                           m_HasCamera    = false;
+        SceneMirror                    m_Scene;
+        std::vector<RecordingKeyframe> m_Keyframes;
+        RecorderStats                  m_Written;
+
+        // Copy of m_Written published after each batch (under m_Mutex)
+        RecorderStats m_Stats;
+    };
+
+    // ── SessionPlayer (student) ───────────────────────────────────────────
+    // Plays a recording back through the same handlers live messages use.
+    // Seek() jumps to the nearest keyframe at or before the target, hands
+    // over its state, then fast-forwards the few seconds to the target, so
+    // jumping anywhere in an hour-long lecture reads one keyframe interval.
+    // Usage:
+    //   player.Open("recordings/anatomy.atrec");
+    //   player.SetSpeed(4.0);
+    //   player.Seek(12 * 60.0, apply);     // minute 12
+    //   player.Advance(deltaTime, apply);  // per frame
+    // ─────────────────────────────────────────────────────────────────────
+    class SessionPlayer {
+    public:
+        using DeliverFn = std::function<void(const NetMessage&)>;
+
+        static constexpr double kMinSpeed = 1.0;
+        static constexpr double kMaxSpeed = 16.0;
+
+        // Loads the index (or rebuilds it) and rewinds to the start
+        bool Open(const std::string& path);
+        void Close();
+
+        bool IsOpen() const { return m_File.is_open(); }
+
+        double GetDuration() const { return m_DurationUs / 1e6; }
+        double GetPosition() const { return m_PositionUs / 1e6; }
+        bool   AtEnd()       const { return m_AtEnd; }
+
+        // True when the index had to be rebuilt (file was not closed cleanly)
+        bool   WasRecovered() const { return m_Recovered; }
+
+        const std::vector<RecordingKeyframe>& GetKeyframes() const { return m_Keyframes; }
+
+        // Clamped to [kMinSpeed, kMaxSpeed]
+        void   SetSpeed(double speed);
+        double GetSpeed() const { return m_Speed; }
+
+        void SetPaused(bool paused) { m_Paused = paused; }
+        bool IsPaused() const       { return m_Paused; }
+
+        // Delivers the keyframe state, then every message up to seconds.
+        // Returns the number of messages delivered.
+        size_t Seek(double seconds, const DeliverFn& deliver);
+
+        // Moves the playhead by dt × speed (unless paused) and delivers the
+        // messages it passed
+        size_t Advance(double dt, const DeliverFn& deliver);
+
+    private:
+        struct Record {
+            uint8_t     Kind   = 0;
+            uint64_t    TimeUs = 0;
+            std::string Payload;
+        };
+
+        bool   ReadRecord(Record& out);
+        bool   LoadIndex(uint64_t fileSize);
+        void   ScanIndex(uint64_t fileSize);
+        // absolute: timeUs is the time of the record at offset itself
+        // (keyframes), not of the one before it
+        void   SeekFile(uint64_t offset, uint64_t timeUs, bool absolute);
+        size_t PlayUntil(uint64_t timeUs, const DeliverFn& deliver);
+
+    private:
+        std::ifstream                  m_File;
+        std::vector<RecordingKeyframe> m_Keyframes;
+        uint64_t                       m_DurationUs = 0;
+        uint64_t                       m_DataEnd    = 0;   // first byte past the records
+        bool                           m_Recovered  = false;
+
+        // Playhead: m_Next is the first record not yet delivered
+        double   m_PositionUs = 0.0;
+        uint64_t m_CursorUs   = 0;       // time of the last record read
+        bool     m_Rebase     = false;   // next record's time is m_CursorUs
+        Record   m_Next;
+        bool     m_HasNext = false;
+        bool     m_AtEnd   = false;
+
+        double m_Speed  = 1.0;
+        bool   m_Paused = false;
+    };
+
+} // namespace Atometa
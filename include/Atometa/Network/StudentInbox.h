@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Atometa/Core/Core.h"
+#include "Atometa/Network/NetProtocol.h"
+#include "Atometa/Network/TokenBucket.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Atometa {
+
+    // ── Per-student limits on what reaches the host ──────────────────────
+    // Two token buckets per student, refilled continuously: every frame it
+    // sends is charged to the byte bucket before it is decoded, every
+    // message left for the application to the message bucket. Burst is
+    // what a student that has been quiet may send at once. A relay in the
+    // tree speaks for its whole subtree and gets that many shares.
+    struct StudentRateLimit {
+        float    MessagesPerSec = 20.f;
+        uint32_t MessageBurst   = 40;
+        uint32_t BytesPerSec    = 64 * 1024;
+        uint32_t ByteBurst      = 256 * 1024;
+        uint32_t MaxQueued      = 64;   // per share, accepted but not yet handed out
+    };
+
+    struct StudentInboxStats {
+        uint64_t Delivered = 0;   // handed to the application
+        uint64_t Throttled = 0;   // over the rate limit, dropped
+        uint64_t Overflow  = 0;   // queue full, dropped
+        uint32_t Queued    = 0;
+    };
+
+    // ── StudentInbox ─────────────────────────────────────────────────────
+    // Messages from students, one FIFO each, handed out round-robin: a
+    // student with a long queue gets its share per turn like everyone
+    // else, so it cannot push the others back. Admit / Push come from the
+    // io threads, Drain from a single dispatcher. Thread-safe.
+    // ─────────────────────────────────────────────────────────────────────
+    class StudentInbox {
+    public:
+        using SourceId = uint64_t;
+
+        enum class Result { Queued, Throttled, Overflow };
+
+        explicit StudentInbox(const StudentRateLimit& limit = {});
+
+        // Applies to every student from its next message
+        void             SetLimit(const StudentRateLimit& limit);
+        StudentRateLimit GetLimit() const;
+
+        // Charges a received frame to the byte bucket; false = drop it
+        // without decoding
+        bool Admit(SourceId id, size_t bytes, uint64_t nowUs, uint32_t shares = 1);
+
+        // Charges msg to the message bucket and queues it
+        Result Push(SourceId id, NetMessage&& msg, uint64_t nowUs, uint32_t shares = 1);
+
+        // Appends up to max messages to out, each student's share per turn,
+        // resuming with the student after the last one served. Returns the
+        // number appended.
+        size_t Drain(std::vector<NetMessage>& out, size_t max);
+
+        // The student left: its queue is still handed out, then forgotten
+        void Remove(SourceId id);
+        void Clear();
+
+        size_t            GetQueued() const;
+        StudentInboxStats GetStats(SourceId id) const;
+        StudentInboxStats GetTotals() const;   // includes students gone
+
+    private:
+        struct Source {
+            TokenBucket            Messages;
+            TokenBucket            Bytes;
+            std::deque<NetMessage> Queue;
+            uint32_t               Shares  = 1;
+            bool                   Removed = false;
+            StudentInboxStats      Stats;
+        };
+
+    private:
+        mutable std::mutex                   m_Mutex;
+        StudentRateLimit                     m_Limit;
+        std::unordered_map<SourceId, Source> m_Sources;
+        std::deque<SourceId>                 m_Ready;   // non-empty queues, in turn order
+        size_t                               m_Queued = 0;
+        StudentInboxStats                    m_Totals;
+    };
+
+} // namespace Atometa
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Atometa {
+
+    // ── TokenBucket ──────────────────────────────────────────────────────
+    // Refilled continuously at ratePerSec up to burst. Starts full. The
+    // rate comes with every call, so a changed limit applies at once; a
+    // cost above burst never passes.
+    // ─────────────────────────────────────────────────────────────────────
+    class TokenBucket {
+    public:
+        // Tops the bucket up to nowUs and returns what is in it
+        double Refill(double ratePerSec, double burst, uint64_t nowUs)
+        {
+            if (m_Tokens < 0.0) {
+                m_Tokens = burst;
+            } else if (nowUs > m_LastUs) {
+                m_Tokens = std::min(burst, m_Tokens + (nowUs - m_LastUs) * ratePerSec / 1e6);
+            }
+            m_LastUs = std::max(m_LastUs, nowUs);
+            return m_Tokens;
+        }
+
+        bool Take(double cost, double ratePerSec, double burst, uint64_t nowUs)
+        {
+            if (Refill(ratePerSec, burst, nowUs) < cost) return false;
+            m_Tokens -= cost;
+            return true;
+        }
+
+        double GetTokens() const { return m_Tokens; }
+        void   Reset()           { m_Tokens = -1.0; m_LastUs = 0; }
+
+    private:
+        double   m_Tokens = -1.0;   // < 0: not started
+        uint64_t m_LastUs = 0;
+    };
+
+} // namespace Atometa
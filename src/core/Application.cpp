@@ -4,15 +4,29 @@
 #include "Atometa/Renderer/Renderer.h"
 #include "Atometa/Renderer/Shader.h"
 #include "Atometa/Renderer/Camera.h"
+#include "Atometa/Renderer/Mesh.h"
 #include "Atometa/Scene/Scene.h"
 #include "Atometa/UI/ImGuiLayer.h"
 #include "Atometa/Network/NetworkLayer.h"
+#include "Atometa/Network/CameraSyncPolicy.h"
+#include "Atometa/Network/InboundQueue.h"
+#include "Atometa/Network/CameraJitterBuffer.h"
+#include "Atometa/Network/PointerStream.h"
+#include "Atometa/Network/SceneReplication.h"
+#include "Atometa/Network/SessionRecorder.h"
 
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
 #include <imgui.h>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+
 namespace Atometa
 {
     Application* Application::s_Instance = nullptr;
@@ -45,25 +59,32 @@ namespace Atometa
         );
         m_Camera = CreateScope<Camera>(45.0f, m_Window->GetAspectRatio());
 
-        m_Scene   = CreateScope<Scene>();
-        m_Network = CreateScope<NetworkLayer>();
+        m_Scene      = CreateScope<Scene>();
+        m_Inbound    = CreateScope<InboundQueue>();
+        m_Network    = CreateScope<NetworkLayer>();
+        m_CameraSync = CreateScope<CameraSyncPolicy>();
+        m_CameraJitter = CreateScope<CameraJitterBuffer>();
+        m_PointerStream   = CreateScope<PointerStream>();
+        m_PointerTrack    = CreateScope<PointerTrack>();
+        m_PointerMesh     = CreateScope<Mesh>(Mesh::CreateSphere(1.0f, 16, 8));
+        m_SceneReplicator = CreateScope<SceneReplicator>();
+        m_SceneMirror     = CreateScope<SceneMirror>();
+        m_Recorder        = CreateRef<SessionRecorder>();
+        m_Player          = CreateScope<SessionPlayer>();
 
         if (m_Scene->LoadModel("assets/models/heart.glb", "Heart") < 0)
             ATOMETA_WARN("Heart model not found — showing placeholder sphere");
 
-        // Camera sync from host
+        // Runs on an io thread: only hand the message over, it is applied
+        // on the render thread in ProcessNetworkMessages()
         m_Network->SetOnMessage([this](const NetMessage& msg) {
-            if (msg.Type == NetMsgType::CameraSync) {
-                float yaw   = msg.Data.value("yaw",   0.f);
-                float pitch = msg.Data.value("pitch", 0.f);
-                float dist  = msg.Data.value("dist",  10.f);
-                m_Camera->SetFromNetwork(yaw, pitch, dist);
-            }
+            m_Inbound->Push(msg);
         });
     }
 
     Application::~Application()
     {
+        StopRecording();
         m_ImGuiLayer->OnDetach();
         Renderer::Shutdown();
         Logger::Shutdown();
@@ -89,6 +110,7 @@ namespace Atometa
             float time      = static_cast<float>(glfwGetTime());
             float deltaTime = time - m_LastFrameTime;
             m_LastFrameTime = time;
+            m_Network->RecordFrameTime(deltaTime);
 
             bool overUI = ImGui::GetIO().WantCaptureMouse;
 
@@ -122,11 +144,16 @@ namespace Atometa
             else { firstRight = true; }
 
             // ── Update & render ───────────────────────────────────────────
+            ProcessNetworkMessages();
+            PlayRecording(deltaTime);
             m_Scene->Update(deltaTime);
             BroadcastCamera();
+            BroadcastPointer();
+            ReplicateScene();
 
             Renderer::Clear(glm::vec4(0.08f, 0.08f, 0.10f, 1.0f));
             m_Scene->Render(*m_Shader, *m_Camera);
+            RenderPointer();
 
             // ── UI ────────────────────────────────────────────────────────
             m_ImGuiLayer->Begin();
@@ -139,17 +166,289 @@ namespace Atometa
         ATOMETA_INFO("Application shutdown");
     }
 
+    void Application::ProcessNetworkMessages()
+    {
+        double now = glfwGetTime();
+
+        // Every stamped camera sample feeds the jitter buffer, so camera
+        // updates are not collapsed here
+        bool sceneChanged = false;
+        m_Inbound->Drain([this, now, &sceneChanged](const NetMessage& msg) {
+            if (msg.Type == NetMsgType::AssetManifest) {
+                LoadStreamedAssets(msg);
+                sceneChanged = true;   // newly loaded models pick up their state
+                return;
+            }
+            if (msg.Type == NetMsgType::SceneSnapshot || msg.Type == NetMsgType::SceneDelta) {
+                sceneChanged |= m_SceneMirror->Apply(msg);
+                return;
+            }
+            if (msg.Type == NetMsgType::Pointer) {
+                m_PointerTrack->Push(msg, now);
+                return;
+            }
+            if (msg.Type != NetMsgType::CameraSync) return;
+
+            if (msg.IsStamped()) {
+                m_CameraJitter->Push(msg.Sequence, msg.Timestamp * 1e-6, now, msg.Camera);
+            } else {
+                // Host without timestamps: snap as before
+                m_Camera->SetFromNetwork(msg.Camera.Yaw, msg.Camera.Pitch,
+                                         msg.Camera.Distance);
+            }
+        }, false);
+
+        NetCamera camera;
+        if (m_CameraJitter->Sample(now, camera))
+            m_Camera->SetFromNetwork(camera.Yaw, camera.Pitch, camera.Distance);
+
+        // A replay drives the pointer itself (ApplyRecordedMessage)
+        std::array<float, 3> pointer;
+        if (m_Network->GetRole() == NetworkRole::Client) {
+            m_PointerVisible = m_PointerTrack->Sample(now, pointer);
+            if (m_PointerVisible)
+                m_PointerPosition = { pointer[0], pointer[1], pointer[2] };
+        }
+
+        if (sceneChanged)
+            ApplyReplicatedScene();
+    }
+
+    void Application::ReplicateScene()
+    {
+        auto role = m_Network->GetRole();
+        if (role != NetworkRole::Host && role != NetworkRole::Publisher) return;
+        if (!m_Network->IsConnected())                                     return;
+
+        // Dirty bits accumulate between ticks, so capping the rate like the
+        // camera loses no edits, it only merges them
+        double now = glfwGetTime();
+        float  hz  = m_CameraSync->GetSettings().MaxRateHz;
+        if (hz > 0.f && now - m_LastSceneSync < 1.0 / hz) return;
+        m_LastSceneSync = now;
+
+        m_SceneReplicator->SetNodeCount(m_Scene->GetModelCount());
+        for (size_t i = 0; i < m_Scene->GetModelCount(); ++i) {
+            const auto& model = m_Scene->GetModel(static_cast<int>(i));
+            NetNode node;
+            node.Name    = model.GetName();
+            node.Scale   = model.GetScale();
+            node.Visible = model.IsVisible();
+            for (int k = 0; k < 3; ++k) {
+                node.Position[k] = model.GetPosition()[k];
+                node.Rotation[k] = model.GetRotation()[k];
+            }
+            m_SceneReplicator->SetNode(i, node);
+        }
+        m_SceneReplicator->SetSelection(m_SelectedModel);
+
+        // The network layer folds each delta into the join snapshot
+        NetMessage delta;
+        if (m_SceneReplicator->BuildDelta(delta))
+            m_Network->Send(delta);
+    }
+
+    void Application::ApplyReplicatedScene()
+    {
+        // Models are matched by name: a student's scene may list them in a
+        // different order, or still be missing some while assets download
+        auto findModel = [this](const std::string& name) {
+            for (size_t i = 0; i < m_Scene->GetModelCount(); ++i)
+                if (m_Scene->GetModel(static_cast<int>(i)).GetName() == name)
+                    return static_cast<int>(i);
+            return -1;
+        };
+
+        const auto& nodes = m_SceneMirror->GetNodes();
+        for (const auto& node : nodes) {
+            int index = findModel(node.Name);
+            if (index < 0) continue;
+
+            auto& model = m_Scene->GetModel(index);
+            model.SetPosition({ node.Position[0], node.Position[1], node.Position[2] });
+            model.SetRotation({ node.Rotation[0], node.Rotation[1], node.Rotation[2] });
+            model.SetScale(node.Scale);
+            model.SetVisible(node.Visible);
+        }
+
+        int32_t selected = m_SceneMirror->GetSelection();
+        m_SelectedModel = selected >= 0 && selected < static_cast<int32_t>(nodes.size())
+                        ? findModel(nodes[selected].Name) : -1;
+    }
+
+    // ── Recording & replay ────────────────────────────────────────────────
+
+    void Application::StartRecording()
+    {
+        char        name[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(name, sizeof(name), "recordings/session-%Y%m%d-%H%M%S.atrec",
+                      std::localtime(&now));
+        if (!m_Recorder->Start(name)) return;
+
+        // The session is already under way: start the file from the current
+        // scene and camera, later messages are recorded as they are sent
+        m_Recorder->Record(m_SceneReplicator->BuildSnapshot());
+
+        NetMessage camera;
+        camera.Type            = NetMsgType::CameraSync;
+        camera.Camera.Yaw      = m_Camera->GetYaw();
+        camera.Camera.Pitch    = m_Camera->GetPitch();
+        camera.Camera.Distance = m_Camera->GetDistance();
+        m_Recorder->Record(camera);
+
+        m_Network->SetRecorder(m_Recorder);
+    }
+
+    void Application::StopRecording()
+    {
+        if (!m_Recorder || !m_Recorder->IsRecording()) return;
+
+        m_Network->SetRecorder(nullptr);
+        m_Recorder->Stop();
+    }
+
+    void Application::PlayRecording(float deltaTime)
+    {
+        if (!m_Player->IsOpen()) return;
+
+        bool sceneChanged = false;
+        m_Player->Advance(deltaTime, [this, &sceneChanged](const NetMessage& msg) {
+            sceneChanged |= ApplyRecordedMessage(msg);
+        });
+        if (sceneChanged)
+            ApplyReplicatedScene();
+    }
+
+    bool Application::ApplyRecordedMessage(const NetMessage& msg)
+    {
+        if (msg.Type == NetMsgType::SceneSnapshot || msg.Type == NetMsgType::SceneDelta)
+            return m_SceneMirror->Apply(msg);
+
+        // Recorded host timestamps don't follow a sped-up playhead, so the
+        // jitter buffer is bypassed and the camera snaps to each sample
+        if (msg.Type == NetMsgType::CameraSync)
+            m_Camera->SetFromNetwork(msg.Camera.Yaw, msg.Camera.Pitch, msg.Camera.Distance);
+
+        if (msg.Type == NetMsgType::Pointer) {
+            m_PointerVisible = !msg.Pointer.empty();
+            if (m_PointerVisible) {
+                const auto& p = msg.Pointer.back().Position;
+                m_PointerPosition = { p[0], p[1], p[2] };
+            }
+        }
+        return false;
+    }
+
+    void Application::ShareSceneAssets()
+    {
+        // Hashes every model file once; students fetch what their cache lacks
+        auto store = std::make_shared<AssetStore>();
+        for (size_t i = 0; i < m_Scene->GetModelCount(); ++i) {
+            const auto& model = m_Scene->GetModel(static_cast<int>(i));
+            if (!model.GetSourcePath().empty())
+                store->AddFile(model.GetSourcePath(), model.GetName());
+        }
+        m_Network->SetAssetStore(store->GetAssets().empty() ? nullptr : store);
+    }
+
+    void Application::LoadStreamedAssets(const NetMessage& manifest)
+    {
+        // Sent by the network layer once every file is in the local cache
+        if (!manifest.Data.contains("assets") || !manifest.Data["assets"].is_array()) return;
+
+        for (const auto& entry : manifest.Data["assets"]) {
+            std::string name = entry.value("name", std::string());
+            std::string path = entry.value("localPath", std::string());
+            if (path.empty()) continue;
+
+            bool loaded = false;
+            for (size_t i = 0; i < m_Scene->GetModelCount(); ++i)
+                loaded |= m_Scene->GetModel(static_cast<int>(i)).GetName() == name;
+
+            if (!loaded && m_Scene->LoadModel(path, name) >= 0)
+                ATOMETA_INFO("Loaded streamed model ", name);
+        }
+    }
+
     void Application::BroadcastCamera()
     {
-        if (m_Network->GetRole() != NetworkRole::Host) return;
-        if (!m_Network->IsConnected())                 return;
+        auto role = m_Network->GetRole();
+        if (role != NetworkRole::Host && role != NetworkRole::Publisher) return;
+        if (!m_Network->IsConnected())                                     return;
+
+        NetCamera camera;
+        camera.Yaw      = m_Camera->GetYaw();
+        camera.Pitch    = m_Camera->GetPitch();
+        camera.Distance = m_Camera->GetDistance();
+
+        // Only moved (quantized) cameras go out, rate-capped, plus keyframes.
+        // Stamped with a sequence number and the host clock so students can
+        // interpolate between them.
+        double now = glfwGetTime();
+        NetMessage msg;
+        msg.Type = NetMsgType::CameraSync;
+        if (m_CameraSync->Update(now, camera, msg.Camera)) {
+            msg.Sequence  = static_cast<uint32_t>(m_CameraSync->GetStats().MessagesSent);
+            msg.Timestamp = static_cast<uint64_t>(now * 1e6);
+            m_CameraSync->RecordSent(m_Network->Send(msg));
+        }
+    }
 
+    void Application::BroadcastPointer()
+    {
+        auto role = m_Network->GetRole();
+        if (role != NetworkRole::Host && role != NetworkRole::Publisher) return;
+
+        // Held L points at the mouse: the cursor ray meets the plane through
+        // the orbit target, facing the camera
+        double now = glfwGetTime();
+        if (Input::IsKeyPressed(GLFW_KEY_L) && !ImGui::GetIO().WantCaptureMouse) {
+            glm::mat4 view    = m_Camera->GetViewMatrix();
+            glm::mat4 inverse = glm::inverse(m_Camera->GetProjectionMatrix() * view);
+            glm::vec3 forward = -glm::vec3(view[0][2], view[1][2], view[2][2]);
+            glm::vec3 target  = m_Camera->GetPosition() + forward * m_Camera->GetDistance();
+
+            glm::vec2 mouse = Input::GetMousePosition();
+            float x = 2.f * mouse.x / m_Window->GetWidth() - 1.f;
+            float y = 1.f - 2.f * mouse.y / m_Window->GetHeight();
+            glm::vec4 nearPoint = inverse * glm::vec4(x, y, -1.f, 1.f);
+            glm::vec4 farPoint  = inverse * glm::vec4(x, y,  1.f, 1.f);
+            glm::vec3 origin    = glm::vec3(nearPoint) / nearPoint.w;
+            glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - origin);
+
+            float facing = glm::dot(direction, forward);
+            if (facing > 1e-4f) {
+                m_PointerPosition = origin + direction * (glm::dot(target - origin, forward) / facing);
+                m_PointerVisible  = true;
+                m_PointerStream->AddSample(now, { m_PointerPosition.x, m_PointerPosition.y,
+                                                  m_PointerPosition.z });
+            }
+        } else if (m_PointerVisible) {
+            m_PointerVisible = false;
+            m_PointerStream->Hide(now);
+        }
+
+        // Samples gathered since the last tick go out together, thinned
+        // to the per-student budget
+        if (!m_Network->IsConnected()) return;
         NetMessage msg;
-        msg.Type          = NetMsgType::CameraSync;
-        msg.Data["yaw"]   = m_Camera->GetYaw();
-        msg.Data["pitch"] = m_Camera->GetPitch();
-        msg.Data["dist"]  = m_Camera->GetDistance();
-        m_Network->Send(msg);
+        if (m_PointerStream->Update(now, msg))
+            m_Network->Send(msg);
+    }
+
+    void Application::RenderPointer()
+    {
+        if (!m_PointerVisible) return;
+
+        // Scene::Render left the shader bound with this frame's camera;
+        // sized with the distance so it stays the same size on screen
+        float     radius = 0.012f * m_Camera->GetDistance();
+        glm::mat4 model  = glm::translate(glm::mat4(1.f), m_PointerPosition)
+                         * glm::scale(glm::mat4(1.f), glm::vec3(radius));
+        m_Shader->SetMat4("u_Model", model);
+        m_Shader->SetVec3("u_Color", glm::vec3(1.0f, 0.15f, 0.1f));
+        m_PointerMesh->Draw();
     }
 
     void Application::RenderUI(float& cameraSensitivity)
@@ -197,13 +496,51 @@ namespace Atometa
         {
             ImGui::SeparatorText("Start a session");
 
-            static uint16_t hostPort = 8080;
+            static uint16_t hostPort  = 8080;
+            static int      ioThreads = 1;
+            static bool     multicast = false;
+            static int      fanout    = 0;
+            static int      tickRate  = 0;
+            static uint16_t metrics   = 0;
             ImGui::SetNextItemWidth(80.f);
             ImGui::InputScalar("Port##host", ImGuiDataType_U16, &hostPort);
             ImGui::SameLine();
+            ImGui::SetNextItemWidth(80.f);
+            ImGui::SliderInt("IO threads", &ioThreads, 1,
+                             std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+            ImGui::SameLine();
+            ImGui::Checkbox("LAN multicast", &multicast);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(80.f);
+            ImGui::InputInt("Max direct", &fanout);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Students past this many are handed to relaying students (0 = no limit)");
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(80.f);
+            ImGui::InputInt("Tick (Hz)", &tickRate);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Send each student one frame per tick with everything from it (0 = send at once)");
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(80.f);
+            ImGui::InputScalar("Metrics port", ImGuiDataType_U16, &metrics);
+            if (ImGui::IsItemHovered())
+                ImGui::SetTooltip("Serve Prometheus metrics at http://<host>:<port>/metrics (0 = off)");
+            ImGui::SameLine();
             if (ImGui::Button("Host Session")) {
-                if (m_Network->StartHost(hostPort))
+                MulticastConfig config;
+                config.Enabled = multicast;
+                m_Network->SetMulticast(config);
+                m_Network->SetTreeFanout(static_cast<uint32_t>(std::max(fanout, 0)));
+                m_Network->SetTickRate(static_cast<uint32_t>(std::max(tickRate, 0)));
+                m_Network->SetMetricsPort(metrics);
+                m_Network->SetIOThreadCount(static_cast<size_t>(ioThreads));
+                ShareSceneAssets();
+                if (m_Network->StartHost(hostPort)) {
+                    m_CameraSync->Reset();
+                    m_PointerStream->Reset();
+                    m_SceneReplicator->Reset();
                     ATOMETA_INFO("Hosting on port ", hostPort);
+                }
             }
 
             ImGui::Spacing();
@@ -212,30 +549,284 @@ namespace Atometa
 
             static char joinIp[64]   = "127.0.0.1";
             static uint16_t joinPort = 8080;
+            static bool     relay    = false;
+            static uint16_t relayListen = 8081;
             ImGui::SetNextItemWidth(140.f);
             ImGui::InputText("IP##join", joinIp, sizeof(joinIp));
             ImGui::SameLine();
             ImGui::SetNextItemWidth(80.f);
             ImGui::InputScalar("Port##join", ImGuiDataType_U16, &joinPort);
+            ImGui::Checkbox("Relay to other students on port", &relay);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(80.f);
+            ImGui::InputScalar("##relayListen", ImGuiDataType_U16, &relayListen);
             ImGui::SameLine();
             if (ImGui::Button("Join Session")) {
+                m_Network->SetTreeRelay(relay ? relayListen : 0);
+                m_Network->SetTreeFanout(relay ? 4 : 0);
+                m_Player->Close();
+                m_CameraJitter->Reset();
+                m_PointerTrack->Reset();
+                m_PointerVisible = false;
+                m_SceneMirror->Reset();
                 if (m_Network->Connect(joinIp, joinPort))
                     ATOMETA_INFO("Connecting to ", joinIp, ":", joinPort);
             }
+
+            ImGui::Spacing();
+            ImGui::SeparatorText("Publish through a relay");
+
+            static char relayIp[64]   = "127.0.0.1";
+            static char relayKey[64]  = "";
+            static uint16_t relayPort = 8080;
+            ImGui::SetNextItemWidth(140.f);
+            ImGui::InputText("IP##relay", relayIp, sizeof(relayIp));
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(80.f);
+            ImGui::InputScalar("Port##relay", ImGuiDataType_U16, &relayPort);
+            ImGui::SetNextItemWidth(140.f);
+            ImGui::InputText("Key##relay", relayKey, sizeof(relayKey),
+                             ImGuiInputTextFlags_Password);
+            ImGui::SameLine();
+            if (ImGui::Button("Publish")) {
+                if (m_Network->Publish(relayIp, relayPort, relayKey)) {
+                    m_CameraSync->Reset();
+                    m_PointerStream->Reset();
+                    m_SceneReplicator->Reset();
+                }
+            }
+
+            ImGui::Spacing();
+            ImGui::SeparatorText("Replay a recording");
+
+            static char replayPath[256] = "recordings/";
+            if (!m_Player->IsOpen()) {
+                ImGui::SetNextItemWidth(260.f);
+                ImGui::InputText("File##replay", replayPath, sizeof(replayPath));
+                ImGui::SameLine();
+                if (ImGui::Button("Open") && m_Player->Open(replayPath)) {
+                    m_CameraJitter->Reset();
+                    m_PointerTrack->Reset();
+                    m_PointerVisible = false;
+                    m_SceneMirror->Reset();
+                }
+            } else {
+                bool sceneChanged = false;
+                auto apply = [this, &sceneChanged](const NetMessage& msg) {
+                    sceneChanged |= ApplyRecordedMessage(msg);
+                };
+
+                float position = static_cast<float>(m_Player->GetPosition());
+                float duration = static_cast<float>(m_Player->GetDuration());
+                char  label[32];
+                std::snprintf(label, sizeof(label), "%02d:%02d / %02d:%02d",
+                              static_cast<int>(position) / 60, static_cast<int>(position) % 60,
+                              static_cast<int>(duration) / 60, static_cast<int>(duration) % 60);
+                ImGui::SetNextItemWidth(260.f);
+                if (ImGui::SliderFloat("##replayPos", &position, 0.f, duration, label))
+                    m_Player->Seek(position, apply);
+
+                float speed = static_cast<float>(m_Player->GetSpeed());
+                ImGui::SetNextItemWidth(120.f);
+                if (ImGui::SliderFloat("Speed", &speed,
+                                       static_cast<float>(SessionPlayer::kMinSpeed),
+                                       static_cast<float>(SessionPlayer::kMaxSpeed), "%.0fx"))
+                    m_Player->SetSpeed(speed);
+                ImGui::SameLine();
+                if (ImGui::Button(m_Player->IsPaused() ? "Play" : "Pause"))
+                    m_Player->SetPaused(!m_Player->IsPaused());
+                ImGui::SameLine();
+                if (ImGui::Button("Close##replay"))
+                    m_Player->Close();
+
+                if (m_Player->WasRecovered())
+                    ImGui::TextColored({1.f,0.8f,0.2f,1.f}, "Recording was not closed cleanly; index rebuilt");
+
+                if (sceneChanged)
+                    ApplyReplicatedScene();
+            }
+        }
+        else if (role == NetworkRole::Publisher)
+        {
+            if (m_Network->IsConnected())
+                ImGui::TextColored({0.2f,1.f,0.4f,1.f}, "● Publishing to relay");
+            else
+                ImGui::TextColored({1.f,0.4f,0.2f,1.f}, "● Connecting to relay...");
+            RenderRecordingControls();
+            if (ImGui::Button("Stop Publishing")) {
+                StopRecording();
+                m_Network->Disconnect();
+            }
         }
         else if (role == NetworkRole::Host)
         {
             ImGui::TextColored({0.2f,1.f,0.4f,1.f}, "● Hosting");
             ImGui::Text("Students connected: %u", m_Network->GetClientCount());
-            if (ImGui::Button("Stop Session"))
+
+            ImGui::SeparatorText("Camera sync");
+            auto& sync  = m_CameraSync->GetSettings();
+            auto& stats = m_CameraSync->GetStats();
+            ImGui::SetNextItemWidth(120.f);
+            ImGui::SliderFloat("Max rate (Hz)", &sync.MaxRateHz, 5.f, 120.f, "%.0f");
+            ImGui::Text("Sent %llu / %llu frames (%llu keyframes)",
+                        (unsigned long long)stats.MessagesSent,
+                        (unsigned long long)stats.FramesOffered,
+                        (unsigned long long)stats.KeyframesSent);
+            ImGui::Text("%.1f KB sent, ~%.1f KB saved",
+                        stats.BytesSent    / 1024.0,
+                        stats.BytesSaved() / 1024.0);
+
+            auto& pointer = m_PointerStream->GetStats();
+            ImGui::Text("Pointer (hold L): %llu samples sent, %llu thinned, %.1f KB per student",
+                        (unsigned long long)pointer.SamplesSent,
+                        (unsigned long long)pointer.SamplesDropped,
+                        pointer.BytesSent / 1024.0);
+
+            auto& scene = m_SceneReplicator->GetStats();
+            ImGui::Text("Scene: %llu deltas (%llu fields), seq %u",
+                        (unsigned long long)scene.DeltasBuilt,
+                        (unsigned long long)scene.FieldsSent,
+                        m_SceneReplicator->GetSequence());
+
+            ImGui::SeparatorText("Students");
+            auto students = m_Network->GetSessionStats();
+            if (!students.empty() &&
+                ImGui::BeginTable("students", 7, ImGuiTableFlags_Borders |
+                                                 ImGuiTableFlags_SizingFixedFit))
+            {
+                ImGui::TableSetupColumn("Address");
+                ImGui::TableSetupColumn("Format");
+                ImGui::TableSetupColumn("Queue (max)");
+                ImGui::TableSetupColumn("Sent");
+                ImGui::TableSetupColumn("Coalesced");
+                ImGui::TableSetupColumn("RTT min/avg/p99 (ms)");
+                ImGui::TableSetupColumn("Camera p99 (ms)");
+                ImGui::TableHeadersRow();
+
+                for (const auto& s : students) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(s.PeerIp.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(s.Format == WireFormat::Binary ? "binary" : "json");
+                    ImGui::TableNextColumn(); ImGui::Text("%u (%u)", s.QueueDepth, s.MaxQueueDepth);
+                    ImGui::TableNextColumn(); ImGui::Text("%.1f KB", s.BytesSent / 1024.0);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)s.Coalesced);
+                    ImGui::TableNextColumn();
+                    if (s.RoundTrip.Samples)
+                        ImGui::Text("%.1f / %.1f / %.1f", s.RoundTrip.MinMs,
+                                    s.RoundTrip.AvgMs, s.RoundTrip.P99Ms);
+                    else
+                        ImGui::TextUnformatted("-");
+                    ImGui::TableNextColumn();
+                    const auto& realtime = s.Lanes[static_cast<size_t>(Lane::Realtime)];
+                    if (realtime.Messages)
+                        ImGui::Text("%.2f", realtime.P99Ms);
+                    else
+                        ImGui::TextUnformatted("-");
+                }
+                ImGui::EndTable();
+            }
+            ImGui::Text("Dropped (too far behind): %llu",
+                        (unsigned long long)m_Network->GetDroppedClientCount());
+            auto totals = m_Network->GetStats();
+            ImGui::Text("Joins: %llu from snapshot, %llu resumed",
+                        (unsigned long long)totals.JoinSnapshots,
+                        (unsigned long long)totals.ResumedJoins);
+            if (totals.StudentMessages.Delivered || totals.StudentMessages.Throttled)
+                ImGui::Text("From students: %llu messages, %llu over the rate limit",
+                            (unsigned long long)totals.StudentMessages.Delivered,
+                            (unsigned long long)(totals.StudentMessages.Throttled +
+                                                 totals.StudentMessages.Overflow));
+            if (totals.Batches)
+                ImGui::Text("Tick batches: %llu frames carrying %llu messages",
+                            (unsigned long long)totals.Batches,
+                            (unsigned long long)totals.BatchedMessages);
+
+            auto multicast = m_Network->GetMulticastStats();
+            if (multicast.Active)
+                ImGui::Text("Multicast: %u students, %llu datagrams, %llu repaired",
+                            multicast.Subscribers,
+                            (unsigned long long)multicast.Sent.Datagrams,
+                            (unsigned long long)multicast.Sent.Repaired);
+
+            auto tree = m_Network->GetTreeStats();
+            if (tree.Subtree > tree.Children)
+                ImGui::Text("Relay tree: %u students in all, %llu handed to relays",
+                            tree.Subtree, (unsigned long long)tree.Redirects);
+
+            RenderRecordingControls();
+            if (ImGui::Button("Stop Session")) {
+                StopRecording();
                 m_Network->StopHost();
+            }
         }
         else if (role == NetworkRole::Client)
         {
+            auto reconnect = m_Network->GetReconnectStats();
             if (m_Network->IsConnected())
                 ImGui::TextColored({0.2f,1.f,0.4f,1.f}, "● Connected to session");
+            else if (reconnect.Drops > 0)
+                ImGui::TextColored({1.f,0.8f,0.2f,1.f}, "● Connection lost, reconnecting...");
             else
                 ImGui::TextColored({1.f,0.4f,0.2f,1.f}, "● Connecting...");
+
+            if (reconnect.Drops > 0)
+                ImGui::Text("Reconnects: %u resumed, %u full resync (last %.0f ms, max %.0f ms)",
+                            reconnect.Resumed, reconnect.FullResyncs,
+                            reconnect.LastMs, reconnect.MaxMs);
+
+            auto assets = m_Network->GetAssetProgress();
+            if (!assets.Complete()) {
+                float fraction = static_cast<float>(assets.ChunksReceived) / assets.ChunksTotal;
+                char  label[64];
+                std::snprintf(label, sizeof(label), "%.1f MB", assets.BytesReceived / (1024.0 * 1024.0));
+                ImGui::Text("Downloading models");
+                ImGui::ProgressBar(fraction, ImVec2(-1.f, 0.f), label);
+            }
+
+            if (float join = m_Network->GetJoinLatencyMs(); join > 0.f)
+                ImGui::Text("In sync %.0f ms after joining", join);
+
+            auto rtt = m_Network->GetRoundTrip();
+            if (rtt.Samples)
+                ImGui::Text("RTT %.1f ms avg, %.1f ms p99, clock offset %+.1f ms",
+                            rtt.AvgMs, rtt.P99Ms, rtt.ClockOffsetMs);
+
+            auto inbound = m_Inbound->GetStats();
+            ImGui::Text("Inbound queue: %.0f us last, %.0f us avg, %.0f us max",
+                        inbound.LastLatencyUs, inbound.AvgLatencyUs, inbound.MaxLatencyUs);
+            ImGui::Text("Inbound dropped (queue full): %llu",
+                        (unsigned long long)inbound.Dropped);
+
+            auto& mirror = m_SceneMirror->GetStats();
+            ImGui::Text("Scene seq %u: %llu snapshots, %llu deltas, %llu gaps",
+                        m_SceneMirror->GetSequence(),
+                        (unsigned long long)mirror.Snapshots,
+                        (unsigned long long)mirror.Deltas,
+                        (unsigned long long)mirror.Gaps);
+
+            auto tree = m_Network->GetTreeStats();
+            if (tree.Depth > 1 || tree.Relaying)
+                ImGui::Text("Relay tree: depth %u, %.1f ms from host (%.1f ms last hop), relaying to %u",
+                            tree.Depth, tree.PathLatencyMs, tree.HopLatencyMs, tree.Subtree);
+
+            auto multicast = m_Network->GetMulticastStats();
+            if (multicast.Active)
+                ImGui::Text("Multicast: %llu received, %llu lost, %llu late",
+                            (unsigned long long)multicast.Received.Received,
+                            (unsigned long long)multicast.Received.Lost,
+                            (unsigned long long)multicast.Received.Late);
+
+            ImGui::SeparatorText("Camera smoothing");
+            auto& jitter = m_CameraJitter->GetStats();
+            ImGui::Text("Playout delay %.0f ms, jitter %.1f ms",
+                        jitter.Delay * 1000.f, jitter.Jitter * 1000.f);
+            ImGui::Text("Interpolated %llu, extrapolated %llu frames",
+                        (unsigned long long)jitter.Interpolated,
+                        (unsigned long long)jitter.Extrapolated);
+            ImGui::Text("Lost %llu, late %llu samples",
+                        (unsigned long long)jitter.Lost,
+                        (unsigned long long)jitter.Late);
             if (ImGui::Button("Leave Session"))
                 m_Network->Disconnect();
         }
@@ -243,6 +834,30 @@ namespace Atometa
         ImGui::End();
     }
 
+    void Application::RenderRecordingControls()
+    {
+        ImGui::SeparatorText("Recording");
+        if (!m_Recorder->IsRecording()) {
+            if (ImGui::Button("Record"))
+                StartRecording();
+            return;
+        }
+
+        auto stats = m_Recorder->GetStats();
+        ImGui::TextColored({1.f,0.3f,0.3f,1.f}, "● REC %02d:%02d",
+                           static_cast<int>(m_Recorder->GetElapsed()) / 60,
+                           static_cast<int>(m_Recorder->GetElapsed()) % 60);
+        ImGui::SameLine();
+        ImGui::Text("%llu messages, %.1f KB, %llu keyframes",
+                    (unsigned long long)stats.Messages, stats.Bytes / 1024.0,
+                    (unsigned long long)stats.Keyframes);
+        if (stats.Dropped)
+            ImGui::Text("Dropped (writer behind): %llu", (unsigned long long)stats.Dropped);
+        ImGui::TextUnformatted(m_Recorder->GetPath().c_str());
+        if (ImGui::Button("Stop Recording"))
+            StopRecording();
+    }
+
     void Application::Close()
     {
         m_Running = false;
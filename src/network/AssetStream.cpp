@@ -0,0 +1,275 @@
+#include "Atometa/Network/AssetStream.h"
+#include "Atometa/Core/Logger.h"
+
+#include <boost/uuid/detail/sha1.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace Atometa {
+
+    namespace {
+
+        class Sha1 {
+        public:
+            void Update(const void* data, size_t size) { m_Sha.process_bytes(data, size); }
+
+            std::string HexDigest()
+            {
+                boost::uuids::detail::sha1::digest_type digest;
+                m_Sha.get_digest(digest);
+
+                // Boost < 1.86 hands back five 32-bit words, newer
+                // versions twenty bytes; both print the same way
+                std::string out;
+                char        buf[9];
+                for (auto part : digest) {
+                    if constexpr (sizeof(part) == 1)
+                        std::snprintf(buf, sizeof(buf), "%02x", static_cast<unsigned>(part));
+                    else
+                        std::snprintf(buf, sizeof(buf), "%08x", static_cast<unsigned>(part));
+                    out += buf;
+                }
+                return out;
+            }
+
+        private:
+            boost::uuids::detail::sha1 m_Sha;
+        };
+
+        // Host-supplied names must not escape the cache directory
+        std::string SafeFileName(const std::string& name)
+        {
+            std::string file = fs::path(name).filename().string();
+            if (file.empty() || file == "." || file == "..")
+                return "asset";
+            return file;
+        }
+
+    } // namespace
+
+    std::string ContentHash(const void* data, size_t size)
+    {
+        Sha1 sha;
+        sha.Update(data, size);
+        return sha.HexDigest();
+    }
+
+    bool IsContentHash(const std::string& hash)
+    {
+        if (hash.size() != 40) return false;
+        for (char c : hash)
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+                return false;
+        return true;
+    }
+
+    // =========================================================================
+    // AssetInfo
+    // =========================================================================
+
+    json AssetInfo::ToJson() const
+    {
+        return {
+            { "name",      Name      },
+            { "file",      FileName  },
+            { "hash",      Hash      },
+            { "size",      Size      },
+            { "chunkSize", ChunkSize },
+            { "chunks",    Chunks    },
+        };
+    }
+
+    bool AssetInfo::FromJson(const json& j, AssetInfo& out)
+    {
+        try {
+            out.Name      = j.value("name", std::string());
+            out.FileName  = SafeFileName(j.at("file").get<std::string>());
+            out.Hash      = j.at("hash").get<std::string>();
+            out.Size      = j.at("size").get<uint64_t>();
+            out.ChunkSize = j.at("chunkSize").get<uint32_t>();
+            out.Chunks    = j.at("chunks").get<std::vector<std::string>>();
+        } catch (...) {
+            return false;
+        }
+
+        if (!IsContentHash(out.Hash)) return false;
+        for (const auto& chunk : out.Chunks)
+            if (!IsContentHash(chunk)) return false;
+        return true;
+    }
+
+    // =========================================================================
+    // AssetStore
+    // =========================================================================
+
+    AssetStore::AssetStore(uint32_t chunkSize)
+        : m_ChunkSize(chunkSize ? chunkSize : kDefaultChunkSize)
+    {
+    }
+
+    bool AssetStore::AddFile(const std::string& path, const std::string& name)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            ATOMETA_WARN("AssetStore: cannot read ", path);
+            return false;
+        }
+
+        AssetInfo asset;
+        asset.Name      = name.empty() ? fs::path(path).stem().string() : name;
+        asset.FileName  = SafeFileName(path);
+        asset.ChunkSize = m_ChunkSize;
+
+        Sha1        whole;
+        std::string buffer(m_ChunkSize, '\0');
+        uint64_t    offset = 0;
+
+        while (file) {
+            file.read(buffer.data(), m_ChunkSize);
+            auto got = static_cast<size_t>(file.gcount());
+            if (got == 0) break;
+
+            whole.Update(buffer.data(), got);
+            std::string hash = ContentHash(buffer.data(), got);
+            m_Chunks.emplace(hash, ChunkLocation{ path, offset, static_cast<uint32_t>(got) });
+            asset.Chunks.push_back(std::move(hash));
+            offset += got;
+        }
+
+        asset.Size = offset;
+        asset.Hash = whole.HexDigest();
+        m_Assets.push_back(std::move(asset));
+        return true;
+    }
+
+    bool AssetStore::HasChunk(const std::string& hash) const
+    {
+        return m_Chunks.count(hash) != 0;
+    }
+
+    bool AssetStore::ReadChunk(const std::string& hash, std::string& out) const
+    {
+        auto it = m_Chunks.find(hash);
+        if (it == m_Chunks.end()) return false;
+
+        std::ifstream file(it->second.Path, std::ios::binary);
+        if (!file) return false;
+
+        out.resize(it->second.Size);
+        file.seekg(static_cast<std::streamoff>(it->second.Offset));
+        file.read(out.data(), it->second.Size);
+        return static_cast<size_t>(file.gcount()) == it->second.Size;
+    }
+
+    NetMessage AssetStore::MakeManifest() const
+    {
+        NetMessage msg;
+        msg.Type = NetMsgType::AssetManifest;
+        msg.Data = { { "assets", json::array() } };
+        for (const auto& asset : m_Assets)
+            msg.Data["assets"].push_back(asset.ToJson());
+        return msg;
+    }
+
+    // =========================================================================
+    // AssetCache
+    // =========================================================================
+
+    AssetCache::AssetCache(std::string root)
+        : m_Root(std::move(root))
+    {
+    }
+
+    std::string AssetCache::ChunkPath(const std::string& hash) const
+    {
+        return (fs::path(m_Root) / "chunks" / hash).string();
+    }
+
+    std::string AssetCache::FilePath(const AssetInfo& asset) const
+    {
+        return (fs::path(m_Root) / "files" / asset.Hash / SafeFileName(asset.FileName)).string();
+    }
+
+    bool AssetCache::HasChunk(const std::string& hash) const
+    {
+        std::error_code ec;
+        return IsContentHash(hash) && fs::exists(ChunkPath(hash), ec);
+    }
+
+    bool AssetCache::PutChunk(const std::string& hash, const std::string& data)
+    {
+        if (!IsContentHash(hash) || ContentHash(data.data(), data.size()) != hash)
+            return false;
+
+        std::error_code ec;
+        fs::create_directories(fs::path(m_Root) / "chunks", ec);
+
+        // Write aside and rename so a crash never leaves a torn chunk
+        std::string path = ChunkPath(hash);
+        std::string temp = path + ".part";
+        {
+            std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+            if (!file.write(data.data(), static_cast<std::streamsize>(data.size())))
+                return false;
+        }
+        fs::rename(temp, path, ec);
+        return !ec;
+    }
+
+    std::vector<std::string> AssetCache::MissingChunks(const AssetInfo& asset) const
+    {
+        std::error_code ec;
+        std::string     assembled = FilePath(asset);
+        if (fs::exists(assembled, ec) && fs::file_size(assembled, ec) == asset.Size)
+            return {};
+
+        std::vector<std::string>        missing;
+        std::unordered_set<std::string> seen;
+        for (const auto& hash : asset.Chunks)
+            if (seen.insert(hash).second && !HasChunk(hash))
+                missing.push_back(hash);
+        return missing;
+    }
+
+    std::string AssetCache::Assemble(const AssetInfo& asset) const
+    {
+        std::error_code ec;
+        std::string     path = FilePath(asset);
+        if (fs::exists(path, ec) && fs::file_size(path, ec) == asset.Size)
+            return path;
+
+        fs::create_directories(fs::path(path).parent_path(), ec);
+        std::string temp = path + ".part";
+
+        Sha1 whole;
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            std::string   buffer;
+            for (const auto& hash : asset.Chunks) {
+                std::ifstream chunk(ChunkPath(hash), std::ios::binary);
+                if (!chunk) return "";
+
+                buffer.assign(std::istreambuf_iterator<char>(chunk),
+                              std::istreambuf_iterator<char>());
+                whole.Update(buffer.data(), buffer.size());
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            }
+            if (!out) return "";
+        }
+
+        if (whole.HexDigest() != asset.Hash) {
+            ATOMETA_WARN("AssetCache: ", asset.FileName, " failed verification");
+            fs::remove(temp, ec);
+            return "";
+        }
+
+        fs::rename(temp, path, ec);
+        return ec ? "" : path;
+    }
+
+} // namespace Atometa
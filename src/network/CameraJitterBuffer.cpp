@@ -0,0 +1,167 @@
+#include "Atometa/Network/CameraJitterBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Atometa {
+
+    namespace {
+
+        // Signed shortest rotation from a to b, in degrees
+        float ShortestArc(float a, float b)
+        {
+            float d = std::fmod(b - a, 360.0f);
+            if (d >  180.0f) d -= 360.0f;
+            if (d < -180.0f) d += 360.0f;
+            return d;
+        }
+
+        // alpha in [0, 1] interpolates, > 1 extrapolates along a → b.
+        // For an orbit camera, shortest-arc yaw plus linear pitch is the
+        // constant-angular-velocity path slerp would give.
+        NetCamera Blend(const NetCamera& a, const NetCamera& b, double alpha)
+        {
+            float t = static_cast<float>(alpha);
+            NetCamera out;
+            out.Yaw      = a.Yaw      + ShortestArc(a.Yaw, b.Yaw) * t;
+            out.Pitch    = a.Pitch    + (b.Pitch    - a.Pitch)    * t;
+            out.Distance = a.Distance + (b.Distance - a.Distance) * t;
+            return out;
+        }
+
+        bool SameCamera(const NetCamera& a, const NetCamera& b)
+        {
+            return a.Yaw == b.Yaw && a.Pitch == b.Pitch && a.Distance == b.Distance;
+        }
+
+    } // namespace
+
+    CameraJitterBuffer::CameraJitterBuffer(const CameraJitterSettings& settings)
+        : m_Settings(settings)
+    {
+    }
+
+    void CameraJitterBuffer::Push(uint32_t sequence, double hostTime, double localTime,
+                                  const NetCamera& camera)
+    {
+        if (sequence == 0) return;
+
+        // A counter far behind the last one means the host restarted
+        if (m_LastSeq != 0 && sequence + m_Settings.Capacity < m_LastSeq)
+            Reset();
+
+        if (m_LastSeq != 0 && sequence <= m_LastSeq) {
+            ++m_Stats.Late;
+            return;
+        }
+
+        ++m_Stats.Received;
+        double transit = localTime - hostTime;
+
+        if (m_LastSeq == 0) {
+            m_Offset      = transit;
+            m_LastTransit = transit;
+        } else {
+            m_Stats.Lost += sequence - m_LastSeq - 1;
+
+            double d = std::fabs(transit - m_LastTransit);
+            m_Stats.Jitter += static_cast<float>((d - m_Stats.Jitter) / 16.0);
+            m_LastTransit   = transit;
+
+            // Baseline follows the fastest delivery, creeping up by at most
+            // 1 ms/s so clock drift between the machines cannot strand it
+            double dt = hostTime - m_LastHost;
+            m_Offset  = std::min(transit, m_Offset + 0.001 * std::max(0.0, dt));
+
+            // Idle gaps (keyframes only) say nothing about the send rate
+            if (dt > 0.0 && dt < m_Settings.MaxDelay)
+                m_Interval = m_Interval > 0.0 ? m_Interval + (dt - m_Interval) / 8.0 : dt;
+        }
+
+        m_LastSeq  = sequence;
+        m_LastHost = hostTime;
+        m_Samples.push_back({ sequence, hostTime, camera });
+
+        while (m_Samples.size() > std::max<size_t>(m_Settings.Capacity, 2)) {
+            m_Previous    = m_Samples.front();
+            m_HasPrevious = true;
+            m_Samples.pop_front();
+        }
+        m_Stats.Delay = PlayoutDelay();
+    }
+
+    bool CameraJitterBuffer::Sample(double localTime, NetCamera& out)
+    {
+        if (m_Samples.empty()) return false;
+
+        // Playout point on the host clock
+        double t = localTime - m_Offset - PlayoutDelay();
+
+        while (m_Samples.size() >= 2 && m_Samples[1].HostTime <= t) {
+            m_Previous    = m_Samples.front();
+            m_HasPrevious = true;
+            m_Samples.pop_front();
+        }
+
+        const Entry& a = m_Samples.front();
+
+        if (t < a.HostTime) {
+            // Between the last consumed sample and the oldest queued one
+            if (m_HasPrevious && m_Previous.HostTime <= t) {
+                double span = a.HostTime - m_Previous.HostTime;
+                ++m_Stats.Interpolated;
+                return Emit(Blend(m_Previous.Camera, a.Camera,
+                                  (t - m_Previous.HostTime) / span), out);
+            }
+            return Emit(a.Camera, out);
+        }
+
+        if (m_Samples.size() >= 2) {
+            const Entry& b = m_Samples[1];
+            ++m_Stats.Interpolated;
+            return Emit(Blend(a.Camera, b.Camera,
+                              (t - a.HostTime) / (b.HostTime - a.HostTime)), out);
+        }
+
+        // Past the newest sample: predict briefly from the last motion,
+        // then settle on the newest pose actually received
+        double ahead = t - a.HostTime;
+        double span  = m_HasPrevious ? a.HostTime - m_Previous.HostTime : 0.0;
+        if (ahead <= m_Settings.MaxExtrapolation && span > 0.0 && span < m_Settings.MaxDelay) {
+            ++m_Stats.Extrapolated;
+            return Emit(Blend(m_Previous.Camera, a.Camera, 1.0 + ahead / span), out);
+        }
+        return Emit(a.Camera, out);
+    }
+
+    void CameraJitterBuffer::Reset()
+    {
+        m_Samples.clear();
+        m_HasPrevious = false;
+        m_Offset      = 0.0;
+        m_LastTransit = 0.0;
+        m_Interval    = 0.0;
+        m_LastSeq     = 0;
+        m_LastHost    = 0.0;
+        m_HasOut      = false;
+        m_Stats.Jitter = 0.f;
+    }
+
+    float CameraJitterBuffer::PlayoutDelay() const
+    {
+        float delay = static_cast<float>(m_Interval) + 3.0f * m_Stats.Jitter;
+        return std::clamp(delay, m_Settings.MinDelay, m_Settings.MaxDelay);
+    }
+
+    bool CameraJitterBuffer::Emit(const NetCamera& camera, NetCamera& out)
+    {
+        if (m_HasOut && SameCamera(camera, m_LastOut))
+            return false;
+
+        m_LastOut = camera;
+        m_HasOut  = true;
+        out       = camera;
+        return true;
+    }
+
+} // namespace Atometa
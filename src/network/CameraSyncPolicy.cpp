@@ -0,0 +1,81 @@
+#include "Atometa/Network/CameraSyncPolicy.h"
+
+#include <cmath>
+
+namespace Atometa {
+
+    namespace {
+
+        float Snap(float value, float step)
+        {
+            return step > 0.0f ? std::round(value / step) * step : value;
+        }
+
+    } // namespace
+
+    CameraSyncPolicy::CameraSyncPolicy(const CameraSyncSettings& settings)
+        : m_Settings(settings)
+    {
+    }
+
+    bool CameraSyncPolicy::Update(double now, const NetCamera& camera, NetCamera& out)
+    {
+        ++m_Stats.FramesOffered;
+
+        NetCamera quantized = Quantize(camera);
+        double    elapsed   = now - m_LastSendTime;
+
+        bool send     = !m_HasSent;
+        bool keyframe = false;
+
+        if (!send) {
+            bool rateOk = m_Settings.MaxRateHz <= 0.0f ||
+                          elapsed >= 1.0 / m_Settings.MaxRateHz;
+
+            if (rateOk && HasMoved(quantized)) {
+                send = true;
+            } else if (m_Settings.KeyframeInterval > 0.0f &&
+                       elapsed >= m_Settings.KeyframeInterval) {
+                send     = true;
+                keyframe = true;
+            }
+        }
+
+        if (!send) {
+            ++m_Stats.Suppressed;
+            return false;
+        }
+
+        ++m_Stats.MessagesSent;
+        if (keyframe) ++m_Stats.KeyframesSent;
+
+        m_LastSent     = quantized;
+        m_LastSendTime = now;
+        m_HasSent      = true;
+        out            = quantized;
+        return true;
+    }
+
+    void CameraSyncPolicy::Reset()
+    {
+        m_HasSent = false;
+    }
+
+    NetCamera CameraSyncPolicy::Quantize(const NetCamera& camera) const
+    {
+        NetCamera q;
+        q.Yaw      = Snap(camera.Yaw,      m_Settings.AngleStep);
+        q.Pitch    = Snap(camera.Pitch,    m_Settings.AngleStep);
+        q.Distance = Snap(camera.Distance, m_Settings.DistanceStep);
+        return q;
+    }
+
+    bool CameraSyncPolicy::HasMoved(const NetCamera& camera) const
+    {
+        float eps = m_Settings.Epsilon;
+        return std::fabs(camera.Yaw      - m_LastSent.Yaw)      > eps ||
+               std::fabs(camera.Pitch    - m_LastSent.Pitch)    > eps ||
+               std::fabs(camera.Distance - m_LastSent.Distance) > eps;
+    }
+
+} // namespace Atometa
@@ -0,0 +1,147 @@
+#include "Atometa/Network/Compression.h"
+
+#include <boost/beast/zlib/deflate_stream.hpp>
+#include <boost/beast/zlib/inflate_stream.hpp>
+
+#include <algorithm>
+
+namespace zlib = boost::beast::zlib;
+
+namespace Atometa {
+
+    namespace {
+
+        // 32 KB window; memLevel 4 keeps a deflater near 100 KB, which is
+        // paid per lane and per student
+        constexpr int kWindowBits = 15;
+        constexpr int kMemLevel   = 4;
+
+        // What a sync flush ends with. Left off the wire and put back
+        // before inflating, as permessage-deflate does.
+        constexpr char kSyncTail[4] = { 0x00, 0x00, char(0xFF), char(0xFF) };
+
+    } // namespace
+
+    // =========================================================================
+    // FrameDeflater
+    // =========================================================================
+
+    struct FrameDeflater::Impl {
+        zlib::deflate_stream Stream;
+    };
+
+    FrameDeflater::FrameDeflater(uint8_t stream, int level)
+        : m_Impl(std::make_unique<Impl>()), m_Stream(stream)
+    {
+        m_Impl->Stream.reset(level, kWindowBits, kMemLevel, zlib::Strategy::normal);
+    }
+
+    FrameDeflater::~FrameDeflater() = default;
+
+    bool FrameDeflater::Compress(const std::string& frame, std::string& out)
+    {
+        if (m_Broken || frame.empty() || frame.size() > kMaxInflatedSize) return false;
+        if (m_Rest > 0) {
+            --m_Rest;
+            return false;
+        }
+
+        auto& stream = m_Impl->Stream;
+        out.clear();
+        out.resize(kWireHeaderSize + 8 + stream.upper_bound(frame.size()) + 16);
+
+        zlib::z_params zs;
+        zs.next_in   = frame.data();
+        zs.avail_in  = frame.size();
+        zs.next_out  = &out[kWireHeaderSize + 8];
+        zs.avail_out = out.size() - kWireHeaderSize - 8;
+
+        // One sync flush with room for all of it: the frame ends on a
+        // byte boundary and the receiver can inflate it on its own
+        boost::beast::error_code ec;
+        stream.write(zs, zlib::Flush::sync, ec);
+
+        size_t produced = zs.total_out;
+        if ((ec && ec != zlib::error::need_buffers) || zs.avail_in != 0 || produced < 4 ||
+            out.compare(kWireHeaderSize + 8 + produced - 4, 4, kSyncTail, 4) != 0) {
+            // The stream is in an unknown state; the lane goes out raw
+            // from here on
+            m_Broken = true;
+            return false;
+        }
+        out.resize(kWireHeaderSize + 8 + produced - 4);
+
+        std::string header;
+        WireWriter  w(header);
+        w.U8(kWireMagic);
+        w.U8(kWireVersion);
+        w.U8(static_cast<uint8_t>(NetMsgType::Compressed));
+        w.U8(0);
+        w.U32(m_Stream);
+        w.U32(static_cast<uint32_t>(frame.size()));
+        out.replace(0, header.size(), header);
+
+        // Saved under a tenth: rest before trying again
+        if (out.size() * 10 > frame.size() * 9) {
+            m_Backoff = std::min(std::max(m_Backoff * 2, 1u), kMaxRest);
+            m_Rest    = m_Backoff;
+        } else {
+            m_Backoff = 0;
+        }
+        return true;
+    }
+
+    // =========================================================================
+    // FrameInflater
+    // =========================================================================
+
+    struct FrameInflater::Impl {
+        zlib::inflate_stream Stream;
+        std::string          Input;   // the deflate bytes plus kSyncTail
+    };
+
+    FrameInflater::FrameInflater()
+        : m_Impl(std::make_unique<Impl>())
+    {
+        m_Impl->Stream.reset(kWindowBits);
+    }
+
+    FrameInflater::~FrameInflater() = default;
+
+    bool FrameInflater::Expand(const NetMessage& compressed, std::string& frame)
+    {
+        if (compressed.Type != NetMsgType::Compressed || compressed.InflatedSize == 0 ||
+            compressed.InflatedSize > kMaxInflatedSize)
+            return false;
+
+        auto& input = m_Impl->Input;
+        input.assign(compressed.Blob);
+        input.append(kSyncTail, sizeof(kSyncTail));
+
+        // One spare byte: a frame that inflates past its announced size
+        // fills it and is caught
+        frame.resize(size_t(compressed.InflatedSize) + 1);
+
+        zlib::z_params zs;
+        zs.next_in   = input.data();
+        zs.avail_in  = input.size();
+        zs.next_out  = &frame[0];
+        zs.avail_out = frame.size();
+
+        boost::beast::error_code ec;
+        m_Impl->Stream.write(zs, zlib::Flush::sync, ec);
+
+        if ((ec && ec != zlib::error::need_buffers) || zs.avail_in != 0 ||
+            zs.total_out != compressed.InflatedSize)
+            return false;
+
+        frame.resize(zs.total_out);
+        return true;
+    }
+
+    void FrameInflater::Reset()
+    {
+        m_Impl->Stream.reset(kWindowBits);
+    }
+
+} // namespace Atometa
@@ -0,0 +1,70 @@
+#include "Atometa/Network/IOContextPool.h"
+#include "Atometa/Core/Logger.h"
+
+#include <algorithm>
+
+namespace asio = boost::asio;
+
+namespace Atometa {
+
+    IOContextPool::IOContextPool(size_t threadCount)
+    {
+        SetThreadCount(threadCount);
+    }
+
+    IOContextPool::~IOContextPool()
+    {
+        Stop();
+        Reset();
+    }
+
+    void IOContextPool::SetThreadCount(size_t count)
+    {
+        m_ThreadCount = std::clamp<size_t>(count, 1, kMaxThreads);
+    }
+
+    void IOContextPool::Start()
+    {
+        if (IsRunning()) return;
+
+        Reset();
+        for (size_t i = 0; i < m_ThreadCount; ++i) {
+            m_Contexts.push_back(std::make_unique<asio::io_context>(1));
+            m_Guards.push_back(asio::make_work_guard(*m_Contexts.back()));
+        }
+
+        for (auto& ctx : m_Contexts) {
+            m_Threads.emplace_back([ctx = ctx.get()]() {
+                for (;;) {
+                    try {
+                        ctx->run();
+                        break; // run() returns once stopped
+                    } catch (const std::exception& e) {
+                        ATOMETA_ERROR("IO context error: ", e.what());
+                    }
+                }
+            });
+        }
+    }
+
+    void IOContextPool::Stop()
+    {
+        m_Guards.clear();
+        for (auto& ctx : m_Contexts)
+            ctx->stop();
+
+        for (auto& t : m_Threads)
+            if (t.joinable()) t.join();
+        m_Threads.clear();
+    }
+
+    void IOContextPool::Reset()
+    {
+        // Destroying a context destroys its pending handlers, which release
+        // whatever they kept alive (sessions, sockets). Contexts go one by
+        // one, so a handler must only keep alive sockets of its own context.
+        m_Contexts.clear();
+        m_Next = 0;
+    }
+
+} // namespace Atometa
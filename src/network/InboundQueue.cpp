@@ -0,0 +1,90 @@
+#include "Atometa/Network/InboundQueue.h"
+
+#include <algorithm>
+
+namespace Atometa {
+
+    InboundQueue::InboundQueue(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+
+        m_Cells = std::make_unique<Cell[]>(size);
+        m_Mask  = size - 1;
+        for (size_t i = 0; i < size; ++i)
+            m_Cells[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Bounded MPMC ring (Vyukov) specialised to one consumer: a cell whose
+    // Sequence equals the producer's ticket is free, ticket + 1 means it
+    // holds a message, and the consumer hands it back one lap later.
+    bool InboundQueue::Push(const NetMessage& msg)
+    {
+        size_t pos = m_Head.load(std::memory_order_relaxed);
+        Cell*  cell;
+        for (;;) {
+            cell = &m_Cells[pos & m_Mask];
+            size_t   seq  = cell->Sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (m_Head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                ++m_Dropped;
+                return false;
+            } else {
+                pos = m_Head.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->Msg      = msg;
+        cell->PushedNs = NowNs();
+        cell->Sequence.store(pos + 1, std::memory_order_release);
+        ++m_Pushed;
+        return true;
+    }
+
+    bool InboundQueue::Pop(NetMessage& out)
+    {
+        int64_t pushedNs = 0;
+        if (!PopCell(out, pushedNs)) return false;
+
+        RecordLatency(pushedNs, NowNs());
+        ++m_ConsumerStats.Delivered;
+        return true;
+    }
+
+    bool InboundQueue::PopCell(NetMessage& out, int64_t& pushedNs)
+    {
+        Cell& cell = m_Cells[m_Tail & m_Mask];
+        if (cell.Sequence.load(std::memory_order_acquire) != m_Tail + 1)
+            return false;
+
+        out      = std::move(cell.Msg);
+        pushedNs = cell.PushedNs;
+        cell.Sequence.store(m_Tail + m_Mask + 1, std::memory_order_release);
+        ++m_Tail;
+        return true;
+    }
+
+    void InboundQueue::RecordLatency(int64_t pushedNs, int64_t nowNs)
+    {
+        auto&  s       = m_ConsumerStats;
+        double latency = std::max<int64_t>(0, nowNs - pushedNs) / 1000.0;
+        uint64_t n     = ++m_LatencySamples;
+
+        s.LastLatencyUs = latency;
+        s.MaxLatencyUs  = std::max(s.MaxLatencyUs, latency);
+        s.AvgLatencyUs += (latency - s.AvgLatencyUs) / static_cast<double>(n);
+    }
+
+    InboundQueueStats InboundQueue::GetStats() const
+    {
+        InboundQueueStats stats = m_ConsumerStats;
+        stats.Pushed  = m_Pushed.load();
+        stats.Dropped = m_Dropped.load();
+        return stats;
+    }
+
+} // namespace Atometa
@@ -0,0 +1,106 @@
+#include "Atometa/Network/Metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace Atometa {
+
+    // =========================================================================
+    // LatencyHistogram
+    // =========================================================================
+
+    void LatencyHistogram::Observe(uint64_t us)
+    {
+        auto   bound = std::lower_bound(kBoundsUs.begin(), kBoundsUs.end(), us);
+        size_t i     = static_cast<size_t>(bound - kBoundsUs.begin());
+        m_Counts[i].fetch_add(1, std::memory_order_relaxed);
+        m_SumUs.fetch_add(us, std::memory_order_relaxed);
+    }
+
+    LatencyHistogram::Snapshot LatencyHistogram::Read() const
+    {
+        Snapshot snapshot;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            snapshot.Counts[i] = m_Counts[i].load(std::memory_order_relaxed);
+            snapshot.Count    += snapshot.Counts[i];
+        }
+        snapshot.SumUs = m_SumUs.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    // =========================================================================
+    // MetricsText
+    // =========================================================================
+
+    void MetricsText::Family(const char* name, const char* type, const char* help)
+    {
+        m_Out += "# HELP ";
+        m_Out += name;
+        m_Out += ' ';
+        m_Out += help;
+        m_Out += "\n# TYPE ";
+        m_Out += name;
+        m_Out += ' ';
+        m_Out += type;
+        m_Out += '\n';
+    }
+
+    void MetricsText::Name(const char* name, const char* suffix, const std::string& labels)
+    {
+        m_Out += name;
+        m_Out += suffix;
+        if (!labels.empty()) {
+            m_Out += '{';
+            m_Out += labels;
+            m_Out += '}';
+        }
+        m_Out += ' ';
+    }
+
+    void MetricsText::Sample(const char* name, double value, const std::string& labels)
+    {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.9g", value);
+        Name(name, "", labels);
+        m_Out += text;
+        m_Out += '\n';
+    }
+
+    void MetricsText::Sample(const char* name, uint64_t value, const std::string& labels)
+    {
+        Name(name, "", labels);
+        m_Out += std::to_string(value);
+        m_Out += '\n';
+    }
+
+    void MetricsText::Histogram(const char* name, const LatencyHistogram::Snapshot& snapshot,
+                                const std::string& labels)
+    {
+        std::string prefix = labels.empty() ? "" : labels + ",";
+        uint64_t    total  = 0;
+
+        for (size_t i = 0; i < LatencyHistogram::kBuckets; ++i) {
+            char le[32];
+            if (i < LatencyHistogram::kBoundsUs.size())
+                std::snprintf(le, sizeof(le), "%g", LatencyHistogram::kBoundsUs[i] / 1e6);
+            else
+                std::snprintf(le, sizeof(le), "+Inf");
+
+            // Buckets are cumulative on the wire
+            total += snapshot.Counts[i];
+            Name(name, "_bucket", prefix + "le=\"" + le + "\"");
+            m_Out += std::to_string(total);
+            m_Out += '\n';
+        }
+
+        char sum[32];
+        std::snprintf(sum, sizeof(sum), "%.9g", snapshot.SumUs / 1e6);
+        Name(name, "_sum", labels);
+        m_Out += sum;
+        m_Out += '\n';
+        Name(name, "_count", labels);
+        m_Out += std::to_string(total);
+        m_Out += '\n';
+    }
+
+} // namespace Atometa
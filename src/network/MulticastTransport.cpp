@@ -0,0 +1,155 @@
+#include "Atometa/Network/MulticastTransport.h"
+
+#include <algorithm>
+
+namespace Atometa {
+
+    bool DecodeMulticast(const void* data, size_t size, MulticastHeader& header, NetMessage& msg)
+    {
+        WireReader reader(data, size);
+        if (reader.U8() != kMulticastMagic) return false;
+
+        header.Flags    = reader.U8();
+        reader.U16();
+        header.Stream   = reader.U32();
+        header.Sequence = reader.U32();
+        if (!reader.Ok()) return false;
+        if (header.IsHeartbeat()) return true;
+
+        return NetMessage::Deserialize(reader.Current(), reader.Remaining(), msg);
+    }
+
+    // =========================================================================
+    // MulticastSender
+    // =========================================================================
+
+    MulticastSender::MulticastSender(uint32_t stream)
+        : m_Stream(stream), m_History(kHistory)
+    {
+    }
+
+    std::string MulticastSender::Header(uint8_t flags, uint32_t sequence) const
+    {
+        std::string out;
+        WireWriter  writer(out);
+        writer.U8(kMulticastMagic);
+        writer.U8(flags);
+        writer.U16(0);
+        writer.U32(m_Stream);
+        writer.U32(sequence);
+        return out;
+    }
+
+    std::string MulticastSender::Encode(const NetMessage& msg)
+    {
+        std::string payload = msg.Serialize(WireFormat::Binary);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (payload.size() > kMaxMulticastPayload) {
+            ++m_Stats.Oversize;
+            return "";
+        }
+
+        uint32_t sequence = ++m_Sequence;
+        auto&    entry    = m_History[sequence % kHistory];
+        entry.Sequence = sequence;
+        entry.Msg      = msg;
+        m_Latest[static_cast<uint8_t>(msg.Type)] = sequence;
+
+        std::string datagram = Header(0, sequence) + payload;
+        ++m_Stats.Datagrams;
+        m_Stats.Bytes += datagram.size();
+        return datagram;
+    }
+
+    std::string MulticastSender::Heartbeat()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        ++m_Stats.Heartbeats;
+        m_Stats.Bytes += kMulticastHeaderSize;
+        return Header(kMulticastFlagHeartbeat, m_Sequence);
+    }
+
+    bool MulticastSender::Repair(uint32_t sequence, NetMessage& out)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        const auto& entry = m_History[sequence % kHistory];
+        if (sequence == 0 || entry.Sequence != sequence) return false;
+
+        if (m_Latest[static_cast<uint8_t>(entry.Msg.Type)] != sequence) {
+            ++m_Stats.Superseded;
+            return false;
+        }
+
+        out = entry.Msg;
+        ++m_Stats.Repaired;
+        return true;
+    }
+
+    MulticastSenderStats MulticastSender::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Stats;
+    }
+
+    // =========================================================================
+    // MulticastTracker
+    // =========================================================================
+
+    bool MulticastTracker::Accept(const MulticastHeader& header, std::vector<uint32_t>& nacks)
+    {
+        bool     heartbeat = header.IsHeartbeat();
+        uint32_t sequence  = header.Sequence;
+
+        if (heartbeat) ++m_Stats.Heartbeats;
+
+        // Joined mid-stream: whatever came before is covered by the join
+        // snapshot
+        if (!m_Started) {
+            m_Started = true;
+            m_Highest = sequence;
+            if (!heartbeat) ++m_Stats.Received;
+            return !heartbeat;
+        }
+
+        if (sequence > m_Highest) {
+            // A heartbeat names the last datagram sent, so it is missing
+            // too; a data datagram covers its own number
+            uint32_t last  = heartbeat ? sequence : sequence - 1;
+            uint32_t first = std::max(m_Highest + 1,
+                                      last >= kMaxNack ? last - kMaxNack + 1 : 1u);
+            for (uint32_t s = first; s <= last && s > m_Highest; ++s) {
+                m_Missing.insert(s);
+                nacks.push_back(s);
+                ++m_Stats.Lost;
+            }
+            while (m_Missing.size() > kMaxMissing)
+                m_Missing.erase(m_Missing.begin());
+
+            m_Highest = sequence;
+            if (heartbeat) return false;
+            ++m_Stats.Received;
+            return true;
+        }
+
+        if (heartbeat) return false;
+
+        if (m_Missing.erase(sequence)) {
+            ++m_Stats.Late;
+            ++m_Stats.Received;
+            return true;
+        }
+
+        ++m_Stats.Duplicates;
+        return false;
+    }
+
+    void MulticastTracker::Reset()
+    {
+        m_Started = false;
+        m_Highest = 0;
+        m_Missing.clear();
+        m_Stats   = MulticastTrackerStats();
+    }
+
+} // namespace Atometa
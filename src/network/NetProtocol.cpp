@@ -0,0 +1,750 @@
+#include "Atometa/Network/NetProtocol.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Atometa {
+
+    namespace {
+
+        bool IsKnownType(uint8_t type)
+        {
+            return type <= static_cast<uint8_t>(NetMsgType::Compressed);
+        }
+
+        // Json has no byte strings; AssetChunk bytes travel as hex there
+        std::string ToHex(const std::string& bytes)
+        {
+            static const char* digits = "0123456789abcdef";
+            std::string out;
+            out.reserve(bytes.size() * 2);
+            for (unsigned char c : bytes) {
+                out.push_back(digits[c >> 4]);
+                out.push_back(digits[c & 0xF]);
+            }
+            return out;
+        }
+
+        bool FromHex(const std::string& hex, std::string& out)
+        {
+            auto nibble = [](char c) -> int {
+                if (c >= '0' && c <= '9') return c - '0';
+                if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+                if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+                return -1;
+            };
+            if (hex.size() % 2) return false;
+
+            out.resize(hex.size() / 2);
+            for (size_t i = 0; i < out.size(); ++i) {
+                int hi = nibble(hex[2 * i]), lo = nibble(hex[2 * i + 1]);
+                if (hi < 0 || lo < 0) return false;
+                out[i] = static_cast<char>((hi << 4) | lo);
+            }
+            return true;
+        }
+
+        // ── Json (legacy text format) ────────────────────────────────────
+
+        json SceneToJson(const NetMessage& msg)
+        {
+            json nodes = json::array();
+            for (const auto& node : msg.Nodes) {
+                json n = { { "i", node.Index }, { "f", node.Fields } };
+                if (node.Fields & kNodeFieldPosition) n["pos"]     = node.Position;
+                if (node.Fields & kNodeFieldRotation) n["rot"]     = node.Rotation;
+                if (node.Fields & kNodeFieldScale)    n["scale"]   = node.Scale;
+                if (node.Fields & kNodeFieldVisible)  n["visible"] = node.Visible;
+                if (node.Fields & kNodeFieldName)     n["name"]    = node.Name;
+                nodes.push_back(std::move(n));
+            }
+            return {
+                { "seq",   msg.Sequence  },
+                { "count", msg.NodeCount },
+                { "sel",   msg.NodeIndex },
+                { "nodes", std::move(nodes) },
+            };
+        }
+
+        void SceneFromJson(const json& data, NetMessage& out)
+        {
+            out.Sequence  = data.at("seq").get<uint32_t>();
+            out.NodeCount = data.at("count").get<uint16_t>();
+            out.NodeIndex = data.value("sel", -1);
+
+            for (const auto& n : data.at("nodes")) {
+                NetNode node;
+                node.Index  = n.at("i").get<uint16_t>();
+                node.Fields = n.at("f").get<uint8_t>() & kNodeFieldAll;
+                if (node.Fields & kNodeFieldPosition) node.Position = n.at("pos").get<std::array<float, 3>>();
+                if (node.Fields & kNodeFieldRotation) node.Rotation = n.at("rot").get<std::array<float, 3>>();
+                if (node.Fields & kNodeFieldScale)    node.Scale    = n.at("scale").get<float>();
+                if (node.Fields & kNodeFieldVisible)  node.Visible  = n.at("visible").get<bool>();
+                if (node.Fields & kNodeFieldName)     node.Name     = n.at("name").get<std::string>();
+                out.Nodes.push_back(std::move(node));
+            }
+        }
+
+        json PointerToJson(const NetMessage& msg)
+        {
+            json points = json::array();
+            for (const auto& p : msg.Pointer)
+                points.push_back({ p.OffsetUs, p.Position[0], p.Position[1], p.Position[2] });
+            return {
+                { "seq", msg.Sequence  },
+                { "t",   msg.Timestamp },
+                { "pts", std::move(points) },
+            };
+        }
+
+        void PointerFromJson(const json& data, NetMessage& out)
+        {
+            out.Sequence  = data.value("seq", uint32_t(0));
+            out.Timestamp = data.value("t",   uint64_t(0));
+
+            for (const auto& p : data.at("pts")) {
+                NetPointerSample sample;
+                sample.OffsetUs = p.at(0).get<uint32_t>();
+                for (size_t i = 0; i < 3; ++i)
+                    sample.Position[i] = p.at(i + 1).get<float>();
+                out.Pointer.push_back(sample);
+            }
+        }
+
+        std::string SerializeJson(const NetMessage& msg)
+        {
+            json root;
+            root["type"] = static_cast<int>(msg.Type);
+
+            switch (msg.Type) {
+                case NetMsgType::CameraSync:
+                    root["data"] = {
+                        { "yaw",   msg.Camera.Yaw      },
+                        { "pitch", msg.Camera.Pitch    },
+                        { "dist",  msg.Camera.Distance },
+                    };
+                    if (msg.IsStamped()) {
+                        root["data"]["seq"] = msg.Sequence;
+                        root["data"]["t"]   = msg.Timestamp;
+                    }
+                    break;
+                case NetMsgType::NodeSelect:
+                    root["data"] = { { "index", msg.NodeIndex } };
+                    break;
+                case NetMsgType::Ping:
+                case NetMsgType::Pong:
+                    root["data"] = { { "t", msg.Timestamp } };
+                    if (msg.IsProbe()) {
+                        root["data"]["rtt"]  = msg.RoundTrip;
+                        root["data"]["echo"] = msg.EchoTimestamp;
+                    }
+                    break;
+                case NetMsgType::AssetChunk:
+                    root["data"] = {
+                        { "hash",  msg.ChunkHash   },
+                        { "bytes", ToHex(msg.Blob) },
+                    };
+                    break;
+                case NetMsgType::Fragment:
+                    root["data"] = {
+                        { "id",     msg.Sequence       },
+                        { "total",  msg.FragmentTotal  },
+                        { "offset", msg.FragmentOffset },
+                        { "bytes",  ToHex(msg.Blob)    },
+                    };
+                    break;
+                case NetMsgType::Compressed:
+                    root["data"] = {
+                        { "stream", msg.Sequence     },
+                        { "size",   msg.InflatedSize },
+                        { "bytes",  ToHex(msg.Blob)  },
+                    };
+                    break;
+                case NetMsgType::SceneSnapshot:
+                case NetMsgType::SceneDelta:
+                    root["data"] = SceneToJson(msg);
+                    break;
+                case NetMsgType::Pointer:
+                    root["data"] = PointerToJson(msg);
+                    break;
+                default:
+                    root["data"] = msg.Data;
+                    break;
+            }
+            return root.dump();
+        }
+
+        bool FromJson(const json& root, NetMessage& out)
+        {
+            try {
+                int  type = root.at("type").get<int>();
+                if (type < 0 || !IsKnownType(static_cast<uint8_t>(type)))
+                    return false;
+
+                out.Type = static_cast<NetMsgType>(type);
+                const json& data = root.at("data");
+
+                switch (out.Type) {
+                    case NetMsgType::CameraSync:
+                        out.Camera.Yaw      = data.value("yaw",   0.f);
+                        out.Camera.Pitch    = data.value("pitch", 0.f);
+                        out.Camera.Distance = data.value("dist",  10.f);
+                        out.Sequence        = data.value("seq",   uint32_t(0));
+                        out.Timestamp       = data.value("t",     uint64_t(0));
+                        break;
+                    case NetMsgType::NodeSelect:
+                        out.NodeIndex = data.value("index", -1);
+                        break;
+                    case NetMsgType::Ping:
+                    case NetMsgType::Pong:
+                        out.Timestamp     = data.value("t",    uint64_t(0));
+                        out.RoundTrip     = data.value("rtt",  uint32_t(0));
+                        out.EchoTimestamp = data.value("echo", uint64_t(0));
+                        break;
+                    case NetMsgType::AssetChunk:
+                        out.ChunkHash = data.at("hash").get<std::string>();
+                        if (!FromHex(data.at("bytes").get<std::string>(), out.Blob))
+                            return false;
+                        break;
+                    case NetMsgType::Fragment:
+                        out.Sequence       = data.at("id").get<uint32_t>();
+                        out.FragmentTotal  = data.at("total").get<uint32_t>();
+                        out.FragmentOffset = data.at("offset").get<uint32_t>();
+                        if (!FromHex(data.at("bytes").get<std::string>(), out.Blob))
+                            return false;
+                        break;
+                    case NetMsgType::Compressed:
+                        out.Sequence     = data.at("stream").get<uint32_t>();
+                        out.InflatedSize = data.at("size").get<uint32_t>();
+                        if (!FromHex(data.at("bytes").get<std::string>(), out.Blob))
+                            return false;
+                        break;
+                    case NetMsgType::SceneSnapshot:
+                    case NetMsgType::SceneDelta:
+                        SceneFromJson(data, out);
+                        break;
+                    case NetMsgType::Pointer:
+                        PointerFromJson(data, out);
+                        break;
+                    default:
+                        out.Data = data;
+                        break;
+                }
+                return true;
+            } catch (...) {
+                return false;
+            }
+        }
+
+        // SAX reader for the small fixed-layout frames that arrive many
+        // times a second (camera, selection, probes): fields go straight
+        // into the message and no DOM is built. Gives up at the first
+        // string, array or unknown key, which only the other types have;
+        // those take the DOM path.
+        class FlatJsonReader {
+        public:
+            bool null()                                 { return false; }
+            bool boolean(bool)                          { return false; }
+            bool number_integer(json::number_integer_t v)
+            {
+                return Number(static_cast<double>(v), v >= 0 ? static_cast<uint64_t>(v) : 0, v < 0);
+            }
+            bool number_unsigned(json::number_unsigned_t v)
+            {
+                return Number(static_cast<double>(v), v, false);
+            }
+            bool number_float(json::number_float_t v, const json::string_t&)
+            {
+                // Only the camera fields are fractional
+                if (m_Current != kYaw && m_Current != kPitch && m_Current != kDist) return false;
+                return Number(v, 0, false);
+            }
+            bool string(json::string_t&)                { return false; }
+            bool binary(json::binary_t&)                { return false; }
+            bool start_array(size_t)                    { return false; }
+            bool end_array()                            { return false; }
+            bool parse_error(size_t, const std::string&, const json::exception&) { return false; }
+
+            bool start_object(size_t)
+            {
+                if (m_Depth == 0 || (m_Depth == 1 && m_Current == kData)) {
+                    m_Seen[m_Current] = true;
+                    ++m_Depth;
+                    return true;
+                }
+                return false;
+            }
+
+            bool end_object()
+            {
+                --m_Depth;
+                return true;
+            }
+
+            bool key(json::string_t& k)
+            {
+                m_Current = m_Depth == 1 ? RootKey(k) : DataKey(k);
+                return m_Current != kNone;
+            }
+
+            // After a successful sax_parse; false leaves out untouched
+            bool Fill(NetMessage& out) const
+            {
+                if (!m_Seen[kType] || !m_Seen[kData] || m_Negative[kType] ||
+                    m_Unsigned[kType] > 0xFF)
+                    return false;
+
+                switch (static_cast<NetMsgType>(m_Unsigned[kType])) {
+                    case NetMsgType::CameraSync:
+                        out.Type            = NetMsgType::CameraSync;
+                        out.Camera.Yaw      = Float(kYaw,   0.f);
+                        out.Camera.Pitch    = Float(kPitch, 0.f);
+                        out.Camera.Distance = Float(kDist,  10.f);
+                        out.Sequence        = static_cast<uint32_t>(m_Unsigned[kSeq]);
+                        out.Timestamp       = m_Unsigned[kTime];
+                        return true;
+                    case NetMsgType::NodeSelect:
+                        out.Type      = NetMsgType::NodeSelect;
+                        out.NodeIndex = m_Seen[kIndex] ? static_cast<int32_t>(m_Float[kIndex]) : -1;
+                        return true;
+                    case NetMsgType::Ping:
+                    case NetMsgType::Pong:
+                        out.Type          = static_cast<NetMsgType>(m_Unsigned[kType]);
+                        out.Timestamp     = m_Unsigned[kTime];
+                        out.RoundTrip     = static_cast<uint32_t>(m_Unsigned[kRtt]);
+                        out.EchoTimestamp = m_Unsigned[kEcho];
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+
+        private:
+            enum Field { kNone, kType, kData, kYaw, kPitch, kDist, kSeq, kTime, kIndex, kRtt, kEcho, kFieldCount };
+
+            static Field RootKey(const std::string& k)
+            {
+                if (k == "type") return kType;
+                if (k == "data") return kData;
+                return kNone;
+            }
+
+            static Field DataKey(const std::string& k)
+            {
+                if (k == "yaw")   return kYaw;
+                if (k == "pitch") return kPitch;
+                if (k == "dist")  return kDist;
+                if (k == "seq")   return kSeq;
+                if (k == "t")     return kTime;
+                if (k == "index") return kIndex;
+                if (k == "rtt")   return kRtt;
+                if (k == "echo")  return kEcho;
+                return kNone;
+            }
+
+            bool Number(double f, uint64_t u, bool negative)
+            {
+                if (m_Current == kNone || m_Current == kData) return false;
+                m_Seen[m_Current]     = true;
+                m_Float[m_Current]    = f;
+                m_Unsigned[m_Current] = u;
+                m_Negative[m_Current] = negative;
+                return true;
+            }
+
+            float Float(Field f, float fallback) const
+            {
+                return m_Seen[f] ? static_cast<float>(m_Float[f]) : fallback;
+            }
+
+            int      m_Depth   = 0;
+            Field    m_Current = kNone;
+            bool     m_Seen[kFieldCount]     = {};
+            bool     m_Negative[kFieldCount] = {};
+            double   m_Float[kFieldCount]    = {};
+            uint64_t m_Unsigned[kFieldCount] = {};
+        };
+
+        bool DeserializeJson(const char* data, size_t size, NetMessage& out)
+        {
+            FlatJsonReader reader;
+            if (json::sax_parse(data, data + size, &reader) && reader.Fill(out))
+                return true;
+
+            json root = json::parse(data, data + size, nullptr, false);
+            return !root.is_discarded() && FromJson(root, out);
+        }
+
+        // ── Binary ───────────────────────────────────────────────────────
+
+        void WriteScene(WireWriter& w, const NetMessage& msg)
+        {
+            w.U32(msg.Sequence);
+            w.U16(msg.NodeCount);
+            w.I32(msg.NodeIndex);
+            w.U16(static_cast<uint16_t>(msg.Nodes.size()));
+
+            for (const auto& node : msg.Nodes) {
+                w.U16(node.Index);
+                w.U8(node.Fields & kNodeFieldAll);
+                if (node.Fields & kNodeFieldPosition)
+                    for (float v : node.Position) w.F32(v);
+                if (node.Fields & kNodeFieldRotation)
+                    for (float v : node.Rotation) w.F32(v);
+                if (node.Fields & kNodeFieldScale)   w.F32(node.Scale);
+                if (node.Fields & kNodeFieldVisible) w.U8(node.Visible ? 1 : 0);
+                if (node.Fields & kNodeFieldName) {
+                    size_t len = std::min<size_t>(node.Name.size(), 255);
+                    w.U8(static_cast<uint8_t>(len));
+                    w.Bytes(node.Name.data(), len);
+                }
+            }
+        }
+
+        bool ReadScene(WireReader& r, NetMessage& out)
+        {
+            out.Sequence  = r.U32();
+            out.NodeCount = r.U16();
+            out.NodeIndex = r.I32();
+            size_t updates = r.U16();
+
+            // Every update takes at least 3 bytes; don't trust the count
+            // further than the frame can back it
+            if (!r.Ok() || updates > r.Remaining() / 3) return false;
+            out.Nodes.resize(updates);
+
+            for (auto& node : out.Nodes) {
+                node.Index  = r.U16();
+                node.Fields = r.U8() & kNodeFieldAll;
+                if (node.Fields & kNodeFieldPosition)
+                    for (float& v : node.Position) v = r.F32();
+                if (node.Fields & kNodeFieldRotation)
+                    for (float& v : node.Rotation) v = r.F32();
+                if (node.Fields & kNodeFieldScale)   node.Scale   = r.F32();
+                if (node.Fields & kNodeFieldVisible) node.Visible = r.U8() != 0;
+                if (node.Fields & kNodeFieldName) {
+                    size_t len = r.U8();
+                    if (!r.Ok() || r.Remaining() < len) return false;
+                    node.Name.assign(reinterpret_cast<const char*>(r.Current()), len);
+                    r.Skip(len);
+                }
+            }
+            return r.Ok();
+        }
+
+        // Deltas are taken from the position the decoder will have rebuilt,
+        // not the exact previous sample, so rounding never accumulates
+        void WritePointer(WireWriter& w, const NetMessage& msg)
+        {
+            size_t count = std::min<size_t>(msg.Pointer.size(), 255);
+            w.U32(msg.Sequence);
+            w.U64(msg.Timestamp);
+            w.U8(static_cast<uint8_t>(count));
+            if (count == 0) return;
+
+            std::array<float, 3> prev = msg.Pointer[0].Position;
+            uint32_t             time = msg.Pointer[0].OffsetUs;
+            for (float v : prev) w.F32(v);
+
+            for (size_t n = 1; n < count; ++n) {
+                const auto& sample = msg.Pointer[n];
+                uint32_t    dt     = sample.OffsetUs > time ? sample.OffsetUs - time : 0;
+                uint16_t    ticks  = static_cast<uint16_t>(std::min<uint32_t>(
+                    (dt + kPointerTimeStepUs / 2) / kPointerTimeStepUs, UINT16_MAX));
+                w.U16(ticks);
+                time += ticks * kPointerTimeStepUs;
+
+                for (size_t i = 0; i < 3; ++i) {
+                    float   steps = std::round((sample.Position[i] - prev[i]) / kPointerStep);
+                    int16_t d     = static_cast<int16_t>(std::clamp(steps, -32767.f, 32767.f));
+                    w.U16(static_cast<uint16_t>(d));
+                    prev[i] += d * kPointerStep;
+                }
+            }
+        }
+
+        bool ReadPointer(WireReader& r, NetMessage& out)
+        {
+            out.Sequence  = r.U32();
+            out.Timestamp = r.U64();
+            size_t count  = r.U8();
+            if (!r.Ok()) return false;
+            if (count == 0) return true;
+            if (r.Remaining() < 12 + (count - 1) * 8) return false;
+
+            out.Pointer.resize(count);
+            NetPointerSample* prev = &out.Pointer[0];
+            for (float& v : prev->Position) v = r.F32();
+
+            for (size_t n = 1; n < count; ++n) {
+                NetPointerSample& sample = out.Pointer[n];
+                sample.OffsetUs = prev->OffsetUs + r.U16() * kPointerTimeStepUs;
+                for (size_t i = 0; i < 3; ++i)
+                    sample.Position[i] = prev->Position[i]
+                                       + static_cast<int16_t>(r.U16()) * kPointerStep;
+                prev = &sample;
+            }
+            return r.Ok();
+        }
+
+        std::string SerializeBinary(const NetMessage& msg)
+        {
+            std::string out;
+            out.reserve(kWireHeaderSize + 24);
+
+            bool isPing  = msg.Type == NetMsgType::Ping || msg.Type == NetMsgType::Pong;
+            bool stamped = msg.Type == NetMsgType::CameraSync && msg.IsStamped();
+            bool probe   = isPing && msg.IsProbe();
+
+            WireWriter w(out);
+            w.U8(kWireMagic);
+            w.U8(kWireVersion);
+            w.U8(static_cast<uint8_t>(msg.Type));
+            w.U8((stamped ? kWireFlagStamped : 0) | (probe ? kWireFlagProbe : 0));
+
+            switch (msg.Type) {
+                case NetMsgType::CameraSync:
+                    w.F32(msg.Camera.Yaw);
+                    w.F32(msg.Camera.Pitch);
+                    w.F32(msg.Camera.Distance);
+                    if (stamped) {
+                        w.U32(msg.Sequence);
+                        w.U64(msg.Timestamp);
+                    }
+                    break;
+                case NetMsgType::NodeSelect:
+                    w.I32(msg.NodeIndex);
+                    break;
+                case NetMsgType::Ping:
+                    w.U64(msg.Timestamp);
+                    if (probe) w.U32(msg.RoundTrip);
+                    break;
+                case NetMsgType::Pong:
+                    w.U64(msg.Timestamp);
+                    if (probe) w.U64(msg.EchoTimestamp);
+                    break;
+                case NetMsgType::AssetChunk:
+                    out.reserve(kWireHeaderSize + 1 + msg.ChunkHash.size() + msg.Blob.size());
+                    w.U8(static_cast<uint8_t>(msg.ChunkHash.size()));
+                    w.Bytes(msg.ChunkHash.data(), msg.ChunkHash.size());
+                    w.Bytes(msg.Blob.data(), msg.Blob.size());
+                    break;
+                case NetMsgType::Fragment:
+                    out.reserve(kFragmentHeaderSize + msg.Blob.size());
+                    w.U32(msg.Sequence);
+                    w.U32(msg.FragmentTotal);
+                    w.U32(msg.FragmentOffset);
+                    w.Bytes(msg.Blob.data(), msg.Blob.size());
+                    break;
+                case NetMsgType::Compressed:
+                    out.reserve(kWireHeaderSize + 8 + msg.Blob.size());
+                    w.U32(msg.Sequence);
+                    w.U32(msg.InflatedSize);
+                    w.Bytes(msg.Blob.data(), msg.Blob.size());
+                    break;
+                case NetMsgType::Batch:
+                    w.Bytes(msg.Blob.data(), msg.Blob.size());
+                    break;
+                case NetMsgType::SceneSnapshot:
+                case NetMsgType::SceneDelta:
+                    WriteScene(w, msg);
+                    break;
+                case NetMsgType::Pointer:
+                    out.reserve(kWireHeaderSize + 25 + 8 * msg.Pointer.size());
+                    WritePointer(w, msg);
+                    break;
+                default: {
+                    std::string text = msg.Data.dump();
+                    w.Bytes(text.data(), text.size());
+                    break;
+                }
+            }
+            return out;
+        }
+
+        bool DeserializeBinary(const void* data, size_t size, NetMessage& out)
+        {
+            WireReader r(data, size);
+            uint8_t magic   = r.U8();
+            uint8_t version = r.U8();
+            uint8_t type    = r.U8();
+            uint8_t flags   = r.U8();
+
+            if (!r.Ok() || magic != kWireMagic || version != kWireVersion ||
+                !IsKnownType(type))
+                return false;
+
+            out.Type = static_cast<NetMsgType>(type);
+
+            switch (out.Type) {
+                case NetMsgType::CameraSync:
+                    out.Camera.Yaw      = r.F32();
+                    out.Camera.Pitch    = r.F32();
+                    out.Camera.Distance = r.F32();
+                    if (flags & kWireFlagStamped) {
+                        out.Sequence  = r.U32();
+                        out.Timestamp = r.U64();
+                    }
+                    break;
+                case NetMsgType::NodeSelect:
+                    out.NodeIndex = r.I32();
+                    break;
+                case NetMsgType::Ping:
+                    out.Timestamp = r.U64();
+                    if (flags & kWireFlagProbe) out.RoundTrip = r.U32();
+                    break;
+                case NetMsgType::Pong:
+                    out.Timestamp = r.U64();
+                    if (flags & kWireFlagProbe) out.EchoTimestamp = r.U64();
+                    break;
+                case NetMsgType::AssetChunk: {
+                    size_t hashLen = r.U8();
+                    if (!r.Ok() || r.Remaining() < hashLen) return false;
+                    const char* p = reinterpret_cast<const char*>(r.Current());
+                    out.ChunkHash.assign(p, hashLen);
+                    out.Blob.assign(p + hashLen, r.Remaining() - hashLen);
+                    break;
+                }
+                case NetMsgType::Fragment:
+                    out.Sequence       = r.U32();
+                    out.FragmentTotal  = r.U32();
+                    out.FragmentOffset = r.U32();
+                    if (!r.Ok()) return false;
+                    out.Blob.assign(reinterpret_cast<const char*>(r.Current()), r.Remaining());
+                    break;
+                case NetMsgType::Compressed:
+                    out.Sequence     = r.U32();
+                    out.InflatedSize = r.U32();
+                    if (!r.Ok()) return false;
+                    out.Blob.assign(reinterpret_cast<const char*>(r.Current()), r.Remaining());
+                    break;
+                case NetMsgType::Batch:
+                    out.Blob.assign(reinterpret_cast<const char*>(r.Current()), r.Remaining());
+                    break;
+                case NetMsgType::SceneSnapshot:
+                case NetMsgType::SceneDelta:
+                    if (!ReadScene(r, out)) return false;
+                    break;
+                case NetMsgType::Pointer:
+                    if (!ReadPointer(r, out)) return false;
+                    break;
+                default:
+                    try {
+                        const char* text = reinterpret_cast<const char*>(r.Current());
+                        out.Data = json::parse(text, text + r.Remaining());
+                    } catch (...) {
+                        return false;
+                    }
+                    break;
+            }
+            return r.Ok();
+        }
+
+    } // namespace
+
+    // =========================================================================
+    // NetMessage serialization
+    // =========================================================================
+
+    std::string NetMessage::Serialize(WireFormat format) const
+    {
+        return format == WireFormat::Binary ? SerializeBinary(*this)
+                                            : SerializeJson(*this);
+    }
+
+    std::string EncodeFragmentHeader(uint32_t id, uint32_t total, uint32_t offset)
+    {
+        std::string out;
+        out.reserve(kFragmentHeaderSize);
+
+        WireWriter w(out);
+        w.U8(kWireMagic);
+        w.U8(kWireVersion);
+        w.U8(static_cast<uint8_t>(NetMsgType::Fragment));
+        w.U8(0);
+        w.U32(id);
+        w.U32(total);
+        w.U32(offset);
+        return out;
+    }
+
+    std::string EncodeBatch(WireFormat format, const std::vector<std::string>& frames)
+    {
+        size_t size = 0;
+        for (const auto& frame : frames) size += frame.size() + 4;
+
+        std::string out;
+        if (format == WireFormat::Json) {
+            out.reserve(size + 24);
+            out += "{\"type\":";
+            out += std::to_string(static_cast<int>(NetMsgType::Batch));
+            out += ",\"data\":[";
+            for (size_t i = 0; i < frames.size(); ++i) {
+                if (i) out += ',';
+                out += frames[i];
+            }
+            out += "]}";
+            return out;
+        }
+
+        out.reserve(kWireHeaderSize + size);
+        WireWriter w(out);
+        w.U8(kWireMagic);
+        w.U8(kWireVersion);
+        w.U8(static_cast<uint8_t>(NetMsgType::Batch));
+        w.U8(0);
+        for (const auto& frame : frames) {
+            w.U32(static_cast<uint32_t>(frame.size()));
+            w.Bytes(frame.data(), frame.size());
+        }
+        return out;
+    }
+
+    bool UnpackBatch(const NetMessage& batch, std::vector<NetMessage>& out)
+    {
+        if (batch.Type != NetMsgType::Batch) return false;
+
+        auto nested = [](const NetMessage& msg) {
+            return msg.Type == NetMsgType::Batch || msg.Type == NetMsgType::Fragment ||
+                   msg.Type == NetMsgType::Compressed;
+        };
+
+        if (batch.Data.is_array()) {
+            out.reserve(batch.Data.size());
+            for (const auto& item : batch.Data) {
+                out.emplace_back();
+                if (!FromJson(item, out.back()) || nested(out.back())) return false;
+            }
+            return true;
+        }
+
+        WireReader r(batch.Blob.data(), batch.Blob.size());
+        while (r.Remaining() > 0) {
+            size_t length = r.U32();
+            if (!r.Ok() || length > r.Remaining()) return false;
+
+            const uint8_t* frame = r.Current();
+            r.Skip(length);
+            out.emplace_back();
+            if (!NetMessage::Deserialize(frame, length, out.back()) || nested(out.back())) return false;
+        }
+        return r.Ok();
+    }
+
+    bool NetMessage::Deserialize(const std::string& raw, NetMessage& out)
+    {
+        return Deserialize(raw.data(), raw.size(), out);
+    }
+
+    bool NetMessage::Deserialize(const void* data, size_t size, NetMessage& out)
+    {
+        if (size == 0) return false;
+
+        const char* text = static_cast<const char*>(data);
+        if (static_cast<uint8_t>(text[0]) == kWireMagic)
+            return DeserializeBinary(data, size, out);
+
+        return DeserializeJson(text, size, out);
+    }
+
+} // namespace Atometa
@@ -5,7 +5,20 @@
 #include <boost/beast/websocket.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/ip/tcp.hpp>
-
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/ip/multicast.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <iterator>
+#include <random>
 #include <sstream>
 
 namespace beast = boost::beast;
@@ -13,206 +26,2391 @@ namespace http  = beast::http;
 namespace ws    = beast::websocket;
 namespace asio  = boost::asio;
 using     tcp   = asio::ip::tcp;
+using     udp   = asio::ip::udp;
 
 namespace Atometa {
 
+    namespace {
+
+        // Picks the wire format from a Sec-WebSocket-Protocol offer such as
+        // "atometa.bin.v1, atometa.json". Binary wins whenever it is offered.
+        WireFormat NegotiateFormat(beast::string_view offered)
+        {
+            std::string list(offered);
+            std::istringstream iss(list);
+            std::string token;
+            while (std::getline(iss, token, ',')) {
+                auto first = token.find_first_not_of(" \t");
+                auto last  = token.find_last_not_of(" \t");
+                if (first == std::string::npos) continue;
+                if (token.compare(first, last - first + 1, kBinarySubprotocol) == 0)
+                    return WireFormat::Binary;
+            }
+            return WireFormat::Json;
+        }
+
+        // Relay upstream target: "/publish" or "/publish?key=<key>"
+        bool IsPublishTarget(beast::string_view target)
+        {
+            return target == "/publish" || target.starts_with("/publish?");
+        }
+
+        // Value of name in the target's query string ("" if absent)
+        std::string QueryValue(beast::string_view target, beast::string_view name)
+        {
+            auto query = target.find('?');
+            while (query != beast::string_view::npos) {
+                auto start = query + 1;
+                auto end   = target.find('&', start);
+                auto pair  = target.substr(start, end == beast::string_view::npos
+                                                  ? beast::string_view::npos : end - start);
+                if (pair.size() > name.size() && pair.starts_with(name) && pair[name.size()] == '=')
+                    return std::string(pair.substr(name.size() + 1));
+                query = end;
+            }
+            return "";
+        }
+
+        bool PublishKeyMatches(beast::string_view target, const std::string& key)
+        {
+            return key.empty() || QueryValue(target, "key") == key;
+        }
+
+        std::string PublishTarget(const std::string& key)
+        {
+            return key.empty() ? "/publish" : "/publish?key=" + key;
+        }
+
+        void OfferSubprotocols(ws::stream<tcp::socket>& socket, bool compress = false)
+        {
+            // Offer binary first; hosts that predate it ignore the header
+            // and keep talking Json. The same goes for compression.
+            socket.set_option(ws::stream_base::decorator(
+                [compress](ws::request_type& req) {
+                    req.set(http::field::sec_websocket_protocol,
+                            std::string(kBinarySubprotocol) + ", " + kJsonSubprotocol);
+                    if (compress)
+                        req.set(kCompressHeader, kCompressDeflate);
+                }));
+        }
+
+        WireFormat AcceptedFormat(const ws::response_type& res)
+        {
+            return res[http::field::sec_websocket_protocol] == kBinarySubprotocol
+                 ? WireFormat::Binary : WireFormat::Json;
+        }
+
+        // Probe clock (µs). Only differences and offsets between peers'
+        // values are meaningful.
+        uint64_t NowMicros()
+        {
+            return static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // The host's stream, which a tree relay passes on as received.
+        // Per-connection traffic (join info, probes, assets, control) is
+        // answered by the relay itself.
+        bool IsRelayedType(NetMsgType type)
+        {
+            switch (type) {
+                case NetMsgType::CameraSync:
+                case NetMsgType::NodeSelect:
+                case NetMsgType::Pointer:
+                case NetMsgType::ChatMessage:
+                case NetMsgType::SceneSnapshot:
+                case NetMsgType::SceneDelta:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        json TreeAddressToJson(const TreeAddress& address)
+        {
+            return { { "host", address.Host }, { "port", address.Port } };
+        }
+
+        bool TreeAddressFromJson(const json& j, TreeAddress& out)
+        {
+            if (!j.is_object() || !j.contains("host") || !j["host"].is_string() ||
+                !j.contains("port") || !j["port"].is_number_unsigned())
+                return false;
+            out.Host = j["host"].get<std::string>();
+            out.Port = j["port"].get<uint16_t>();
+            return !out.Host.empty() && out.Port != 0;
+        }
+
+        // Feeds a Fragment to the connection's assembler and swaps in the
+        // frame it completes. True if msg now holds a whole message.
+        bool Reassemble(FragmentAssembler& assembler, NetMessage& msg)
+        {
+            if (msg.Type != NetMsgType::Fragment) return true;
+
+            std::string frame;
+            switch (assembler.Add(msg, frame)) {
+                case FragmentAssembler::Result::Complete:
+                    return NetMessage::Deserialize(frame, msg) && msg.Type != NetMsgType::Fragment;
+                case FragmentAssembler::Result::Invalid:
+                    ATOMETA_WARN("Dropped out-of-order fragment ", msg.Sequence);
+                    return false;
+                default:
+                    return false;
+            }
+        }
+
+    } // namespace
+
+    // =========================================================================
+    // RttWindow — the last kSize round-trip probes of one peer. Written on
+    // an io thread, summarized from anywhere.
+    // =========================================================================
+
+    struct NetworkLayer::RttWindow {
+        static constexpr size_t kSize = 64;
+
+        void Add(uint32_t rttUs, int64_t offsetUs)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Rtt[Next]    = rttUs;
+            Offset[Next] = offsetUs;
+            Next   = (Next + 1) % kSize;
+            Count  = std::min(Count + 1, kSize);
+            Latest = rttUs;
+        }
+
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Count = Next = 0;
+            Latest = 0;
+        }
+
+        uint32_t GetLatest() const
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            return Latest;
+        }
+
+        RoundTripStats Summary() const
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            RoundTripStats stats;
+            if (Count == 0) return stats;
+
+            std::array<uint32_t, kSize> sorted;
+            std::copy(Rtt.begin(), Rtt.begin() + Count, sorted.begin());
+            std::sort(sorted.begin(), sorted.begin() + Count);
+
+            uint64_t sum = 0;
+            for (size_t i = 0; i < Count; ++i) sum += sorted[i];
+
+            // The fastest probe had the least queuing, so its offset is
+            // the most trustworthy
+            size_t best = std::min_element(Rtt.begin(), Rtt.begin() + Count) - Rtt.begin();
+            size_t p99  = std::min(Count - 1, (Count * 99 + 99) / 100 - 1);
+
+            stats.Samples       = static_cast<uint32_t>(Count);
+            stats.MinMs         = sorted[0] / 1000.f;
+            stats.AvgMs         = static_cast<float>(sum) / Count / 1000.f;
+            stats.P99Ms         = sorted[p99] / 1000.f;
+            stats.ClockOffsetMs = Offset[best] / 1000.f;
+            return stats;
+        }
+
+        mutable std::mutex           Mutex;
+        std::array<uint32_t, kSize>  Rtt{};
+        std::array<int64_t,  kSize>  Offset{};
+        size_t                       Count  = 0;
+        size_t                       Next   = 0;
+        uint32_t                     Latest = 0;
+    };
+
+    // =========================================================================
+    // AssetOffer — the host's store plus its manifest, encoded once per
+    // wire format
+    // =========================================================================
+
+    struct NetworkLayer::AssetOffer {
+        std::shared_ptr<const AssetStore> Store;
+        SharedPayload                     Manifest[2];
+    };
+
+    // =========================================================================
+    // JoinState — what a student needs for its first correct frame, kept
+    // current as the host sends and encoded lazily: 300 students joining
+    // at once share one encoding of each frame. The last kHistory deltas
+    // are kept too, so a student that dropped out briefly catches up on
+    // what it missed instead of taking the whole snapshot again.
+    // =========================================================================
+
+    struct NetworkLayer::JoinState {
+        static constexpr size_t kHistory = 256;
+
+        struct Frame {
+            SharedPayload Payload;
+            NetMsgType    Type;
+        };
+
+        // Where a reconnecting student left off (from its upgrade request)
+        struct Resume {
+            std::string Token;
+            uint32_t    Sequence = 0;
+        };
+
+        JoinState()
+        {
+            // Tells this host's delta stream apart from any other, so
+            // sequence numbers from another session are never resumed
+            std::random_device rd;
+            char prefix[17];
+            std::snprintf(prefix, sizeof(prefix), "%08x%08x", rd(), rd());
+            Prefix = prefix;
+        }
+
+        // Called before msg is fanned out, so a student that joins in
+        // between gets a snapshot already covering it
+        void Track(const NetMessage& msg)
+        {
+            if (msg.Type != NetMsgType::CameraSync &&
+                msg.Type != NetMsgType::SceneSnapshot && msg.Type != NetMsgType::SceneDelta)
+                return;
+
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (msg.Type == NetMsgType::CameraSync) {
+                Camera    = msg;
+                HasCamera = true;
+                CameraEncoded[0].reset();
+                CameraEncoded[1].reset();
+            } else if (Scene.Apply(msg)) {
+                SceneEncoded[0].reset();
+                SceneEncoded[1].reset();
+
+                // A snapshot or a restarted stream begins a new epoch:
+                // older sequence numbers no longer line up
+                if (msg.Type == NetMsgType::SceneSnapshot || msg.Sequence == 1) {
+                    ++Epoch;
+                    History.clear();
+                }
+                if (msg.Type == NetMsgType::SceneDelta) {
+                    History.push_back(msg);
+                    if (History.size() > kHistory) History.pop_front();
+                }
+            }
+            InfoEncoded[0].reset();
+            InfoEncoded[1].reset();
+        }
+
+        // SessionInfo, then either the deltas a resuming student missed
+        // (if no more than maxDeltas) or the full scene, then the camera.
+        // Just the SessionInfo before the host has sent any state.
+        std::vector<Frame> Frames(WireFormat format, const Resume& resume,
+                                  size_t maxDeltas, bool& resumed)
+        {
+            size_t f = static_cast<size_t>(format);
+            std::lock_guard<std::mutex> lock(Mutex);
+            resumed = false;
+
+            std::vector<Frame> frames;
+            frames.push_back({ nullptr, NetMsgType::SessionInfo });
+
+            uint32_t current = Scene.GetSequence();
+            uint32_t oldest  = History.empty() ? current + 1 : History.front().Sequence;
+            if (Scene.HasState() && resume.Token == Token() &&
+                resume.Sequence <= current && resume.Sequence + 1 >= oldest &&
+                current - resume.Sequence <= maxDeltas) {
+                resumed = true;
+                for (const auto& delta : History)
+                    if (delta.Sequence > resume.Sequence)
+                        frames.push_back({ std::make_shared<const std::string>(delta.Serialize(format)),
+                                           NetMsgType::SceneDelta });
+            } else if (Scene.HasState()) {
+                if (!SceneEncoded[f])
+                    SceneEncoded[f] = std::make_shared<const std::string>(
+                        Scene.ToSnapshot().Serialize(format));
+                frames.push_back({ SceneEncoded[f], NetMsgType::SceneSnapshot });
+            }
+
+            if (HasCamera) {
+                if (!CameraEncoded[f])
+                    CameraEncoded[f] = std::make_shared<const std::string>(Camera.Serialize(format));
+                frames.push_back({ CameraEncoded[f], NetMsgType::CameraSync });
+            }
+
+            if (resumed) {
+                frames[0].Payload = std::make_shared<const std::string>(
+                    Info(resumed, frames.size() - 1 - (HasCamera ? 1 : 0)).Serialize(format));
+            } else {
+                if (!InfoEncoded[f])
+                    InfoEncoded[f] = std::make_shared<const std::string>(
+                        Info(false, 0).Serialize(format));
+                frames[0].Payload = InfoEncoded[f];
+            }
+            return frames;
+        }
+
+        // Tree relay: serve the upstream stream under its own token, so a
+        // student can resume at any node that has passed on the same
+        // deltas. Dropped as soon as this node starts an epoch of its own.
+        void Adopt(const std::string& token)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Adopted      = token;
+            AdoptedEpoch = Epoch;
+            InfoEncoded[0].reset();
+            InfoEncoded[1].reset();
+        }
+
+        // Tree relay: this node's ancestors, root first, plus this node's
+        // parent — the addresses a student climbs if this node leaves
+        void SetTree(json path)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            TreePath = std::move(path);
+            InfoEncoded[0].reset();
+            InfoEncoded[1].reset();
+        }
+
+        // Group advertised in SessionInfo (null = unicast only)
+        void SetMulticast(json advert)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Multicast = std::move(advert);
+            InfoEncoded[0].reset();
+            InfoEncoded[1].reset();
+        }
+
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            HasCamera = false;
+            Scene.Reset();
+            History.clear();
+            Adopted.clear();
+            TreePath = json();
+            ++Epoch;
+            for (auto* encoded : { InfoEncoded, SceneEncoded, CameraEncoded })
+                for (size_t f = 0; f < 2; ++f)
+                    encoded[f].reset();
+        }
+
+        // Session token a student presents when it reconnects
+        std::string Token() const
+        {
+            if (!Adopted.empty() && Epoch == AdoptedEpoch) return Adopted;
+            return Prefix + "-" + std::to_string(Epoch);
+        }
+
+        NetMessage Info(bool resumed, size_t deltas) const
+        {
+            NetMessage info;
+            info.Type = NetMsgType::SessionInfo;
+            info.Data = {
+                { "version", kWireVersion     },
+                { "session", Token()          },
+                { "camera",  HasCamera        },
+                { "scene",   Scene.HasState() },
+            };
+            if (resumed) {
+                info.Data["resumed"] = true;
+                info.Data["deltas"]  = deltas;
+            }
+            if (!Multicast.is_null())
+                info.Data["multicast"] = Multicast;
+            if (!TreePath.is_null())
+                info.Data["tree"] = { { "path", TreePath } };
+            return info;
+        }
+
+        std::mutex             Mutex;
+        std::string            Prefix;
+        uint64_t               Epoch     = 0;
+        NetMessage             Camera;
+        bool                   HasCamera = false;
+        SceneMirror            Scene;
+        std::deque<NetMessage> History;   // SceneDeltas, oldest first
+        json                   Multicast;
+        std::string            Adopted;
+        uint64_t               AdoptedEpoch = 0;
+        json                   TreePath;
+        SharedPayload          InfoEncoded[2], SceneEncoded[2], CameraEncoded[2];
+    };
+
+    // =========================================================================
+    // MulticastChannel — the host's side of the multicast group. Frames are
+    // sent straight from the broadcasting thread (one non-blocking send_to,
+    // whatever the class size); heartbeats run on the first io thread.
+    // =========================================================================
+
+    struct NetworkLayer::MulticastChannel
+        : public std::enable_shared_from_this<MulticastChannel>
+    {
+        static constexpr auto kHeartbeat = std::chrono::milliseconds(250);
+
+        MulticastChannel(asio::io_context& io, MulticastConfig config, uint32_t stream)
+            : Config(std::move(config)), Sender(stream), Socket(io), Timer(io)
+        {
+        }
+
+        // Throws on a bad group / interface address or socket error
+        void Open()
+        {
+            auto group = asio::ip::make_address_v4(Config.Group);
+            if (!group.is_multicast())
+                throw std::runtime_error(Config.Group + " is not a multicast address");
+
+            Group = udp::endpoint(group, Config.Port);
+            Socket.open(udp::v4());
+            Socket.set_option(asio::ip::multicast::hops(Config.Ttl));
+            Socket.set_option(asio::ip::multicast::enable_loopback(true));
+            if (!Config.Interface.empty())
+                Socket.set_option(asio::ip::multicast::outbound_interface(
+                    asio::ip::make_address_v4(Config.Interface)));
+            Socket.non_blocking(true);
+        }
+
+        json Advert() const
+        {
+            return { { "group",  Config.Group      },
+                     { "port",   Config.Port       },
+                     { "stream", Sender.GetStream() } };
+        }
+
+        // Any thread. A full socket buffer drops the datagram; students
+        // NACK it like any other loss.
+        bool Send(const NetMessage& msg, size_t& bytes)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            std::string datagram = Sender.Encode(msg);
+            if (datagram.empty()) return false;
+
+            beast::error_code ec;
+            Socket.send_to(asio::buffer(datagram), Group, 0, ec);
+            bytes = datagram.size();
+            return true;
+        }
+
+        void ScheduleHeartbeat()
+        {
+            Timer.expires_after(kHeartbeat);
+            Timer.async_wait([self = shared_from_this()](beast::error_code ec) {
+                if (ec) return;
+                {
+                    std::lock_guard<std::mutex> lock(self->Mutex);
+                    beast::error_code sendEc;
+                    self->Socket.send_to(asio::buffer(self->Sender.Heartbeat()),
+                                         self->Group, 0, sendEc);
+                }
+                self->ScheduleHeartbeat();
+            });
+        }
+
+        // After the io threads have stopped
+        void Close()
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            beast::error_code ec;
+            Timer.cancel();
+            Socket.close(ec);
+        }
+
+        MulticastConfig    Config;
+        MulticastSender    Sender;
+        std::mutex         Mutex;    // keeps datagrams in sequence order
+        udp::socket        Socket;
+        udp::endpoint      Group;
+        asio::steady_timer Timer;
+    };
+
+    // =========================================================================
+    // TickBatch — broadcasts held for the next tick. Its timer runs on the
+    // pool's first io thread for as long as the host listens; with no tick
+    // rate set it only idles.
+    // =========================================================================
+
+    struct NetworkLayer::TickBatch
+        : public std::enable_shared_from_this<TickBatch>
+    {
+        static constexpr auto kIdle = std::chrono::milliseconds(100);
+
+        struct Entry {
+            NetMessage Msg;
+            bool       Multicast = false;   // also went to the group
+        };
+
+        explicit TickBatch(asio::io_context& io)
+            : Timer(io)
+        {
+        }
+
+        // Any thread. Only the newest camera of a tick is worth sending.
+        void Add(const NetMessage& msg, bool multicast)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (msg.Type == NetMsgType::CameraSync) {
+                for (auto& entry : Pending) {
+                    if (entry.Msg.Type == NetMsgType::CameraSync) {
+                        entry = { msg, multicast };
+                        return;
+                    }
+                }
+            }
+            Pending.push_back({ msg, multicast });
+        }
+
+        std::vector<Entry> Take()
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            std::vector<Entry> out;
+            out.swap(Pending);
+            return out;
+        }
+
+        void Schedule(NetworkLayer* owner)
+        {
+            uint32_t hz = owner->m_TickRate.load();
+            std::chrono::microseconds period = kIdle;
+            if (hz) period = std::chrono::microseconds(std::max(1000000u / hz, 1u));
+
+            Timer.expires_after(period);
+            Timer.async_wait([self = shared_from_this(), owner](beast::error_code ec) {
+                if (ec) return;
+                owner->FlushTick();
+                self->Schedule(owner);
+            });
+        }
+
+        // After the io threads have stopped
+        void Close()
+        {
+            Timer.cancel();
+        }
+
+        std::mutex         Mutex;
+        std::vector<Entry> Pending;
+        asio::steady_timer Timer;
+    };
+
+    // =========================================================================
+    // MulticastListener — the student's side: joins the advertised group on
+    // the interface that reaches the host and runs its own io thread, so
+    // datagrams are never stuck behind the blocking WebSocket read. What to
+    // tell the host (subscribe, NACKs) is picked up by the client thread.
+    // =========================================================================
+
+    struct NetworkLayer::MulticastListener {
+        // Silence after which unicast is asked for again (the host sends a
+        // heartbeat every 250 ms)
+        static constexpr auto kSilence = std::chrono::seconds(2);
+
+        MulticastListener(NetworkLayer* owner, udp::endpoint group,
+                          asio::ip::address_v4 iface, uint32_t stream)
+            : Owner(owner), Group(group), Interface(iface), Stream(stream)
+        {
+        }
+
+        ~MulticastListener()
+        {
+            Context.stop();
+            if (Thread.joinable()) Thread.join();
+        }
+
+        // Throws if the group cannot be joined
+        void Start()
+        {
+            Socket.open(udp::v4());
+            Socket.set_option(udp::socket::reuse_address(true));
+            Socket.bind(udp::endpoint(asio::ip::address_v4::any(), Group.port()));
+            Socket.set_option(asio::ip::multicast::join_group(Group.address().to_v4(), Interface));
+
+            DoReceive();
+            DoWatch();
+            Thread = std::thread([this]() { Context.run(); });
+        }
+
+        bool Matches(const udp::endpoint& group, uint32_t stream) const
+        {
+            return Group == group && Stream == stream;
+        }
+
+        void DoReceive()
+        {
+            Socket.async_receive_from(asio::buffer(Datagram), From,
+                [this](beast::error_code ec, std::size_t bytes)
+                {
+                    if (ec) return;
+                    OnDatagram(bytes);
+                    DoReceive();
+                });
+        }
+
+        void OnDatagram(size_t bytes)
+        {
+            MulticastHeader header;
+            NetMessage      msg;
+            if (!DecodeMulticast(Datagram.data(), bytes, header, msg) || header.Stream != Stream)
+                return;
+
+            std::vector<uint32_t> nacks;
+            bool deliver = Tracker.Accept(header, nacks);
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                LastHeard = std::chrono::steady_clock::now();
+                Hearing   = true;
+                Nacks.insert(Nacks.end(), nacks.begin(), nacks.end());
+                Stats     = Tracker.GetStats();
+            }
+
+            if (!deliver) return;
+            ++Owner->m_MessagesReceived;
+            Owner->m_BytesReceived += bytes;
+            Owner->ForwardToChildren(msg);
+            if (Owner->m_OnMessage)
+                Owner->m_OnMessage(msg);
+        }
+
+        void DoWatch()
+        {
+            Watchdog.expires_after(std::chrono::milliseconds(500));
+            Watchdog.async_wait([this](beast::error_code ec) {
+                if (ec) return;
+                {
+                    std::lock_guard<std::mutex> lock(Mutex);
+                    if (Hearing && std::chrono::steady_clock::now() - LastHeard > kSilence)
+                        Hearing = false;
+                }
+                DoWatch();
+            });
+        }
+
+        // Client thread: whether the group is getting through, and the
+        // sequence numbers to NACK since the last call
+        bool IsHearing(std::vector<uint32_t>& nacks)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            nacks.swap(Nacks);
+            Nacks.clear();
+            return Hearing;
+        }
+
+        MulticastTrackerStats GetStats() const
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            return Stats;
+        }
+
+        NetworkLayer*         Owner;
+        udp::endpoint         Group;
+        asio::ip::address_v4  Interface;
+        uint32_t              Stream;
+
+        asio::io_context      Context;
+        udp::socket           Socket{ Context };
+        asio::steady_timer    Watchdog{ Context };
+        udp::endpoint         From;
+        std::array<char, 2048> Datagram{};
+        MulticastTracker      Tracker;    // listener thread only
+        std::thread           Thread;
+
+        mutable std::mutex                    Mutex;
+        bool                                  Hearing = false;
+        std::chrono::steady_clock::time_point LastHeard;
+        std::vector<uint32_t>                 Nacks;
+        MulticastTrackerStats                 Stats;
+    };
+
     // =========================================================================
-    // NetMessage serialization
+    // WsSession — one WebSocket connection on the io pool: a connected
+    // student (server-side), or the upstream link between the professor
+    // and a relay (Publisher dials out, relay accepts it on /publish)
     // =========================================================================
 
-    std::string NetMessage::Serialize() const
-    {
-        json root;
-        root["type"] = static_cast<int>(Type);
-        root["data"] = Data;
-        return root.dump();
+    struct NetworkLayer::WsSession
+        : public std::enable_shared_from_this<WsSession>
+    {
+        ws::stream<tcp::socket> Socket;
+        beast::flat_buffer      Buffer;
+        http::request<http::string_body> Request;
+        NetworkLayer*           Owner  = nullptr;
+        size_t                  Shard  = 0;     // index of its io thread
+        uint64_t                Id     = 0;     // key in the student inbox
+        std::string             PeerIp;
+        WireFormat              Format = WireFormat::Json;
+        bool                    Upstream = false; // link toward the professor
+        bool                    Legacy   = false; // offered no subprotocol: predates Batch and TreeControl
+        bool                    Compress = false; // student asked for Compressed frames
+        std::atomic<bool>       Multicast = false; // hears the group: no unicast CameraSync / NodeSelect
+
+        // Relay-tree load this student reports (written on the io thread,
+        // read by any shard picking a redirect; TreeRelay via atomic_load)
+        std::shared_ptr<const TreeAddress> TreeRelay;
+        std::atomic<uint32_t>   TreeCapacity = 0;   // 0 = no limit
+        std::atomic<uint32_t>   TreeChildren = 0;
+        std::atomic<uint32_t>   TreeSubtree  = 0;
+
+        // Outgoing frames by lane; InFlight is being written while Writing
+        // is set. Only touched on this session's io thread.
+        LaneScheduler        Lanes;
+        LaneSlice            InFlight;
+        bool                 Writing = false;
+        bool                 Closing = false;
+        FragmentAssembler    Fragments;   // from a publisher upstream
+        uint32_t             JoinFrames = 0;  // join burst frames not yet written
+
+        // One deflate stream per lane, made on first use (while Compress)
+        std::array<std::unique_ptr<FrameDeflater>, kLaneCount> Deflaters;
+
+        // Metrics — written on the io thread, read from anywhere
+        std::atomic<uint32_t> QueueDepth    = 0;
+        std::atomic<uint32_t> MaxQueueDepth = 0;
+        std::atomic<uint64_t> MessagesSent  = 0;
+        std::atomic<uint64_t> BytesSent     = 0;
+        std::atomic<uint64_t> Coalesced     = 0;
+        std::array<uint32_t, kLaneCount> LaneDepth = {};   // share of Owner->m_LaneQueued
+
+        // Round-trip probing (host → student)
+        RttWindow                          Rtt;
+        std::unique_ptr<asio::steady_timer> PingTimer;
+
+        // Bulk lane source: chunks the student asked for, read from the
+        // store one at a time whenever the lane runs dry
+        std::shared_ptr<const AssetStore> Assets;
+        std::deque<std::string>           PendingChunks;
+        std::atomic<uint64_t>             AssetChunksSent    = 0;
+        std::atomic<uint32_t>             AssetChunksPending = 0;
+
+        WsSession(tcp::socket socket, NetworkLayer* owner, size_t shard)
+            : Socket(std::move(socket)), Owner(owner), Shard(shard)
+            , Id(owner->m_NextSessionId++)
+        {
+            beast::error_code ec;
+            auto remote = Socket.next_layer().remote_endpoint(ec);
+            if (!ec)
+                PeerIp = remote.address().to_string();
+        }
+
+        ~WsSession()
+        {
+            for (size_t i = 0; i < kLaneCount; ++i)
+                Owner->m_LaneQueued[i].fetch_sub(LaneDepth[i], std::memory_order_relaxed);
+        }
+
+        void Start()
+        {
+            // Read the upgrade request ourselves so the subprotocol offer
+            // can be inspected before completing the WebSocket handshake
+            http::async_read(Socket.next_layer(), Buffer, Request,
+                [self = shared_from_this()](beast::error_code ec, std::size_t)
+                {
+                    if (ec || !ws::is_upgrade(self->Request)) {
+                        ATOMETA_WARN("WS upgrade error: ", ec ? ec.message() : "not an upgrade");
+                        return;
+                    }
+                    self->Accept();
+                });
+        }
+
+        void Accept()
+        {
+            if (Owner->m_RelayMode && IsPublishTarget(Request.target())) {
+                if (!PublishKeyMatches(Request.target(), Owner->m_PublishKey)) {
+                    ATOMETA_WARN("Relay: rejected publisher with bad key from ", PeerIp);
+                    Reject(http::status::forbidden);
+                    return;
+                }
+                Upstream = true;
+            }
+
+            auto offered = Request[http::field::sec_websocket_protocol];
+            Legacy = offered.empty();
+            if (!Legacy)
+                Format = NegotiateFormat(offered);
+
+            // Compressed frames are binary, and only ever sent downstream
+            Compress = Format == WireFormat::Binary && !Upstream && Owner->m_Compression &&
+                       Request[kCompressHeader] == kCompressDeflate;
+
+            if (!offered.empty()) {
+                const char* chosen = Format == WireFormat::Binary
+                                   ? kBinarySubprotocol : kJsonSubprotocol;
+                Socket.set_option(ws::stream_base::decorator(
+                    [chosen, compress = Compress](ws::response_type& res) {
+                        res.set(http::field::sec_websocket_protocol, chosen);
+                        if (compress)
+                            res.set(kCompressHeader, kCompressDeflate);
+                    }));
+            }
+            Socket.binary(Format == WireFormat::Binary);
+            Lanes.SetFragmenting(Format == WireFormat::Binary);
+
+            // WebSocket handshake
+            Socket.async_accept(Request, [self = shared_from_this()](beast::error_code ec) {
+                if (ec) {
+                    ATOMETA_WARN("WS accept error: ", ec.message());
+                    return;
+                }
+                if (self->Upstream) {
+                    self->Owner->SetUpstream(self);
+                } else if (auto relay = !self->Legacy ? self->Owner->PickRedirect() : nullptr) {
+                    // A client without a subprotocol cannot read the
+                    // redirect, so it stays here past the fanout
+                    self->Redirect(*relay);
+                    return;
+                } else {
+                    // Joined before the snapshot is read: a delta sent in
+                    // between reaches it as well and is skipped as covered
+                    self->Owner->AddSession(self);
+                    self->StartPinging();
+                    self->SendJoinSnapshot();
+                    self->SendManifest();
+                }
+
+                if (self->Owner->m_OnConnect)
+                    self->Owner->m_OnConnect(self->PeerIp);
+
+                ATOMETA_INFO(self->Upstream ? "Publisher connected: " : "Student connected: ",
+                             self->PeerIp,
+                             self->Format == WireFormat::Binary ? " (binary)" : " (json)");
+                self->DoRead();
+            });
+        }
+
+        // Full: point the student at a relay child and close once it has
+        // the address
+        void Redirect(const TreeAddress& relay)
+        {
+            NetMessage msg;
+            msg.Type = NetMsgType::TreeControl;
+            msg.Data = { { "redirect", TreeAddressToJson(relay) } };
+            auto payload = std::make_shared<const std::string>(msg.Serialize(Format));
+
+            ++Owner->m_TreeRedirects;
+            ATOMETA_INFO("Redirecting ", PeerIp, " to relay ", relay.Host, ":", relay.Port);
+            Socket.async_write(asio::buffer(*payload),
+                [self = shared_from_this(), payload](beast::error_code ec, std::size_t)
+                {
+                    if (ec) return self->Close();
+                    self->Socket.async_close(ws::close_code::normal,
+                        [self](beast::error_code) { self->Close(); });
+                });
+        }
+
+        void Reject(http::status status)
+        {
+            auto res = std::make_shared<http::response<http::string_body>>(
+                status, Request.version());
+            res->set(http::field::server, "Atometa");
+            res->prepare_payload();
+
+            http::async_write(Socket.next_layer(), *res,
+                [self = shared_from_this(), res](beast::error_code, std::size_t) {
+                    self->Close();
+                });
+        }
+
+        // Publisher side: dial the relay and open the upstream link
+        void Connect(const std::string& host, uint16_t port, const std::string& target)
+        {
+            Upstream = true;
+            PeerIp   = host;
+
+            auto resolver = std::make_shared<tcp::resolver>(Socket.get_executor());
+            resolver->async_resolve(host, std::to_string(port),
+                [self = shared_from_this(), resolver, host, target]
+                (beast::error_code ec, tcp::resolver::results_type results)
+                {
+                    if (ec) return self->Fail("resolve", ec);
+
+                    asio::async_connect(self->Socket.next_layer(), results,
+                        [self, host, target](beast::error_code ec, const tcp::endpoint&)
+                        {
+                            if (ec) return self->Fail("connect", ec);
+                            self->Handshake(host, target);
+                        });
+                });
+        }
+
+        void Handshake(const std::string& host, const std::string& target)
+        {
+            OfferSubprotocols(Socket);
+
+            auto res = std::make_shared<ws::response_type>();
+            Socket.async_handshake(*res, host, target,
+                [self = shared_from_this(), res](beast::error_code ec)
+                {
+                    if (ec) return self->Fail("handshake", ec);
+
+                    self->Format = AcceptedFormat(*res);
+                    self->Socket.binary(self->Format == WireFormat::Binary);
+                    self->Lanes.SetFragmenting(self->Format == WireFormat::Binary);
+                    self->Owner->SetUpstream(self);
+
+                    ATOMETA_INFO("Publishing to relay at ", self->PeerIp,
+                                 self->Format == WireFormat::Binary ? " (binary)" : " (json)");
+                    if (self->Owner->m_OnConnect)
+                        self->Owner->m_OnConnect(self->PeerIp);
+                    self->DoRead();
+                });
+        }
+
+        void Fail([[maybe_unused]] const char* what,
+                  [[maybe_unused]] beast::error_code ec)
+        {
+            ATOMETA_ERROR("Relay ", what, " failed: ", ec.message());
+            Owner->ClearUpstream(this);
+        }
+
+        void DoRead()
+        {
+            Socket.async_read(Buffer,
+                [self = shared_from_this()](beast::error_code ec, std::size_t bytes)
+                {
+                    if (ec) {
+                        ATOMETA_INFO(self->Upstream ? "Upstream closed: " : "Student disconnected: ",
+                                     self->PeerIp);
+                        if (self->Owner->m_OnDisconnect)
+                            self->Owner->m_OnDisconnect(self->PeerIp);
+                        if (self->Upstream)
+                            self->Owner->ClearUpstream(self.get());
+                        else
+                            self->Owner->RemoveSession(self.get());
+                        return;
+                    }
+
+                    ++self->Owner->m_MessagesReceived;
+                    self->Owner->m_BytesReceived += bytes;
+
+                    // Over its byte budget: a student's frame is dropped
+                    // before any work is spent decoding it
+                    if (!self->Upstream &&
+                        !self->Owner->m_StudentInbox.Admit(self->Id, bytes, NowMicros(),
+                                                           1 + self->TreeSubtree.load())) {
+                        self->Buffer.consume(self->Buffer.size());
+                        self->DoRead();
+                        return;
+                    }
+
+                    // Decoded in place; the flat buffer keeps its storage
+                    // for the next frame
+                    NetMessage msg;
+                    auto       frame = self->Buffer.cdata();
+                    bool       ok    = NetMessage::Deserialize(frame.data(), frame.size(), msg);
+                    self->Buffer.consume(self->Buffer.size());
+
+                    if (ok && Reassemble(self->Fragments, msg) &&
+                        !self->HandleProbe(msg) && !self->HandleAssetRequest(msg) &&
+                        !self->HandleMulticastControl(msg) && !self->HandleTreeReport(msg)) {
+                        if (!self->Upstream) {
+                            self->Owner->QueueStudentMessage(*self, std::move(msg));
+                        } else {
+                            // A relay fans the professor's stream out to students
+                            if (self->Owner->m_RelayMode) {
+                                self->Owner->Broadcast(msg);
+                                ++self->Owner->m_MessagesRelayed;
+                            }
+                            if (self->Owner->m_OnMessage)
+                                self->Owner->m_OnMessage(msg);
+                        }
+                    }
+
+                    self->DoRead(); // keep reading
+                });
+        }
+
+        // ── Round-trip probes ────────────────────────────────────────────
+
+        void StartPinging()
+        {
+            if (Owner->m_PingIntervalMs.load() == 0) return;
+
+            PingTimer = std::make_unique<asio::steady_timer>(Socket.get_executor());
+            SchedulePing();
+        }
+
+        void SchedulePing()
+        {
+            PingTimer->expires_after(std::chrono::milliseconds(Owner->m_PingIntervalMs.load()));
+            PingTimer->async_wait([self = shared_from_this()](beast::error_code ec) {
+                if (ec || self->Closing) return;
+
+                // Carries the latest RTT so the student can estimate its
+                // own clock offset from the host
+                NetMessage ping;
+                ping.Type      = NetMsgType::Ping;
+                ping.Timestamp = NowMicros();
+                ping.RoundTrip = self->Rtt.GetLatest();
+                self->Write(std::make_shared<const std::string>(ping.Serialize(self->Format)),
+                            NetMsgType::Ping);
+                self->SchedulePing();
+            });
+        }
+
+        // Answers pings and records pongs; returns true if msg was a probe
+        bool HandleProbe(const NetMessage& msg)
+        {
+            if (msg.Type == NetMsgType::Ping) {
+                NetMessage pong;
+                pong.Type          = NetMsgType::Pong;
+                pong.Timestamp     = NowMicros();
+                pong.EchoTimestamp = msg.Timestamp;
+                Write(std::make_shared<const std::string>(pong.Serialize(Format)),
+                      NetMsgType::Pong);
+                return true;
+            }
+
+            if (msg.Type == NetMsgType::Pong) {
+                uint64_t now = NowMicros();
+                if (msg.EchoTimestamp != 0 && msg.EchoTimestamp <= now) {
+                    uint64_t rtt    = now - msg.EchoTimestamp;
+                    int64_t  offset = static_cast<int64_t>(msg.Timestamp)
+                                    - static_cast<int64_t>(msg.EchoTimestamp + rtt / 2);
+                    Rtt.Add(static_cast<uint32_t>(std::min<uint64_t>(rtt, UINT32_MAX)), offset);
+                }
+                return true;
+            }
+            return false;
+        }
+
+        // ── Multicast control ────────────────────────────────────────────
+
+        // Subscribe / unsubscribe and NACKs from a student on the multicast
+        // group; returns true if msg was a MulticastControl
+        bool HandleMulticastControl(const NetMessage& msg)
+        {
+            if (msg.Type != NetMsgType::MulticastControl) return false;
+
+            auto channel = std::atomic_load(&Owner->m_McChannel);
+            if (!channel || Upstream) return true;
+
+            const auto& data = msg.Data;
+            if (data.contains("subscribe") && data["subscribe"].is_boolean())
+                Multicast = data["subscribe"].get<bool>();
+
+            if (data.contains("nack") && data["nack"].is_array()) {
+                NetMessage repair;
+                size_t     count = 0;
+                for (const auto& seq : data["nack"]) {
+                    if (++count > MulticastTracker::kMaxNack) break;
+                    if (seq.is_number_unsigned() &&
+                        channel->Sender.Repair(seq.get<uint32_t>(), repair))
+                        Write(std::make_shared<const std::string>(repair.Serialize(Format)),
+                              repair.Type);
+                }
+            }
+            return true;
+        }
+
+        // ── Relay tree ───────────────────────────────────────────────────
+
+        // Load report from a student that relays; returns true if msg was a
+        // TreeControl
+        bool HandleTreeReport(const NetMessage& msg)
+        {
+            if (msg.Type != NetMsgType::TreeControl) return false;
+            if (Upstream) return true;
+
+            const auto& data = msg.Data;
+            if (data.contains("relay") && data["relay"].is_number_unsigned()) {
+                auto relay  = std::make_shared<TreeAddress>();
+                relay->Host = data.value("host", std::string());
+                relay->Port = data["relay"].get<uint16_t>();
+                if (relay->Host.empty()) relay->Host = PeerIp;
+                if (relay->Port != 0)
+                    std::atomic_store(&TreeRelay, std::shared_ptr<const TreeAddress>(relay));
+            }
+            TreeCapacity = data.value("capacity", 0u);
+            TreeChildren = data.value("children", 0u);
+            TreeSubtree  = data.value("subtree",  0u);
+            return true;
+        }
+
+        // ── Join snapshot ────────────────────────────────────────────────
+
+        void SendJoinSnapshot()
+        {
+            // A reconnecting student names the stream and the last delta
+            // it applied: "/?resume=<session token>&seq=<n>"
+            JoinState::Resume resume;
+            resume.Token = QueryValue(Request.target(), "resume");
+            try {
+                resume.Sequence = static_cast<uint32_t>(
+                    std::stoul(QueryValue(Request.target(), "seq")));
+            } catch (...) {
+                resume.Token.clear();
+            }
+
+            // Catching up must not overflow the queue it is written into
+            bool resumed = false;
+            auto frames  = Owner->m_Join->Frames(Format, resume,
+                                                 Owner->m_MaxQueueDepth / 2, resumed);
+            JoinFrames = static_cast<uint32_t>(frames.size());
+            for (const auto& frame : frames)
+                Write(frame.Payload, frame.Type);
+
+            if (resumed) ++Owner->m_ResumedJoins;
+            else         ++Owner->m_JoinSnapshots;
+        }
+
+        // ── Asset lane ───────────────────────────────────────────────────
+
+        void SendManifest()
+        {
+            auto offer = std::atomic_load(&Owner->m_AssetOffer);
+            if (offer)
+                Write(offer->Manifest[static_cast<size_t>(Format)], NetMsgType::AssetManifest);
+        }
+
+        // Queues requested chunks; returns true if msg was an AssetRequest
+        bool HandleAssetRequest(const NetMessage& msg)
+        {
+            if (msg.Type != NetMsgType::AssetRequest) return false;
+
+            auto offer = std::atomic_load(&Owner->m_AssetOffer);
+            if (!offer || !msg.Data.contains("chunks") || !msg.Data["chunks"].is_array())
+                return true;
+
+            Assets = offer->Store;
+            for (const auto& hash : msg.Data["chunks"]) {
+                if (PendingChunks.size() >= Assets->GetChunkCount()) break;
+                if (hash.is_string() && Assets->HasChunk(hash.get<std::string>()))
+                    PendingChunks.push_back(hash.get<std::string>());
+            }
+            AssetChunksPending = static_cast<uint32_t>(PendingChunks.size());
+
+            if (!Writing)
+                DoWrite();
+            return true;
+        }
+
+        SharedPayload NextChunk()
+        {
+            while (!PendingChunks.empty()) {
+                NetMessage chunk;
+                chunk.Type      = NetMsgType::AssetChunk;
+                chunk.ChunkHash = std::move(PendingChunks.front());
+                PendingChunks.pop_front();
+                AssetChunksPending = static_cast<uint32_t>(PendingChunks.size());
+
+                if (Assets && Assets->ReadChunk(chunk.ChunkHash, chunk.Blob))
+                    return Deflate(std::make_shared<const std::string>(chunk.Serialize(Format)),
+                                   Lane::Bulk);
+            }
+            return nullptr;
+        }
+
+        // The frame as it goes to this student on lane: Compressed when it
+        // asked for that and the frame is large enough to be worth it.
+        // Frames are deflated in the order they are queued, which is the
+        // order each lane writes them.
+        SharedPayload Deflate(SharedPayload payload, Lane lane)
+        {
+            if (!Compress || lane == Lane::Realtime || payload->size() < kMinCompressSize)
+                return payload;
+
+            auto& deflater = Deflaters[static_cast<size_t>(lane)];
+            if (!deflater)
+                deflater = std::make_unique<FrameDeflater>(static_cast<uint8_t>(lane));
+
+            std::string frame;
+            if (!deflater->Compress(*payload, frame)) return payload;
+
+            Owner->m_CompressedIn  += payload->size();
+            Owner->m_CompressedOut += frame.size();
+            return std::make_shared<const std::string>(std::move(frame));
+        }
+
+        void Write(const SharedPayload& payload, NetMsgType type)
+        {
+            Write(payload, type, LaneFor(type));
+        }
+
+        // Must run on this session's io thread
+        void Write(const SharedPayload& payload, NetMsgType type, Lane lane)
+        {
+            if (Closing) return;
+
+            // Camera and pointer frames go out as they are, even when the
+            // join burst moves them to the control lane
+            bool realtime = lane == Lane::Realtime || LaneFor(type) == Lane::Realtime;
+
+            // The join burst is one ordered unit (its camera must not
+            // overtake the snapshot), and so is whatever follows it until
+            // the burst is out
+            if (JoinFrames > 0) lane = Lane::Control;
+            auto frame = realtime ? payload : Deflate(payload, lane);
+            if (Lanes.Push(std::move(frame), type, lane, NowMicros()) == LaneScheduler::PushResult::Coalesced) {
+                ++Coalesced;
+                return;
+            }
+
+            if (Lanes.Pending() > Owner->m_MaxQueueDepth) {
+                ATOMETA_WARN("Student too far behind, disconnecting: ", PeerIp);
+                ++Owner->m_DroppedClients;
+                Close();
+                return;
+            }
+            UpdateDepth();
+
+            if (!Writing)
+                DoWrite();
+        }
+
+        // One slice per write, picked by the lane scheduler: realtime frames
+        // first, then control and bulk by weight. A large binary frame goes
+        // out in fragments, so a camera frame waits at most one fragment.
+        void DoWrite()
+        {
+            if (Lanes.IsEmpty(Lane::Bulk)) {
+                if (auto chunk = NextChunk())
+                    Lanes.Push(std::move(chunk), NetMsgType::AssetChunk, NowMicros());
+            }
+
+            if (!Lanes.Next(InFlight)) {
+                Writing = false;
+                return;
+            }
+            UpdateDepth();
+
+            // Header (fragments only) and the slice go out as one frame
+            // straight from the shared payload
+            std::array<asio::const_buffer, 2> buffers = {
+                asio::buffer(InFlight.Header),
+                asio::buffer(InFlight.Payload->data() + InFlight.Offset, InFlight.Size),
+            };
+
+            Writing = true;
+            Socket.async_write(buffers,
+                [self = shared_from_this()](beast::error_code ec, std::size_t bytes)
+                {
+                    if (ec) {
+                        if (ec != asio::error::operation_aborted) {
+                            ATOMETA_WARN("WS send error: ", ec.message());
+                        }
+                        self->Close();
+                        return;
+                    }
+
+                    const auto& sent = self->InFlight;
+                    uint64_t    now  = NowMicros();
+                    self->Lanes.Done(sent, now);
+                    self->BytesSent += bytes;
+                    self->Owner->m_BytesSent += bytes;
+
+                    if (sent.Last) {
+                        if (sent.From == Lane::Control && self->JoinFrames > 0)
+                            --self->JoinFrames;
+                        ++self->MessagesSent;
+                        ++self->Owner->m_MessagesSent;
+                        self->Owner->m_SendLatency[static_cast<size_t>(sent.From)]
+                            .Observe(now - std::min(now, sent.EnqueuedUs));
+                        if (sent.Type == NetMsgType::AssetChunk)
+                            ++self->AssetChunksSent;
+                    }
+
+                    self->DoWrite();
+                });
+        }
+
+        // Drops the TCP connection; the pending read then fails and the
+        // session removes itself through the normal disconnect path
+        void Close()
+        {
+            if (Closing) return;
+            Closing = true;
+            Writing = false;
+            Lanes.Clear();
+            PendingChunks.clear();
+            UpdateDepth();
+            if (PingTimer) PingTimer->cancel();
+
+            beast::error_code ec;
+            Socket.next_layer().shutdown(tcp::socket::shutdown_both, ec);
+            Socket.next_layer().close(ec);
+        }
+
+        void UpdateDepth()
+        {
+            auto depth = static_cast<uint32_t>(Lanes.Pending());
+            QueueDepth = depth;
+            if (depth > MaxQueueDepth)
+                MaxQueueDepth = depth;
+
+            // Host-wide gauges move by this session's change only
+            for (size_t i = 0; i < kLaneCount; ++i) {
+                auto lane = static_cast<uint32_t>(Lanes.Pending(static_cast<Lane>(i)));
+                if (lane == LaneDepth[i]) continue;
+                Owner->m_LaneQueued[i].fetch_add(int64_t(lane) - int64_t(LaneDepth[i]),
+                                                 std::memory_order_relaxed);
+                LaneDepth[i] = lane;
+            }
+        }
+    };
+
+    // =========================================================================
+    // MetricsSession — one scrape on the metrics port: a single plain HTTP
+    // request, answered and closed
+    // =========================================================================
+
+    struct NetworkLayer::MetricsSession
+        : public std::enable_shared_from_this<MetricsSession>
+    {
+        static constexpr auto kTimeout = std::chrono::seconds(5);
+
+        beast::tcp_stream                  Stream;
+        beast::flat_buffer                 Buffer;
+        http::request<http::string_body>   Request;
+        http::response<http::string_body>  Response;
+        const NetworkLayer*                Owner = nullptr;
+
+        MetricsSession(tcp::socket socket, const NetworkLayer* owner)
+            : Stream(std::move(socket)), Owner(owner)
+        {
+        }
+
+        void Start()
+        {
+            Stream.expires_after(kTimeout);
+            http::async_read(Stream, Buffer, Request,
+                [self = shared_from_this()](beast::error_code ec, std::size_t)
+                {
+                    if (ec) return;
+                    self->Respond();
+                });
+        }
+
+        void Respond()
+        {
+            auto target = Request.target();
+            bool found  = target == "/metrics" || target.starts_with("/metrics?");
+
+            Response.version(Request.version());
+            Response.keep_alive(false);
+            if (Request.method() != http::verb::get) {
+                Response.result(http::status::method_not_allowed);
+                Response.set(http::field::allow, "GET");
+            } else if (!found) {
+                Response.result(http::status::not_found);
+            } else {
+                Response.result(http::status::ok);
+                Response.set(http::field::content_type, "text/plain; version=0.0.4; charset=utf-8");
+                Response.body() = Owner->GetMetricsText();
+            }
+            Response.prepare_payload();
+
+            http::async_write(Stream, Response,
+                [self = shared_from_this()](beast::error_code, std::size_t)
+                {
+                    beast::error_code ec;
+                    self->Stream.socket().shutdown(tcp::socket::shutdown_send, ec);
+                });
+        }
+    };
+
+    // =========================================================================
+    // ClientLink — a student's connection to its host or relay parent, as a
+    // state machine on pool context 0: resolve, connect, handshake, read
+    // until the link drops, wait out the backoff, dial again. Stop() leaves
+    // with a close handshake. The client state it shares with NetworkLayer
+    // (m_Tree*, m_Resume*, downloads) is only touched on that thread.
+    // =========================================================================
+
+    struct NetworkLayer::ClientLink
+        : public std::enable_shared_from_this<ClientLink>
+    {
+        static constexpr auto kCloseTimeout = std::chrono::seconds(1);
+
+        enum class State { Idle, Resolving, Connecting, Handshaking, Open, Waiting, Closing, Stopped };
+
+        using Stream = ws::stream<tcp::socket>;
+
+        struct Frame {
+            std::string Data;
+            bool        Uplink = false;   // from Send(): counted, and kept over a reconnect
+        };
+
+        NetworkLayer*           Owner = nullptr;
+        asio::io_context&       IO;
+        tcp::resolver           Resolver;
+        asio::steady_timer      Timer;        // retry backoff, then the close deadline
+        std::shared_ptr<Stream> Socket;       // a new one for every attempt
+        beast::flat_buffer      Buffer;
+        FragmentAssembler       Fragments;
+        std::array<FrameInflater, kLaneCount> Inflaters;   // one per host lane
+        State                   Current    = State::Idle;
+        uint32_t                Generation = 0;   // attempt that pending handlers belong to
+
+        // Where this student is attached in the relay tree; starts at the
+        // address given to Connect()
+        TreeAddress             Parent;
+        uint32_t                Backoff = 0;
+        std::minstd_rand        Rng;
+
+        // Head is being written while Writing
+        std::deque<Frame>       Outbox;
+        bool                    Writing = false;
+
+        ClientLink(NetworkLayer* owner, asio::io_context& io, TreeAddress parent)
+            : Owner(owner), IO(io), Resolver(io), Timer(io), Parent(std::move(parent))
+            , Backoff(owner->m_ReconnectMinMs.load()), Rng(std::random_device{}())
+        {
+        }
+
+        void Start()
+        {
+            Owner->ResetClientState();
+            Dial();
+        }
+
+        // Leaves for good. Returns the io thread at once; the close frame
+        // goes out after any write in flight, and the socket is dropped
+        // once the host answers or kCloseTimeout passes.
+        void Stop()
+        {
+            if (Current == State::Closing || Current == State::Stopped) return;
+
+            std::atomic_store(&Owner->m_McListener, std::shared_ptr<MulticastListener>());
+            Resolver.cancel();
+            Timer.cancel();
+
+            if (Current != State::Open) {
+                Drop();
+                Current = State::Stopped;
+                return;
+            }
+
+            // Unsent messages wait for the next Connect()
+            ReturnUplink(Writing ? 1 : 0);
+            Outbox.erase(Outbox.begin() + (Writing ? 1 : 0), Outbox.end());
+
+            Current = State::Closing;
+            Timer.expires_after(kCloseTimeout);
+            Timer.async_wait([self = shared_from_this()](beast::error_code ec) {
+                if (ec || self->Current != State::Closing) return;
+                ATOMETA_WARN("Host did not answer the close, dropping the connection");
+                self->CloseSocket();
+            });
+            if (!Writing)
+                SendClose();
+        }
+
+        // Send() / control frames; only while open
+        void Write(std::string frame, bool uplink = false)
+        {
+            if (Current != State::Open) return;
+            Outbox.push_back({ std::move(frame), uplink });
+            if (!Writing)
+                DoWrite();
+        }
+
+        bool IsOpen() const { return Current == State::Open; }
+
+    private:
+        bool IsCurrent(uint32_t generation) const
+        {
+            return generation == Generation && Current != State::Closing && Current != State::Stopped;
+        }
+
+        void Dial()
+        {
+            Current = State::Resolving;
+            Socket  = std::make_shared<Stream>(IO);
+
+            uint32_t generation = ++Generation;
+            Resolver.async_resolve(Parent.Host, std::to_string(Parent.Port),
+                [self = shared_from_this(), generation]
+                (beast::error_code ec, tcp::resolver::results_type results)
+                {
+                    if (!self->IsCurrent(generation)) return;
+                    if (ec) return self->Failed("resolve", ec);
+
+                    self->Current = State::Connecting;
+                    asio::async_connect(self->Socket->next_layer(), results,
+                        [self, generation](beast::error_code ec, const tcp::endpoint&)
+                        {
+                            if (!self->IsCurrent(generation)) return;
+                            if (ec) return self->Failed("connect", ec);
+                            self->Handshake(generation);
+                        });
+                });
+        }
+
+        void Handshake(uint32_t generation)
+        {
+            Current = State::Handshaking;
+            OfferSubprotocols(*Socket, Owner->m_Compression);
+
+            auto res = std::make_shared<ws::response_type>();
+            Socket->async_handshake(*res, Parent.Host, Owner->ClientTarget(),
+                [self = shared_from_this(), res, generation](beast::error_code ec)
+                {
+                    if (!self->IsCurrent(generation)) return;
+                    if (ec) return self->Failed("handshake", ec);
+                    self->Opened(*res, generation);
+                });
+        }
+
+        void Opened(const ws::response_type& res, uint32_t generation)
+        {
+            NetworkLayer& owner = *Owner;
+            owner.m_ClientFormat = AcceptedFormat(res);
+            Socket->binary(owner.m_ClientFormat.load() == WireFormat::Binary);
+
+            Backoff               = owner.m_ReconnectMinMs.load();
+            Current               = State::Open;
+            owner.m_JoinPending   = -1;
+            owner.m_McSubscribed  = false;   // a new connection starts on unicast
+            owner.m_TreeReported  = json();
+            owner.m_TreeParentLatencyUs = 0;
+            owner.m_TreeUpstream  = Parent;
+            owner.m_Connected     = true;
+            ATOMETA_INFO(owner.m_Reconnecting ? "Reconnected to session at " : "Connected to session at ",
+                         Parent.Host, ":", Parent.Port,
+                         owner.m_ClientFormat.load() == WireFormat::Binary ? " (binary)" : " (json)");
+
+            if (owner.m_OnConnect)
+                owner.m_OnConnect(Parent.Host);
+
+            // Whatever Send() queued while we were away
+            owner.FlushUplink(*this);
+            DoRead(generation);
+        }
+
+        void DoRead(uint32_t generation)
+        {
+            Socket->async_read(Buffer,
+                [self = shared_from_this(), generation](beast::error_code ec, std::size_t)
+                {
+                    if (generation != self->Generation) return;
+                    if (self->Current == State::Closing) return self->Closed();
+                    if (ec) {
+                        ATOMETA_INFO("Session closed: ", ec.message());
+                        return self->Lost();
+                    }
+                    if (self->HandleFrame())
+                        self->DoRead(generation);
+                    else
+                        self->Lost();
+                });
+        }
+
+        // False ends the connection (handed to another relay)
+        bool HandleFrame()
+        {
+            NetworkLayer& owner = *Owner;
+
+            // Decoded in place; the flat buffer keeps its storage for the
+            // next frame
+            NetMessage msg;
+            auto       frame = Buffer.cdata();
+            bool       ok    = NetMessage::Deserialize(frame.data(), frame.size(), msg);
+            Buffer.consume(Buffer.size());
+
+            // Multicast state and the tree load are polled once per frame
+            // from the host, a ping at the latest
+            owner.FlushMulticastControl(*this);
+            owner.FlushTreeControl(*this);
+
+            if (!ok || !Reassemble(Fragments, msg)) return true;
+            if (msg.Type == NetMsgType::Compressed && !Expand(msg)) return false;
+
+            // A host tick's worth of messages, handled in the order sent
+            if (msg.Type != NetMsgType::Batch)
+                return owner.DispatchClient(msg, *this);
+
+            std::vector<NetMessage> batch;
+            if (UnpackBatch(msg, batch))
+                for (auto& entry : batch)
+                    if (!owner.DispatchClient(entry, *this)) return false;
+            return true;
+        }
+
+        // Swaps a Compressed frame for the one it carries. A frame that
+        // does not inflate leaves the stream out of step with the host:
+        // only a new connection can fix that.
+        bool Expand(NetMessage& msg)
+        {
+            std::string frame;
+            NetMessage  inner;
+            if (msg.Sequence >= Inflaters.size() || !Inflaters[msg.Sequence].Expand(msg, frame) ||
+                !NetMessage::Deserialize(frame, inner) || inner.Type == NetMsgType::Compressed ||
+                inner.Type == NetMsgType::Fragment) {
+                ATOMETA_WARN("Compressed frame from the host did not decode, reconnecting");
+                return false;
+            }
+            msg = std::move(inner);
+            return true;
+        }
+
+        void DoWrite()
+        {
+            Writing = true;
+            Socket->async_write(asio::buffer(Outbox.front().Data),
+                [self = shared_from_this(), generation = Generation]
+                (beast::error_code ec, std::size_t bytes)
+                {
+                    if (generation != self->Generation) return;
+                    self->Writing = false;
+
+                    // The pending read fails next and takes it from there
+                    if (ec) return self->CloseSocket();
+
+                    if (self->Outbox.front().Uplink) {
+                        ++self->Owner->m_MessagesSent;
+                        self->Owner->m_BytesSent += bytes;
+                    }
+                    self->Outbox.pop_front();
+
+                    if (self->Current == State::Closing)
+                        self->SendClose();
+                    else if (!self->Outbox.empty())
+                        self->DoWrite();
+                });
+        }
+
+        void SendClose()
+        {
+            // The read still pending ends with error::closed once the host
+            // has answered
+            Socket->async_close(ws::close_code::normal,
+                [self = shared_from_this()](beast::error_code ec) {
+                    if (ec) self->CloseSocket();
+                });
+        }
+
+        void Closed()
+        {
+            Timer.cancel();
+            Drop();
+            Current = State::Stopped;
+            ATOMETA_INFO("Left the session");
+        }
+
+        void Failed([[maybe_unused]] const char* what, [[maybe_unused]] beast::error_code ec)
+        {
+            ATOMETA_WARN("Connect failed (", what, "): ", ec.message());
+            Drop();
+            Owner->m_Connected = false;
+            {
+                std::lock_guard<std::mutex> lock(Owner->m_ReconnectStatsMutex);
+                ++Owner->m_ReconnectStats.FailedAttempts;
+            }
+            Retry(false);
+        }
+
+        void Lost()
+        {
+            Drop();
+            Owner->m_Connected = false;
+            if (Owner->m_OnDisconnect && !Owner->m_TreeRedirect)
+                Owner->m_OnDisconnect("host");
+            Retry(true);
+        }
+
+        void Retry(bool established)
+        {
+            NetworkLayer& owner = *Owner;
+
+            // Handed down the tree: dial the relay straight away, keeping
+            // the redirecting node as the way back up
+            if (owner.m_TreeRedirect) {
+                owner.m_TreeUp.push_back(Parent);
+                Parent = *owner.m_TreeRedirect;
+                owner.m_TreeRedirect.reset();
+                return Dial();
+            }
+
+            // Reconnect time is measured from the moment the session was lost
+            if (established) {
+                std::lock_guard<std::mutex> lock(owner.m_ReconnectStatsMutex);
+                ++owner.m_ReconnectStats.Drops;
+                owner.m_Reconnecting = true;
+                owner.m_JoinStartUs  = NowMicros();
+            } else if (!owner.m_TreeUp.empty()) {
+                // The relay is gone, not just the link to it: re-attach to
+                // its parent, which takes us or hands us to another relay
+                Parent = owner.m_TreeUp.back();
+                owner.m_TreeUp.pop_back();
+                ++owner.m_TreeRepairs;
+                ATOMETA_INFO("Relay unreachable, climbing to ", Parent.Host, ":", Parent.Port);
+                return Dial();
+            }
+
+            uint32_t delay = Backoff * 3 / 4 + static_cast<uint32_t>(Rng() % (Backoff / 2 + 1));
+            ATOMETA_INFO("Retrying in ", delay, " ms");
+            Backoff = std::min(Backoff * 2, owner.m_ReconnectMaxMs.load());
+
+            Current = State::Waiting;
+            Timer.expires_after(std::chrono::milliseconds(delay));
+            Timer.async_wait([self = shared_from_this(), generation = Generation](beast::error_code ec) {
+                if (ec || !self->IsCurrent(generation)) return;
+                self->Dial();
+            });
+        }
+
+        // Ends the current attempt: its handlers are ignored from here on
+        void Drop()
+        {
+            ++Generation;
+            ReturnUplink(0);
+            Outbox.clear();
+            Writing = false;
+            Buffer.consume(Buffer.size());
+            Fragments.Reset();
+            for (auto& inflater : Inflaters)
+                inflater.Reset();
+            CloseSocket();
+        }
+
+        void CloseSocket()
+        {
+            if (!Socket) return;
+            beast::error_code ec;
+            Socket->next_layer().shutdown(tcp::socket::shutdown_both, ec);
+            Socket->next_layer().close(ec);
+        }
+
+        // Uplink frames from Outbox[from] on go back to the front of the
+        // outbox, ahead of anything newer
+        void ReturnUplink(size_t from)
+        {
+            std::vector<std::string> frames;
+            for (size_t i = from; i < Outbox.size(); ++i)
+                if (Outbox[i].Uplink) frames.push_back(std::move(Outbox[i].Data));
+            if (frames.empty()) return;
+
+            std::lock_guard<std::mutex> lock(Owner->m_UplinkMutex);
+            auto& uplink = Owner->m_Uplink;
+            uplink.insert(uplink.begin(), std::make_move_iterator(frames.begin()),
+                          std::make_move_iterator(frames.end()));
+            if (uplink.size() > kMaxUplink) {
+                Owner->m_UplinkDropped += uplink.size() - kMaxUplink;
+                uplink.resize(kMaxUplink);
+            }
+        }
+    };
+
+    // =========================================================================
+    // NetworkLayer
+    // =========================================================================
+
+    NetworkLayer::NetworkLayer()
+        : m_Sessions(std::make_shared<const SessionList>())
+        , m_Shards(std::make_shared<const ShardList>())
+        , m_ClientRtt(std::make_unique<RttWindow>())
+        , m_Join(std::make_unique<JoinState>())
+    {
+    }
+
+    NetworkLayer::~NetworkLayer()
+    {
+        StopHost();
+        Disconnect();
+        ReleasePool();
+    }
+
+    // ── Host ─────────────────────────────────────────────────────────────────
+
+    bool NetworkLayer::StartHost(uint16_t port)
+    {
+        if (m_Running.load()) {
+            ATOMETA_WARN("NetworkLayer: already running");
+            return false;
+        }
+
+        ReleasePool();
+
+        m_Role     = NetworkRole::Host;
+        m_Running  = true;
+        if (!OpenListener(port)) {
+            m_Role    = NetworkRole::None;
+            m_Running = false;
+            return false;
+        }
+
+        m_Connected = true;
+        StartMulticast();
+        ATOMETA_INFO("Session hosted on port ", port,
+                     " (", m_IOPool.Size(), " io threads)");
+        return true;
+    }
+
+    bool NetworkLayer::OpenListener(uint16_t port)
+    {
+        try {
+            m_IOPool.Start();
+
+            tcp::endpoint endpoint(tcp::v4(), port);
+            m_Acceptor = std::make_unique<tcp::acceptor>(m_IOPool.Get(0), endpoint);
+            DoAccept();
+
+            auto tick = std::make_shared<TickBatch>(m_IOPool.Get(0));
+            tick->Schedule(this);
+            std::atomic_store(&m_Tick, tick);
+
+            OpenMetrics();
+            return true;
+
+        } catch (const std::exception& e) {
+            ATOMETA_ERROR("Listening on port ", port, " failed: ", e.what());
+            m_Acceptor.reset();
+            m_MetricsAcceptor.reset();
+            m_IOPool.Stop();
+            m_IOPool.Reset();
+            return false;
+        }
+    }
+
+    void NetworkLayer::StopHost()
+    {
+        if (m_Role != NetworkRole::Host) return;
+
+        ShutdownPool();
+
+        m_Role = NetworkRole::None;
+        ATOMETA_INFO("Host session stopped");
+    }
+
+    void NetworkLayer::SetAssetStore(std::shared_ptr<const AssetStore> store)
+    {
+        std::shared_ptr<AssetOffer> offer;
+        if (store) {
+            NetMessage manifest = store->MakeManifest();
+            offer = std::make_shared<AssetOffer>();
+            offer->Store = std::move(store);
+            for (auto format : { WireFormat::Json, WireFormat::Binary })
+                offer->Manifest[static_cast<size_t>(format)] =
+                    std::make_shared<const std::string>(manifest.Serialize(format));
+        }
+        std::atomic_store(&m_AssetOffer, std::shared_ptr<const AssetOffer>(offer));
+
+        // Students already in the session get the new manifest too
+        if (offer && m_Role == NetworkRole::Host && m_Running.load())
+            Broadcast(offer->Store->MakeManifest());
+    }
+
+    void NetworkLayer::StartMulticast()
+    {
+        std::shared_ptr<MulticastChannel> channel;
+        if (m_MulticastConfig.Enabled) {
+            std::random_device rd;
+            channel = std::make_shared<MulticastChannel>(m_IOPool.Get(0), m_MulticastConfig, rd());
+            try {
+                channel->Open();
+                channel->ScheduleHeartbeat();
+                ATOMETA_INFO("Multicasting to ", m_MulticastConfig.Group, ":", m_MulticastConfig.Port);
+            } catch (const std::exception& e) {
+                // Students simply stay on unicast
+                ATOMETA_WARN("Multicast unavailable: ", e.what());
+                channel.reset();
+            }
+        }
+
+        std::atomic_store(&m_McChannel, channel);
+        m_Join->SetMulticast(channel ? channel->Advert() : json());
+    }
+
+    MulticastStats NetworkLayer::GetMulticastStats() const
+    {
+        MulticastStats stats;
+        if (auto channel = std::atomic_load(&m_McChannel)) {
+            stats.Active = true;
+            stats.Sent   = channel->Sender.GetStats();
+            for (const auto& session : *std::atomic_load(&m_Sessions))
+                stats.Subscribers += session->Multicast.load() ? 1 : 0;
+        }
+        if (auto listener = std::atomic_load(&m_McListener)) {
+            stats.Received = listener->GetStats();
+            std::lock_guard<std::mutex> lock(listener->Mutex);
+            stats.Active  |= listener->Hearing;
+        }
+        return stats;
+    }
+
+    void NetworkLayer::SetRecorder(std::shared_ptr<SessionRecorder> recorder)
+    {
+        std::atomic_store(&m_Recorder, std::move(recorder));
+    }
+
+    void NetworkLayer::SetRelayMode(bool enabled, const std::string& publishKey)
+    {
+        m_RelayMode  = enabled;
+        m_PublishKey = publishKey;
+    }
+
+    void NetworkLayer::SetTreeRelay(uint16_t port, const std::string& advertiseHost)
+    {
+        m_TreePort      = port;
+        m_TreeAdvertise = advertiseHost;
+    }
+
+    std::shared_ptr<const TreeAddress> NetworkLayer::PickRedirect() const
+    {
+        uint32_t fanout   = m_TreeFanout.load();
+        auto     sessions = std::atomic_load(&m_Sessions);
+        if (fanout == 0 || sessions->size() < fanout) return nullptr;
+
+        // Prefer a relay with a free slot, then the lightest subtree: it
+        // redirects again if it is full too, so the tree fills level by level
+        std::shared_ptr<const TreeAddress> best;
+        bool     bestFree    = false;
+        uint32_t bestSubtree = UINT32_MAX;
+        for (const auto& session : *sessions) {
+            auto relay = std::atomic_load(&session->TreeRelay);
+            if (!relay) continue;
+
+            uint32_t capacity = session->TreeCapacity.load();
+            bool     free     = capacity == 0 || session->TreeChildren.load() < capacity;
+            uint32_t subtree  = session->TreeSubtree.load();
+            if ((free && !bestFree) || (free == bestFree && subtree < bestSubtree)) {
+                best        = relay;
+                bestFree    = free;
+                bestSubtree = subtree;
+            }
+        }
+        return best;   // none relays: take the student anyway
+    }
+
+    uint32_t NetworkLayer::TreeSubtree() const
+    {
+        uint32_t total = 0;
+        for (const auto& session : *std::atomic_load(&m_Sessions))
+            total += 1 + session->TreeSubtree.load();
+        return total;
+    }
+
+    TreeStats NetworkLayer::GetTreeStats() const
+    {
+        TreeStats stats;
+        stats.Relaying  = m_TreeListening.load();
+        stats.Depth     = m_TreeDepth.load();
+        stats.Children  = GetClientCount();
+        stats.Subtree   = TreeSubtree();
+        stats.Redirects = m_TreeRedirects.load();
+        stats.Repairs   = m_TreeRepairs.load();
+
+        if (m_Role == NetworkRole::Client) {
+            auto rtt = m_ClientRtt->Summary();
+            stats.HopLatencyMs  = rtt.AvgMs / 2.f;
+            stats.PathLatencyMs = m_TreeParentLatencyUs.load() / 1000.f + stats.HopLatencyMs;
+        }
+        return stats;
+    }
+
+    void NetworkLayer::ShutdownPool()
+    {
+        m_Running   = false;
+        m_Connected = false;
+        m_IOPool.Stop();
+
+        m_Join->Reset();
+
+        // Release sockets before the contexts they are bound to
+        if (auto channel = std::atomic_exchange(&m_McChannel, std::shared_ptr<MulticastChannel>()))
+            channel->Close();
+        if (auto tick = std::atomic_exchange(&m_Tick, std::shared_ptr<TickBatch>()))
+            tick->Close();
+        m_StudentInbox.Clear();
+        m_InboxDraining = false;
+        m_Acceptor.reset();
+        m_MetricsAcceptor.reset();
+        std::atomic_store(&m_Upstream, std::shared_ptr<WsSession>());
+        std::atomic_store(&m_Client, std::shared_ptr<ClientLink>());
+        std::atomic_store(&m_McListener, std::shared_ptr<MulticastListener>());
+        {
+            std::lock_guard<std::mutex> lock(m_SessionMutex);
+            StoreSessions(std::make_shared<SessionList>());
+        }
+        m_IOPool.Reset();
+    }
+
+    // A pool that Disconnect() left running while its link said goodbye
+    void NetworkLayer::ReleasePool()
+    {
+        if (m_IOPool.IsRunning())
+            ShutdownPool();
+    }
+
+    // Tree relay leaving (pool context 0): no new students, and those we
+    // have reconnect to our parent
+    void NetworkLayer::CloseListener()
+    {
+        beast::error_code ec;
+        if (m_Acceptor) m_Acceptor->close(ec);
+        if (m_MetricsAcceptor) m_MetricsAcceptor->close(ec);
+        if (auto tick = std::atomic_exchange(&m_Tick, std::shared_ptr<TickBatch>()))
+            tick->Close();
+
+        for (const auto& session : *std::atomic_load(&m_Sessions))
+            asio::post(session->Socket.get_executor(), [session] { session->Close(); });
+    }
+
+    void NetworkLayer::DoAccept()
+    {
+        // Round-robin: each student lands on the next io thread, inside a
+        // strand of its own
+        size_t shard = m_IOPool.NextIndex();
+
+        m_Acceptor->async_accept(asio::make_strand(m_IOPool.Get(shard)),
+            [this, shard](beast::error_code ec, tcp::socket socket)
+            {
+                if (!m_Running.load()) return;
+
+                if (!ec) {
+                    // Joins the broadcast list once its handshake completes
+                    std::make_shared<WsSession>(std::move(socket), this, shard)->Start();
+                } else {
+                    ATOMETA_WARN("Accept error: ", ec.message());
+                }
+
+                DoAccept(); // accept next connection
+            });
+    }
+
+    size_t NetworkLayer::Broadcast(const NetMessage& msg)
+    {
+        m_Join->Track(msg);
+        if (auto recorder = std::atomic_load(&m_Recorder))
+            recorder->Record(msg);
+
+        // Latest-wins state goes to the multicast group once; students that
+        // hear the group are skipped below
+        auto   channel   = std::atomic_load(&m_McChannel);
+        size_t mcBytes   = 0;
+        bool   multicast = channel && IsMulticastType(msg.Type) && channel->Send(msg, mcBytes);
+
+        // Everything from this tick leaves together in FlushTick
+        if (m_TickRate.load() > 0) {
+            if (auto tick = std::atomic_load(&m_Tick)) {
+                tick->Add(msg, multicast);
+                return mcBytes;
+            }
+        }
+
+        auto shards = std::atomic_load(&m_Shards);
+        if (shards->empty()) return mcBytes;
+
+        // Encode at most once per wire format in use; all sessions share it.
+        // One handler per io thread that has students, not one per student.
+        // Each pool context runs on a single thread, so the handler is
+        // serialized with every session strand living on that context.
+        SharedPayload encoded[2];
+        size_t        bytes = mcBytes;
+
+        for (size_t shard = 0; shard < shards->size(); ++shard) {
+            if (!(*shards)[shard]) continue;
+
+            bool any = false;
+            for (auto& session : *(*shards)[shard]) {
+                if (multicast && session->Multicast.load()) continue;
+                any = true;
+                auto& payload = encoded[static_cast<size_t>(session->Format)];
+                if (!payload)
+                    payload = std::make_shared<const std::string>(msg.Serialize(session->Format));
+                bytes += payload->size();
+            }
+            if (!any) continue;
+
+            asio::post(m_IOPool.Get(shard),
+                [sessions = (*shards)[shard], multicast,
+                 text   = encoded[0],
+                 binary = encoded[1],
+                 type   = msg.Type]()
+                {
+                    for (auto& session : *sessions) {
+                        if (multicast && session->Multicast.load()) continue;
+
+                        // Null if the session subscribed after the encode
+                        const auto& payload = session->Format == WireFormat::Binary
+                                            ? binary : text;
+                        if (payload) session->Write(payload, type);
+                    }
+                });
+        }
+
+        return bytes;
     }
 
-    bool NetMessage::Deserialize(const std::string& raw, NetMessage& out)
+    // A busy metrics port only costs the scrape, not the session
+    void NetworkLayer::OpenMetrics()
     {
+        if (m_MetricsPort == 0) return;
+
         try {
-            json root = json::parse(raw);
-            out.Type  = static_cast<NetMsgType>(root.at("type").get<int>());
-            out.Data  = root.at("data");
-            return true;
-        } catch (...) {
-            return false;
+            tcp::endpoint endpoint(tcp::v4(), m_MetricsPort);
+            m_MetricsAcceptor = std::make_unique<tcp::acceptor>(m_IOPool.Get(0), endpoint);
+            DoAcceptMetrics();
+            ATOMETA_INFO("Metrics served on port ", m_MetricsPort, " at /metrics");
+        } catch (const std::exception& e) {
+            ATOMETA_WARN("Metrics port ", m_MetricsPort, " unavailable: ", e.what());
+            m_MetricsAcceptor.reset();
         }
     }
 
-    // =========================================================================
-    // WsSession — one connected student (server-side)
-    // =========================================================================
-
-    struct NetworkLayer::WsSession
-        : public std::enable_shared_from_this<WsSession>
+    void NetworkLayer::DoAcceptMetrics()
     {
-        ws::stream<tcp::socket> Socket;
-        beast::flat_buffer      Buffer;
-        NetworkLayer*           Owner = nullptr;
-        std::string             PeerIp;
-
-        explicit WsSession(tcp::socket socket, NetworkLayer* owner)
-            : Socket(std::move(socket)), Owner(owner)
-        {
-            PeerIp = Socket.next_layer()
-                           .remote_endpoint()
-                           .address()
-                           .to_string();
-        }
+        m_MetricsAcceptor->async_accept(m_IOPool.Get(0),
+            [this](beast::error_code ec, tcp::socket socket)
+            {
+                if (!m_Running.load()) return;
 
-        void Start()
-        {
-            // WebSocket handshake
-            Socket.async_accept([self = shared_from_this()](beast::error_code ec) {
-                if (ec) {
-                    ATOMETA_WARN("WS accept error: ", ec.message());
-                    return;
-                }
-                if (self->Owner->m_OnConnect)
-                    self->Owner->m_OnConnect(self->PeerIp);
+                if (!ec)
+                    std::make_shared<MetricsSession>(std::move(socket), this)->Start();
 
-                ATOMETA_INFO("Student connected: ", self->PeerIp);
-                self->DoRead();
+                DoAcceptMetrics();
             });
-        }
+    }
 
-        void DoRead()
-        {
-            Socket.async_read(Buffer,
-                [self = shared_from_this()](beast::error_code ec, std::size_t /*bytes*/)
-                {
-                    if (ec) {
-                        ATOMETA_INFO("Student disconnected: ", self->PeerIp);
-                        if (self->Owner->m_OnDisconnect)
-                            self->Owner->m_OnDisconnect(self->PeerIp);
-                        self->Owner->RemoveSession(self.get());
-                        return;
-                    }
+    void NetworkLayer::FlushTick()
+    {
+        auto tick = std::atomic_load(&m_Tick);
+        if (!tick) return;
+
+        auto entries = tick->Take();
+        auto shards  = std::atomic_load(&m_Shards);
+        if (entries.empty() || shards->empty()) return;
+
+        // One frame per lane, so the tick's camera still goes ahead of its
+        // scene deltas. Encoded at most once per wire format, lane and
+        // whether multicast frames are left out; a lone message is sent
+        // as itself. Clients that negotiated no subprotocol predate Batch
+        // and get the messages one by one instead.
+        struct Frame {
+            bool          Built = false;
+            SharedPayload Payload;
+            NetMsgType    Type  = NetMsgType::Batch;
+            size_t        Count = 0;
+            std::vector<std::pair<SharedPayload, NetMsgType>> Parts;   // for legacy sessions
+        };
+        auto frames = std::make_shared<std::array<Frame, 8>>();
+        auto index  = [](WireFormat format, bool realtime, bool skipMc) {
+            return static_cast<size_t>(format) * 4 + (realtime ? 2 : 0) + (skipMc ? 1 : 0);
+        };
+
+        bool legacy = false;
+        for (auto& sessions : *shards)
+            if (sessions)
+                for (auto& session : *sessions)
+                    legacy |= session->Legacy;
+
+        auto build = [&](WireFormat format, bool realtime, bool skipMc) {
+            Frame& frame = (*frames)[index(format, realtime, skipMc)];
+            if (frame.Built) return;
+            frame.Built = true;
+
+            std::vector<std::string> encoded;
+            std::vector<NetMsgType>  types;
+            for (const auto& entry : entries) {
+                if ((LaneFor(entry.Msg.Type) == Lane::Realtime) != realtime) continue;
+                if (skipMc && entry.Multicast) continue;
+                encoded.push_back(entry.Msg.Serialize(format));
+                types.push_back(entry.Msg.Type);
+                frame.Type = entry.Msg.Type;
+            }
 
-                    std::string text = beast::buffers_to_string(self->Buffer.data());
-                    self->Buffer.consume(self->Buffer.size());
+            frame.Count = encoded.size();
+            if (frame.Count > 1 && legacy && format == WireFormat::Json)
+                for (size_t i = 0; i < encoded.size(); ++i)
+                    frame.Parts.emplace_back(std::make_shared<const std::string>(encoded[i]), types[i]);
 
-                    NetMessage msg;
-                    if (NetMessage::Deserialize(text, msg)) {
-                        if (self->Owner->m_OnMessage)
-                            self->Owner->m_OnMessage(msg);
-                    }
+            if (frame.Count == 1) {
+                frame.Payload = std::make_shared<const std::string>(std::move(encoded[0]));
+            } else if (frame.Count > 1) {
+                frame.Payload = std::make_shared<const std::string>(EncodeBatch(format, encoded));
+                frame.Type    = NetMsgType::Batch;
+            }
+        };
 
-                    self->DoRead(); // keep reading
-                });
+        for (auto& sessions : *shards) {
+            if (!sessions) continue;
+            for (auto& session : *sessions)
+                for (bool realtime : { true, false })
+                    build(session->Format, realtime, session->Multicast.load());
         }
 
-        void Send(const std::string& text)
-        {
-            // Post to strand to avoid data races
-            asio::post(Socket.get_executor(),
-                [self = shared_from_this(), text]() {
-                    beast::error_code ec;
-                    self->Socket.write(asio::buffer(text), ec);
-                    if (ec)
-                        ATOMETA_WARN("WS send error: ", ec.message());
-                });
+        // Each handler only owns its own io thread's sessions (see
+        // StoreSessions)
+        for (size_t shard = 0; shard < shards->size(); ++shard) {
+            if (!(*shards)[shard]) continue;
+
+            asio::post(m_IOPool.Get(shard), [this, sessions = (*shards)[shard], frames, index]() {
+                for (auto& session : *sessions) {
+                    bool skipMc = session->Multicast.load();
+                    for (bool realtime : { true, false }) {
+                        // Fall back on the other variant if the session
+                        // (un)subscribed since the encode
+                        const Frame* frame = &(*frames)[index(session->Format, realtime, skipMc)];
+                        if (!frame->Built)
+                            frame = &(*frames)[index(session->Format, realtime, !skipMc)];
+                        if (!frame->Payload) continue;
+
+                        Lane lane = realtime ? Lane::Realtime : Lane::Control;
+                        if (session->Legacy && !frame->Parts.empty()) {
+                            for (const auto& [payload, type] : frame->Parts)
+                                session->Write(payload, type, lane);
+                            continue;
+                        }
+
+                        session->Write(frame->Payload, frame->Type, lane);
+                        if (frame->Count > 1) {
+                            ++m_Batches;
+                            m_BatchedMessages += frame->Count;
+                        }
+                    }
+                }
+            });
         }
-    };
+    }
 
     // =========================================================================
-    // NetworkLayer
+    // Student messages — admitted per student on its io thread, handed out
+    // round-robin by a dispatcher on pool context 0
     // =========================================================================
 
-    NetworkLayer::NetworkLayer() = default;
-
-    NetworkLayer::~NetworkLayer()
+    void NetworkLayer::QueueStudentMessage(const WsSession& from, NetMessage&& msg)
     {
-        StopHost();
-        Disconnect();
+        // Throttled or overflowing: counted in the inbox stats
+        auto result = m_StudentInbox.Push(from.Id, std::move(msg), NowMicros(),
+                                          1 + from.TreeSubtree.load());
+        if (result != StudentInbox::Result::Queued) return;
+
+        if (!m_InboxDraining.exchange(true))
+            asio::post(m_IOPool.Get(0), [this]() { DrainStudents(); });
     }
 
-    // ── Host ─────────────────────────────────────────────────────────────────
+    void NetworkLayer::DrainStudents()
+    {
+        // A bounded pass per handler, so a backlog never holds context 0
+        // away from the acceptor and the tick for long
+        constexpr size_t kPass = 32;
+
+        std::vector<NetMessage> batch;
+        m_StudentInbox.Drain(batch, kPass);
+        for (const auto& msg : batch)
+            DeliverStudentMessage(msg);
+
+        // Cleared before looking again, so a message queued in between
+        // either is seen here or schedules a pass of its own
+        m_InboxDraining = false;
+        if (m_StudentInbox.GetQueued() > 0 && !m_InboxDraining.exchange(true))
+            asio::post(m_IOPool.Get(0), [this]() { DrainStudents(); });
+    }
 
-    bool NetworkLayer::StartHost(uint16_t port)
+    void NetworkLayer::DeliverStudentMessage(const NetMessage& msg)
     {
-        if (m_Running.load()) {
-            ATOMETA_WARN("NetworkLayer: already running");
-            return false;
+        // A relay passes it on to the professor behind the publisher link
+        if (m_RelayMode) {
+            auto upstream = std::atomic_load(&m_Upstream);
+            if (!upstream) return;
+
+            auto payload = std::make_shared<const std::string>(msg.Serialize(upstream->Format));
+            asio::post(upstream->Socket.get_executor(),
+                [upstream, payload, type = msg.Type]() {
+                    upstream->Write(payload, type);
+                });
+            ++m_MessagesRelayed;
+            return;
         }
 
-        try {
-            tcp::endpoint endpoint(tcp::v4(), port);
-            m_Acceptor = std::make_unique<tcp::acceptor>(m_IOContext, endpoint);
-            m_Role     = NetworkRole::Host;
-            m_Running  = true;
-            m_Connected = true;
+        // A student relaying the tree sends it up its own connection
+        if (m_Role == NetworkRole::Client) {
+            if (QueueUplink(msg)) ++m_MessagesRelayed;
+            return;
+        }
 
-            DoAccept();
+        if (m_OnMessage)
+            m_OnMessage(msg);
+    }
 
-            m_IOThread = std::thread([this]() { RunIOContext(); });
+    void NetworkLayer::AddSession(const std::shared_ptr<WsSession>& session)
+    {
+        std::lock_guard<std::mutex> lock(m_SessionMutex);
+        auto next = std::make_shared<SessionList>(*m_Sessions);
+        next->push_back(session);
+        StoreSessions(std::move(next));
+    }
 
-            ATOMETA_INFO("Session hosted on port ", port);
-            return true;
+    void NetworkLayer::RemoveSession(WsSession* session)
+    {
+        m_StudentInbox.Remove(session->Id);
 
-        } catch (const std::exception& e) {
-            ATOMETA_ERROR("StartHost failed: ", e.what());
-            return false;
-        }
+        std::lock_guard<std::mutex> lock(m_SessionMutex);
+        auto next = std::make_shared<SessionList>(*m_Sessions);
+        next->erase(
+            std::remove_if(next->begin(), next->end(),
+                [session](const std::shared_ptr<WsSession>& s) {
+                    return s.get() == session;
+                }),
+            next->end());
+        StoreSessions(std::move(next));
     }
 
-    void NetworkLayer::StopHost()
+    // Caller holds m_SessionMutex. A handler posted to one pool context
+    // must only keep alive sessions of that context: the pool destroys its
+    // contexts one by one, and a socket outliving its own context would be
+    // destroyed against a freed socket service. Hence the per-shard lists.
+    void NetworkLayer::StoreSessions(std::shared_ptr<SessionList> sessions)
     {
-        if (m_Role != NetworkRole::Host) return;
+        std::vector<std::shared_ptr<SessionList>> split;
+        for (auto& session : *sessions) {
+            if (session->Shard >= split.size()) split.resize(session->Shard + 1);
+            if (!split[session->Shard]) split[session->Shard] = std::make_shared<SessionList>();
+            split[session->Shard]->push_back(session);
+        }
 
-        m_Running   = false;
-        m_Connected = false;
-        m_IOContext.stop();
+        m_ClientCount = static_cast<uint32_t>(sessions->size());
+        std::atomic_store(&m_Shards,
+                          std::make_shared<const ShardList>(split.begin(), split.end()));
+        std::atomic_store(&m_Sessions, std::shared_ptr<const SessionList>(std::move(sessions)));
+    }
 
-        if (m_IOThread.joinable())
-            m_IOThread.join();
+    void NetworkLayer::SetUpstream(const std::shared_ptr<WsSession>& session)
+    {
+        // One professor per relay: a reconnecting publisher replaces the
+        // previous link instead of waiting for it to time out
+        auto previous = std::atomic_exchange(&m_Upstream, session);
+        if (previous && previous != session)
+            asio::post(previous->Socket.get_executor(), [previous]() { previous->Close(); });
 
-        m_Role = NetworkRole::None;
-        ATOMETA_INFO("Host session stopped");
+        if (m_Role == NetworkRole::Publisher)
+            m_Connected = true;
     }
 
-    void NetworkLayer::DoAccept()
+    void NetworkLayer::ClearUpstream(WsSession* session)
     {
-        m_Acceptor->async_accept(
-            [this](beast::error_code ec, tcp::socket socket)
-            {
-                if (!m_Running.load()) return;
+        auto current = std::atomic_load(&m_Upstream);
+        if (current.get() == session)
+            std::atomic_compare_exchange_strong(&m_Upstream, &current,
+                                                std::shared_ptr<WsSession>());
 
-                if (!ec) {
-                    auto session = std::make_shared<WsSession>(
-                        std::move(socket), this);
+        if (m_Role == NetworkRole::Publisher)
+            m_Connected = false;
+    }
 
-                    {
-                        std::lock_guard<std::mutex> lock(m_SessionMutex);
-                        m_Sessions.push_back(session);
-                    }
+    // ── Publisher ─────────────────────────────────────────────────────────────
 
-                    session->Start();
-                } else {
-                    ATOMETA_WARN("Accept error: ", ec.message());
-                }
+    bool NetworkLayer::Publish(const std::string& relayHost, uint16_t port,
+                               const std::string& publishKey)
+    {
+        if (m_Running.load()) {
+            ATOMETA_WARN("NetworkLayer: already running");
+            return false;
+        }
 
-                DoAccept(); // accept next connection
-            });
-    }
+        // Only once the pool is joined: no io thread may see the new role
+        // with the previous session's state
+        ReleasePool();
 
-    void NetworkLayer::BroadcastRaw(const std::string& text)
-    {
-        std::lock_guard<std::mutex> lock(m_SessionMutex);
-        for (auto& session : m_Sessions)
-            session->Send(text);
-    }
+        m_IOPool.Start();
+        m_Role    = NetworkRole::Publisher;
+        m_Running = true;
 
-    void NetworkLayer::RemoveSession(WsSession* session)
-    {
-        std::lock_guard<std::mutex> lock(m_SessionMutex);
-        m_Sessions.erase(
-            std::remove_if(m_Sessions.begin(), m_Sessions.end(),
-                [session](const std::shared_ptr<WsSession>& s) {
-                    return s.get() == session;
-                }),
-            m_Sessions.end());
+        auto session = std::make_shared<WsSession>(
+            tcp::socket(asio::make_strand(m_IOPool.Get(0))), this, 0);
+        session->Connect(relayHost, port, PublishTarget(publishKey));
+
+        ATOMETA_INFO("Connecting to relay at ", relayHost, ":", port);
+        return true;
     }
 
     // ── Client ────────────────────────────────────────────────────────────────
@@ -223,114 +2421,568 @@ namespace Atometa {
             ATOMETA_WARN("NetworkLayer: already running");
             return false;
         }
+        // The role and client state below are reset only once the pool is
+        // joined, so no io thread sees the new role with half-reset state
+        ReleasePool();
 
         m_Role    = NetworkRole::Client;
         m_Running = true;
+        m_ClientRtt->Clear();
+        m_AssetChunksTotal    = 0;
+        m_AssetChunksReceived = 0;
+        m_AssetBytesReceived  = 0;
+        m_JoinLatencyMs = 0.f;
+        {
+            std::lock_guard<std::mutex> lock(m_ReconnectStatsMutex);
+            m_ReconnectStats = ReconnectStats();
+        }
 
-        m_IOThread = std::thread([this, host, port]() {
-            RunClient(host, port);
-        });
+        m_TreeDepth   = 0;
+        m_TreeRepairs = 0;
+        m_TreeParentLatencyUs = 0;
+        if (m_TreePort != 0) {
+            // Students of our own; without the listener this is a plain student
+            m_TreeListening = OpenListener(m_TreePort);
+            if (m_TreeListening.load()) {
+                ATOMETA_INFO("Relaying to students on port ", m_TreePort);
+            }
+        }
+        m_IOPool.Start();   // no-op if the listener started it
 
+        auto link = std::make_shared<ClientLink>(this, m_IOPool.Get(0), TreeAddress{ host, port });
+        std::atomic_store(&m_Client, link);
+        asio::post(link->IO, [link] { link->Start(); });
         return true;
     }
 
     void NetworkLayer::Disconnect()
     {
+        if (m_Role == NetworkRole::Publisher) {
+            ShutdownPool();
+            m_Role = NetworkRole::None;
+            ATOMETA_INFO("Stopped publishing to relay");
+            return;
+        }
         if (m_Role != NetworkRole::Client) return;
 
         m_Running   = false;
         m_Connected = false;
-        m_IOContext.stop();
 
-        if (m_IOThread.joinable())
-            m_IOThread.join();
+        // Nothing here waits on the network: the link closes on its io
+        // thread, and the pool is released by the next start (or the
+        // destructor)
+        if (auto link = std::atomic_exchange(&m_Client, std::shared_ptr<ClientLink>()))
+            asio::post(link->IO, [link] { link->Stop(); });
+
+        // Our students climb back up to our parent
+        if (m_TreeListening.exchange(false))
+            asio::post(m_IOPool.Get(0), [this] { CloseListener(); });
 
         m_Role = NetworkRole::None;
         ATOMETA_INFO("Disconnected from session");
     }
 
-    void NetworkLayer::RunClient(const std::string& host, uint16_t port)
+    void NetworkLayer::SetReconnectBackoff(uint32_t minMs, uint32_t maxMs)
     {
-        try {
-            tcp::resolver resolver(m_IOContext);
-            auto results = resolver.resolve(host, std::to_string(port));
+        m_ReconnectMinMs = std::max<uint32_t>(minMs, 1);
+        m_ReconnectMaxMs = std::max(maxMs, m_ReconnectMinMs.load());
+    }
+
+    ReconnectStats NetworkLayer::GetReconnectStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_ReconnectStatsMutex);
+        return m_ReconnectStats;
+    }
+
+    std::string NetworkLayer::ClientTarget() const
+    {
+        if (m_ResumeToken.empty()) return "/";
+        return "/?resume=" + m_ResumeToken + "&seq=" + std::to_string(m_ResumeSeq);
+    }
 
-            tcp::socket socket(m_IOContext);
-            asio::connect(socket, results.begin(), results.end());
+    // Client state only the io thread touches, reset before the first dial
+    void NetworkLayer::ResetClientState()
+    {
+        m_PendingAssets.clear();
+        m_MissingChunks.clear();
+        m_JoinStartUs  = NowMicros();
+        m_JoinPending  = -1;
+        m_ResumeToken.clear();
+        m_ResumeSeq    = 0;
+        m_Reconnecting = false;
+        m_TreeUp.clear();
+        m_TreeRedirect.reset();
+    }
 
-            ws::stream<tcp::socket> wsStream(std::move(socket));
-            wsStream.handshake(host, "/");
+    // Handles one message from the host; false ends the connection
+    bool NetworkLayer::DispatchClient(NetMessage& msg, ClientLink& link)
+    {
+        if (msg.Type == NetMsgType::Ping) {
+            // Answer straight from the io thread so the host's RTT
+            // does not include a trip through the render loop
+            uint64_t now = NowMicros();
+            if (msg.RoundTrip != 0) {
+                int64_t offset = static_cast<int64_t>(msg.Timestamp + msg.RoundTrip / 2)
+                               - static_cast<int64_t>(now);
+                m_ClientRtt->Add(msg.RoundTrip, offset);
+            }
 
-            m_Connected = true;
-            ATOMETA_INFO("Connected to session at ", host, ":", port);
+            NetMessage pong;
+            pong.Type          = NetMsgType::Pong;
+            pong.Timestamp     = now;
+            pong.EchoTimestamp = msg.Timestamp;
+            link.Write(pong.Serialize(m_ClientFormat.load()));
+
+            // Our students' latency from the host runs through us
+            if (m_TreeListening.load() && msg.RoundTrip != 0) {
+                NetMessage latency;
+                latency.Type = NetMsgType::TreeControl;
+                latency.Data = { { "latencyUs", m_TreeParentLatencyUs.load() + msg.RoundTrip / 2 } };
+                Broadcast(latency);
+            }
+            return true;
+        }
+
+        if (HandleTreeControl(msg))
+            return !m_TreeRedirect;
+
+        if (msg.Type == NetMsgType::SessionInfo) {
+            UpdateMulticast(msg, link);
+            UpdateTree(msg);
+        }
+
+        if (HandleClientAssets(msg, link))
+            return true;
+
+        // Passed on before the join is marked complete, so a relay
+        // adopts the upstream token only once its state matches it
+        ForwardToChildren(msg);
+        TrackJoin(msg);
+        if (m_OnMessage)
+            m_OnMessage(msg);
+        return true;
+    }
+
+    void NetworkLayer::UpdateTree(const NetMessage& info)
+    {
+        // The ancestors of the node we joined, root first
+        m_TreeUp.clear();
+        if (info.Data.contains("tree") && info.Data["tree"].contains("path") &&
+            info.Data["tree"]["path"].is_array()) {
+            for (const auto& entry : info.Data["tree"]["path"]) {
+                TreeAddress address;
+                if (TreeAddressFromJson(entry, address))
+                    m_TreeUp.push_back(std::move(address));
+            }
+        }
+        m_TreeDepth = static_cast<uint32_t>(m_TreeUp.size() + 1);
+
+        if (!m_TreeListening.load()) return;
+
+        json path = json::array();
+        for (const auto& address : m_TreeUp)
+            path.push_back(TreeAddressToJson(address));
+        path.push_back(TreeAddressToJson(m_TreeUpstream));
+        m_Join->SetTree(std::move(path));
+    }
+
+    bool NetworkLayer::HandleTreeControl(const NetMessage& msg)
+    {
+        if (msg.Type != NetMsgType::TreeControl) return false;
+
+        const auto& data = msg.Data;
+        TreeAddress redirect;
+        if (data.contains("redirect") && TreeAddressFromJson(data["redirect"], redirect)) {
+            ATOMETA_INFO("Redirected to relay ", redirect.Host, ":", redirect.Port);
+            m_TreeRedirect = std::make_unique<TreeAddress>(std::move(redirect));
+        }
+        if (data.contains("latencyUs") && data["latencyUs"].is_number_unsigned())
+            m_TreeParentLatencyUs = data["latencyUs"].get<uint32_t>();
+        return true;
+    }
+
+    void NetworkLayer::FlushTreeControl(ClientLink& link)
+    {
+        if (!m_TreeListening.load()) return;
+
+        NetMessage report;
+        report.Type = NetMsgType::TreeControl;
+        report.Data = {
+            { "relay",    m_TreePort          },
+            { "capacity", m_TreeFanout.load() },
+            { "children", GetClientCount()    },
+            { "subtree",  TreeSubtree()       },
+        };
+        if (!m_TreeAdvertise.empty())
+            report.Data["host"] = m_TreeAdvertise;
+
+        // Only when the load changed since the last report on this link
+        if (report.Data == m_TreeReported) return;
+        m_TreeReported = report.Data;
+
+        link.Write(report.Serialize(m_ClientFormat.load()));
+    }
+
+    size_t NetworkLayer::QueueUplink(const NetMessage& msg)
+    {
+        // Encoded now: the host detects the format of every frame, so one
+        // queued before a reconnect is read whatever the new link agreed
+        std::string frame = msg.Serialize(m_ClientFormat.load());
+        size_t      size  = frame.size();
+
+        std::lock_guard<std::mutex> lock(m_UplinkMutex);
+        if (m_Uplink.size() >= kMaxUplink) {
+            ++m_UplinkDropped;
+            return 0;
+        }
+        m_Uplink.push_back(std::move(frame));
+        return size;
+    }
+
+    void NetworkLayer::FlushUplink(ClientLink& link)
+    {
+        if (!link.IsOpen()) return;
 
-            if (m_OnConnect)
-                m_OnConnect(host);
+        std::vector<std::string> frames;
+        {
+            std::lock_guard<std::mutex> lock(m_UplinkMutex);
+            frames.swap(m_Uplink);
+        }
+
+        // Written in order behind anything already queued; the link puts
+        // back whatever a drop keeps from going out
+        for (auto& frame : frames)
+            link.Write(std::move(frame), true);
+    }
 
-            ClientReadLoop(wsStream);
+    void NetworkLayer::ForwardToChildren(const NetMessage& msg)
+    {
+        if (!m_TreeListening.load() || !IsRelayedType(msg.Type)) return;
+        Broadcast(msg);
+        ++m_MessagesRelayed;
+    }
+
+    void NetworkLayer::UpdateMulticast(const NetMessage& info, ClientLink& link)
+    {
+        auto current = std::atomic_load(&m_McListener);
+        if (!m_AcceptMulticast.load() || !info.Data.contains("multicast")) {
+            if (current) std::atomic_store(&m_McListener, std::shared_ptr<MulticastListener>());
+            return;
+        }
 
+        try {
+            const json&   advert = info.Data["multicast"];
+            udp::endpoint group(asio::ip::make_address_v4(advert.at("group").get<std::string>()),
+                                advert.at("port").get<uint16_t>());
+            uint32_t      stream = advert.at("stream").get<uint32_t>();
+            if (current && current->Matches(group, stream)) return;
+
+            // Join on the interface the host is reached through
+            auto local = link.Socket->next_layer().local_endpoint().address();
+            auto iface = local.is_v4() ? local.to_v4() : asio::ip::address_v4::any();
+
+            auto listener = std::make_shared<MulticastListener>(this, group, iface, stream);
+            listener->Start();
+            std::atomic_store(&m_McListener, listener);
+            ATOMETA_INFO("Listening for multicast on ", group.address().to_string(), ":", group.port());
         } catch (const std::exception& e) {
-            ATOMETA_ERROR("Connect failed: ", e.what());
-            m_Connected = false;
-            m_Running   = false;
+            ATOMETA_WARN("Multicast join failed, staying on unicast: ", e.what());
+            std::atomic_store(&m_McListener, std::shared_ptr<MulticastListener>());
         }
     }
 
-    void NetworkLayer::ClientReadLoop(ws::stream<tcp::socket>& wsStream)
+    void NetworkLayer::FlushMulticastControl(ClientLink& link)
     {
-        beast::flat_buffer buffer;
+        auto listener = std::atomic_load(&m_McListener);
+        if (!listener) return;
+
+        std::vector<uint32_t> nacks;
+        bool hearing = listener->IsHearing(nacks);
+
+        NetMessage control;
+        control.Type = NetMsgType::MulticastControl;
+        control.Data = json::object();
+        if (hearing != m_McSubscribed) {
+            control.Data["subscribe"] = hearing;
+            m_McSubscribed = hearing;
+        }
+        // Gaps only matter once the host has stopped the unicast copies
+        if (m_McSubscribed && !nacks.empty())
+            control.Data["nack"] = nacks;
+        if (control.Data.empty()) return;
 
-        while (m_Running.load()) {
-            beast::error_code ec;
-            wsStream.read(buffer, ec);
+        link.Write(control.Serialize(m_ClientFormat.load()));
+    }
+
+    void NetworkLayer::TrackJoin(const NetMessage& msg)
+    {
+        // Where to pick up after a drop: the stream's token and the last
+        // scene update received
+        if (msg.Type == NetMsgType::SceneSnapshot || msg.Type == NetMsgType::SceneDelta)
+            m_ResumeSeq = msg.Sequence;
+
+        if (m_JoinPending == -1) {
+            if (msg.Type != NetMsgType::SessionInfo) return;
+            m_ResumeToken  = msg.Data.value("session", std::string());
+            m_JoinResumed  = msg.Data.value("resumed", false);
+            m_JoinPending  = (msg.Data.value("camera", false) ? 1 : 0)
+                           + (m_JoinResumed ? msg.Data.value("deltas", 0)
+                                            : (msg.Data.value("scene", false) ? 1 : 0));
+        } else if (m_JoinPending > 0 &&
+                   (msg.Type == NetMsgType::CameraSync || msg.Type == NetMsgType::SceneSnapshot ||
+                    msg.Type == NetMsgType::SceneDelta)) {
+            --m_JoinPending;
+        } else {
+            return;
+        }
+
+        if (m_JoinPending != 0) return;
+        m_JoinPending = -2;   // done until the next connection
+
+        // In step with the upstream from here on: students of ours may
+        // resume at any node that passed on the same stream
+        if (m_TreeListening.load())
+            m_Join->Adopt(m_ResumeToken);
+
+        float ms = (NowMicros() - m_JoinStartUs) / 1000.f;
+        if (!m_Reconnecting) {
+            m_JoinLatencyMs = ms;
+            ATOMETA_INFO("Session state received ", ms, " ms after connecting");
+            return;
+        }
+
+        m_Reconnecting = false;
+        std::lock_guard<std::mutex> lock(m_ReconnectStatsMutex);
+        ++(m_JoinResumed ? m_ReconnectStats.Resumed : m_ReconnectStats.FullResyncs);
+        m_ReconnectStats.LastMs = ms;
+        m_ReconnectStats.MaxMs  = std::max(m_ReconnectStats.MaxMs, ms);
+        ATOMETA_INFO(m_JoinResumed ? "Session resumed " : "Session resynced ", ms, " ms after the drop");
+    }
+
+    bool NetworkLayer::HandleClientAssets(const NetMessage& msg, ClientLink& link)
+    {
+        if (msg.Type == NetMsgType::AssetManifest) {
+            m_PendingAssets.clear();
+            m_MissingChunks.clear();
+
+            if (msg.Data.contains("assets") && msg.Data["assets"].is_array()) {
+                for (const auto& entry : msg.Data["assets"]) {
+                    AssetInfo asset;
+                    if (AssetInfo::FromJson(entry, asset))
+                        m_PendingAssets.push_back(std::move(asset));
+                }
+            }
+
+            std::vector<std::string> missing;
+            for (const auto& asset : m_PendingAssets)
+                for (auto& hash : m_AssetCache.MissingChunks(asset))
+                    if (m_MissingChunks.insert(hash).second)
+                        missing.push_back(std::move(hash));
 
-            if (ec) {
-                ATOMETA_INFO("Session closed: ", ec.message());
-                break;
+            m_AssetChunksTotal    = static_cast<uint32_t>(missing.size());
+            m_AssetChunksReceived = 0;
+
+            if (missing.empty()) {
+                FinishAssets();
+                return true;
             }
 
-            std::string text = beast::buffers_to_string(buffer.data());
-            buffer.consume(buffer.size());
+            ATOMETA_INFO("Fetching ", missing.size(), " asset chunks from host");
+            NetMessage request;
+            request.Type = NetMsgType::AssetRequest;
+            request.Data = { { "chunks", std::move(missing) } };
+            link.Write(request.Serialize(m_ClientFormat.load()));
+            return true;
+        }
 
-            NetMessage msg;
-            if (NetMessage::Deserialize(text, msg) && m_OnMessage)
-                m_OnMessage(msg);
+        if (msg.Type == NetMsgType::AssetChunk) {
+            if (!m_MissingChunks.count(msg.ChunkHash))
+                return true; // not asked for (or already have it)
+
+            if (!m_AssetCache.PutChunk(msg.ChunkHash, msg.Blob)) {
+                ATOMETA_WARN("Discarding corrupt asset chunk ", msg.ChunkHash);
+                return true;
+            }
+
+            m_MissingChunks.erase(msg.ChunkHash);
+            ++m_AssetChunksReceived;
+            m_AssetBytesReceived += msg.Blob.size();
+
+            if (m_MissingChunks.empty())
+                FinishAssets();
+            return true;
         }
 
-        m_Connected = false;
-        if (m_OnDisconnect)
-            m_OnDisconnect("host");
+        return false;
+    }
+
+    void NetworkLayer::FinishAssets()
+    {
+        NetMessage ready;
+        ready.Type = NetMsgType::AssetManifest;
+        ready.Data = { { "assets", json::array() } };
+
+        for (const auto& asset : m_PendingAssets) {
+            json entry = asset.ToJson();
+            entry["localPath"] = m_AssetCache.Assemble(asset);
+            ready.Data["assets"].push_back(std::move(entry));
+        }
+        m_PendingAssets.clear();
+
+        if (m_OnMessage)
+            m_OnMessage(ready);
+    }
+
+    AssetProgress NetworkLayer::GetAssetProgress() const
+    {
+        AssetProgress progress;
+        progress.ChunksTotal    = m_AssetChunksTotal.load();
+        progress.ChunksReceived = m_AssetChunksReceived.load();
+        progress.BytesReceived  = m_AssetBytesReceived.load();
+        return progress;
     }
 
     // ── Shared ────────────────────────────────────────────────────────────────
 
-    void NetworkLayer::Send(const NetMessage& msg)
+    size_t NetworkLayer::Send(const NetMessage& msg)
     {
-        std::string text = msg.Serialize();
+        if (m_Role == NetworkRole::Host)
+            return Broadcast(msg);
+
+        if (m_Role == NetworkRole::Publisher) {
+            if (auto recorder = std::atomic_load(&m_Recorder))
+                recorder->Record(msg);
+
+            auto upstream = std::atomic_load(&m_Upstream);
+            if (!upstream) return 0;
 
-        if (m_Role == NetworkRole::Host) {
-            BroadcastRaw(text);
+            auto payload = std::make_shared<const std::string>(msg.Serialize(upstream->Format));
+            asio::post(upstream->Socket.get_executor(),
+                [upstream, payload, type = msg.Type]() {
+                    upstream->Write(payload, type);
+                });
+            return payload->size();
+        }
+
+        if (m_Role == NetworkRole::Client) {
+            size_t bytes = QueueUplink(msg);
+            if (auto link = std::atomic_load(&m_Client); link && bytes > 0)
+                asio::post(link->IO, [this, link] { FlushUplink(*link); });
+            return bytes;
+        }
+
+        return 0;
+    }
+
+    std::vector<SessionStats> NetworkLayer::GetSessionStats() const
+    {
+        auto sessions = std::atomic_load(&m_Sessions);
+
+        std::vector<SessionStats> stats;
+        stats.reserve(sessions->size());
+        for (auto& session : *sessions) {
+            SessionStats s;
+            s.PeerIp        = session->PeerIp;
+            s.Format        = session->Format;
+            s.QueueDepth    = session->QueueDepth.load();
+            s.MaxQueueDepth = session->MaxQueueDepth.load();
+            s.Lanes         = session->Lanes.GetStats();
+            s.MessagesSent  = session->MessagesSent.load();
+            s.BytesSent     = session->BytesSent.load();
+            s.Coalesced     = session->Coalesced.load();
+            s.RoundTrip     = session->Rtt.Summary();
+            s.AssetChunksSent    = session->AssetChunksSent.load();
+            s.AssetChunksPending = session->AssetChunksPending.load();
+            s.TreeRelay          = std::atomic_load(&session->TreeRelay) != nullptr;
+            s.TreeSubtree        = session->TreeSubtree.load();
+            s.Inbox              = m_StudentInbox.GetStats(session->Id);
+            stats.push_back(std::move(s));
         }
-        // Client sending not needed for MVP (professor only broadcasts)
+        return stats;
+    }
+
+    RoundTripStats NetworkLayer::GetRoundTrip() const
+    {
+        return m_ClientRtt->Summary();
+    }
+
+    NetworkStats NetworkLayer::GetStats() const
+    {
+        NetworkStats stats;
+        stats.Clients          = GetClientCount();
+        stats.MessagesSent     = m_MessagesSent.load();
+        stats.BytesSent        = m_BytesSent.load();
+        stats.MessagesReceived = m_MessagesReceived.load();
+        stats.BytesReceived    = m_BytesReceived.load();
+        stats.MessagesRelayed  = m_MessagesRelayed.load();
+        stats.DroppedClients   = m_DroppedClients.load();
+        stats.JoinSnapshots    = m_JoinSnapshots.load();
+        stats.ResumedJoins     = m_ResumedJoins.load();
+        stats.Batches          = m_Batches.load();
+        stats.BatchedMessages  = m_BatchedMessages.load();
+        stats.StudentMessages  = m_StudentInbox.GetTotals();
+        stats.UplinkDropped    = m_UplinkDropped.load();
+        stats.CompressedIn     = m_CompressedIn.load();
+        stats.CompressedOut    = m_CompressedOut.load();
+        return stats;
     }
 
     uint32_t NetworkLayer::GetClientCount() const
     {
-        std::lock_guard<std::mutex> lock(
-            const_cast<std::mutex&>(m_SessionMutex));
-        return static_cast<uint32_t>(m_Sessions.size());
+        return m_ClientCount.load();
     }
 
-    void NetworkLayer::RunIOContext()
+    // ── Metrics ──────────────────────────────────────────────────────────────
+
+    void NetworkLayer::RecordFrameTime(float seconds)
     {
-        while (m_Running.load()) {
-            try {
-                m_IOContext.run();
-                break; // run() returns when no more work
-            } catch (const std::exception& e) {
-                ATOMETA_ERROR("IO context error: ", e.what());
-            }
+        m_FrameTime.Observe(static_cast<uint64_t>(std::max(seconds, 0.0f) * 1e6f));
+    }
+
+    std::string NetworkLayer::GetMetricsText() const
+    {
+        MetricsText out;
+
+        out.Family("atometa_clients", "gauge", "Students connected to this host or relay.");
+        out.Sample("atometa_clients", uint64_t(GetClientCount()));
+
+        out.Family("atometa_messages_sent_total", "counter", "WebSocket messages sent to students.");
+        out.Sample("atometa_messages_sent_total", m_MessagesSent.load());
+        out.Family("atometa_bytes_sent_total", "counter", "WebSocket bytes sent to students.");
+        out.Sample("atometa_bytes_sent_total", m_BytesSent.load());
+        out.Family("atometa_messages_received_total", "counter", "WebSocket messages received.");
+        out.Sample("atometa_messages_received_total", m_MessagesReceived.load());
+        out.Family("atometa_bytes_received_total", "counter", "WebSocket bytes received.");
+        out.Sample("atometa_bytes_received_total", m_BytesReceived.load());
+
+        out.Family("atometa_compressed_in_bytes_total", "counter",
+                   "Bytes of frames deflated for students, before compression.");
+        out.Sample("atometa_compressed_in_bytes_total", m_CompressedIn.load());
+        out.Family("atometa_compressed_out_bytes_total", "counter",
+                   "Bytes of frames deflated for students, after compression.");
+        out.Sample("atometa_compressed_out_bytes_total", m_CompressedOut.load());
+
+        out.Family("atometa_dropped_clients_total", "counter",
+                   "Students disconnected for falling too far behind.");
+        out.Sample("atometa_dropped_clients_total", m_DroppedClients.load());
+
+        out.Family("atometa_lane_queued", "gauge", "Frames waiting to be written, per lane.");
+        for (size_t i = 0; i < kLaneCount; ++i) {
+            int64_t queued = std::max<int64_t>(m_LaneQueued[i].load(std::memory_order_relaxed), 0);
+            out.Sample("atometa_lane_queued", uint64_t(queued),
+                       std::string("lane=\"") + LaneName(static_cast<Lane>(i)) + "\"");
         }
+
+        out.Family("atometa_send_latency_seconds", "histogram",
+                   "Time from queuing a message until its last byte was written, per lane.");
+        for (size_t i = 0; i < kLaneCount; ++i)
+            out.Histogram("atometa_send_latency_seconds", m_SendLatency[i].Read(),
+                          std::string("lane=\"") + LaneName(static_cast<Lane>(i)) + "\"");
+
+        out.Family("atometa_frame_time_seconds", "histogram", "Render frame time of the host.");
+        out.Histogram("atometa_frame_time_seconds", m_FrameTime.Read());
+
+        return out.Str();
     }
 
 } // namespace Atometa
\ No newline at end of file
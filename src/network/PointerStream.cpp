@@ -0,0 +1,306 @@
+#include "Atometa/Network/PointerStream.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Atometa {
+
+    namespace {
+
+        // Largest move one delta can carry
+        constexpr float kMaxPointerDelta = 32767 * kPointerStep;
+
+        float MaxDifference(const std::array<float, 3>& a, const std::array<float, 3>& b)
+        {
+            return std::max({ std::fabs(a[0] - b[0]), std::fabs(a[1] - b[1]),
+                              std::fabs(a[2] - b[2]) });
+        }
+
+        std::array<float, 3> Lerp(const std::array<float, 3>& a, const std::array<float, 3>& b,
+                                  double alpha)
+        {
+            float t = static_cast<float>(std::clamp(alpha, 0.0, 1.0));
+            return { a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t,
+                     a[2] + (b[2] - a[2]) * t };
+        }
+
+    } // namespace
+
+    // =========================================================================
+    // PointerStream
+    // =========================================================================
+
+    PointerStream::PointerStream(const PointerStreamSettings& settings)
+        : m_Settings(settings)
+    {
+    }
+
+    size_t PointerStream::WireCost(size_t samples)
+    {
+        samples = std::min<size_t>(samples, 255);
+        size_t payload = kWireHeaderSize + 13 + (samples ? 12 + 8 * (samples - 1) : 0);
+
+        // Server frames are unmasked: 2 header bytes, 4 past 125 bytes
+        return payload + (payload < 126 ? 2 : 4);
+    }
+
+    void PointerStream::AddSample(double now, const std::array<float, 3>& position)
+    {
+        ++m_Stats.SamplesOffered;
+
+        if (m_Visible && m_HasLast) {
+            float moved = MaxDifference(position, m_Last.Position);
+            if (moved < m_Settings.MinMove) return;
+
+            // Too far for a delta: what is pending would only lead up to
+            // a position the pointer has already left
+            if (moved > kMaxPointerDelta) {
+                m_Stats.SamplesDropped += m_Pending.size();
+                m_Pending.clear();
+            }
+        }
+
+        if (!m_Visible) {
+            m_Visible = true;
+            m_Changed = true;
+        }
+
+        m_Last    = { static_cast<uint64_t>(now * 1e6), position };
+        m_HasLast = true;
+        m_Pending.push_back(m_Last);
+
+        while (m_Pending.size() > std::max<size_t>(m_Settings.Capacity, 1)) {
+            m_Pending.pop_front();
+            ++m_Stats.SamplesDropped;
+        }
+    }
+
+    void PointerStream::Hide(double now)
+    {
+        if (!m_Visible) return;
+
+        m_Stats.SamplesDropped += m_Pending.size();
+        m_Pending.clear();
+        m_Last.TimeUs = static_cast<uint64_t>(now * 1e6);
+        m_HasLast     = false;
+        m_Visible     = false;
+        m_Changed     = true;
+    }
+
+    bool PointerStream::Update(double now, NetMessage& out)
+    {
+        if (m_HasSent && m_Settings.TickHz > 0.0f && now - m_LastSend < 1.0 / m_Settings.TickHz)
+            return false;
+
+        // A resting pointer is repeated now and then, so a student that
+        // lost the last message, or just joined, still shows it
+        bool keyframe = m_Visible && m_HasLast && m_Pending.empty() &&
+                        (!m_HasSent || (m_Settings.KeyframeInterval > 0.0f &&
+                                        now - m_LastSend >= m_Settings.KeyframeInterval));
+        if (m_Pending.empty() && !m_Changed && !keyframe)
+            return false;
+
+        uint64_t nowUs = static_cast<uint64_t>(now * 1e6);
+        double   rate  = std::max(m_Settings.BudgetBytes, 0.0f);
+        double   burst = Burst();
+        double   funds = m_Budget.Refill(rate, burst, nowUs);
+
+        // Samples the bucket can pay for this tick
+        size_t count = 0;
+        if (!m_Pending.empty()) {
+            if (funds < WireCost(1)) return false;
+            size_t affordable = 1 + static_cast<size_t>((funds - WireCost(1)) / 8.0);
+            count = std::min({ affordable, m_Pending.size(), size_t(255) });
+            while (count > 1 && WireCost(count) > funds) --count;   // longer frame header
+        } else if (keyframe) {
+            if (funds < WireCost(1)) return false;
+            m_Pending.push_back({ nowUs, m_Last.Position });
+            count = 1;
+        } else if (funds < WireCost(0)) {
+            return false;
+        }
+
+        out.Type      = NetMsgType::Pointer;
+        out.Sequence  = ++m_Sequence;
+        out.Timestamp = count ? 0 : m_Last.TimeUs;
+        out.Pointer.clear();
+
+        // Evenly spaced through the tick, first and newest included
+        size_t available = m_Pending.size();
+        for (size_t k = 0; k < count; ++k) {
+            size_t i = count == 1 ? available - 1
+                                  : static_cast<size_t>(std::llround(
+                                        double(k) * (available - 1) / (count - 1)));
+            const Sample& sample = m_Pending[i];
+            if (k == 0) out.Timestamp = sample.TimeUs;
+            out.Pointer.push_back({ static_cast<uint32_t>(sample.TimeUs - out.Timestamp),
+                                    sample.Position });
+        }
+
+        size_t cost = WireCost(count);
+        m_Budget.Take(static_cast<double>(cost), rate, burst, nowUs);
+
+        if (!keyframe) {
+            m_Stats.SamplesSent    += count;
+            m_Stats.SamplesDropped += available - count;
+        }
+        ++m_Stats.MessagesSent;
+        m_Stats.BytesSent += cost;
+
+        m_Pending.clear();
+        m_Changed  = false;
+        m_LastSend = now;
+        m_HasSent  = true;
+        return true;
+    }
+
+    void PointerStream::Reset()
+    {
+        m_HasSent = false;
+    }
+
+    // Two ticks' worth, and never less than one single-sample message
+    double PointerStream::Burst() const
+    {
+        double span = m_Settings.TickHz > 0.0f ? 2.0 / m_Settings.TickHz : 0.1;
+        return std::max<double>(m_Settings.BudgetBytes * span, WireCost(1));
+    }
+
+    // =========================================================================
+    // PointerTrack
+    // =========================================================================
+
+    PointerTrack::PointerTrack(const PointerTrackSettings& settings)
+        : m_Settings(settings)
+    {
+    }
+
+    void PointerTrack::Push(const NetMessage& msg, double localTime)
+    {
+        if (msg.Type != NetMsgType::Pointer || msg.Sequence == 0) return;
+
+        // A counter far behind the last one means the host restarted
+        if (m_LastSeq != 0 && msg.Sequence + m_Settings.Capacity < m_LastSeq)
+            Reset();
+
+        if (m_LastSeq != 0 && msg.Sequence <= m_LastSeq) {
+            ++m_Stats.Late;
+            return;
+        }
+
+        ++m_Stats.Received;
+
+        // Transit is measured to the newest sample: the message left
+        // right after it was taken
+        double first   = msg.Timestamp * 1e-6;
+        double newest  = msg.Pointer.empty() ? first : first + msg.Pointer.back().OffsetUs * 1e-6;
+        double transit = localTime - newest;
+
+        if (m_LastSeq == 0) {
+            m_Offset      = transit;
+            m_LastTransit = transit;
+        } else {
+            m_Stats.Lost += msg.Sequence - m_LastSeq - 1;
+
+            double d = std::fabs(transit - m_LastTransit);
+            m_Stats.Jitter += static_cast<float>((d - m_Stats.Jitter) / 16.0);
+            m_LastTransit   = transit;
+
+            double dt = newest - m_LastHost;
+            m_Offset  = std::min(transit, m_Offset + 0.001 * std::max(0.0, dt));
+
+            if (dt > 0.0 && dt < m_Settings.MaxDelay)
+                m_Interval = m_Interval > 0.0 ? m_Interval + (dt - m_Interval) / 8.0 : dt;
+        }
+
+        m_LastSeq     = msg.Sequence;
+        m_LastHost    = newest;
+        m_LastArrival = localTime;
+
+        auto append = [this](const Entry& entry) {
+            if (!m_Entries.empty() && entry.HostTime <= m_Entries.back().HostTime) return;
+            m_Entries.push_back(entry);
+        };
+
+        if (msg.Pointer.empty()) {
+            Entry hidden;
+            hidden.HostTime = first;
+            if (!m_Entries.empty()) hidden.Position = m_Entries.back().Position;
+            append(hidden);
+        }
+        for (const auto& sample : msg.Pointer) {
+            append({ first + sample.OffsetUs * 1e-6, sample.Position, true });
+            ++m_Stats.Samples;
+        }
+
+        while (m_Entries.size() > std::max<size_t>(m_Settings.Capacity, 2)) {
+            m_Previous    = m_Entries.front();
+            m_HasPrevious = true;
+            m_Entries.pop_front();
+        }
+        m_Stats.Delay = PlayoutDelay();
+    }
+
+    bool PointerTrack::Sample(double localTime, std::array<float, 3>& out)
+    {
+        if (m_Entries.empty()) return false;
+
+        // The host went quiet: even a visible pointer is resent twice a
+        // second, so a lost hide or a dropped host must not leave it up
+        if (localTime - m_LastArrival > m_Settings.HideAfter) return false;
+
+        // Playout point on the host clock
+        double t = localTime - m_Offset - PlayoutDelay();
+
+        while (m_Entries.size() >= 2 && m_Entries[1].HostTime <= t) {
+            m_Previous    = m_Entries.front();
+            m_HasPrevious = true;
+            m_Entries.pop_front();
+        }
+
+        const Entry& a = m_Entries.front();
+
+        if (t < a.HostTime) {
+            // Not shown before the first sample arrived, nor while hidden
+            if (!m_HasPrevious || !m_Previous.Visible) return false;
+
+            if (a.Visible && m_Previous.HostTime <= t)
+                out = Lerp(m_Previous.Position, a.Position,
+                           (t - m_Previous.HostTime) / (a.HostTime - m_Previous.HostTime));
+            else
+                out = m_Previous.Position;
+            return true;
+        }
+
+        if (!a.Visible) return false;
+
+        // Past the newest sample the pointer rests where it was last seen
+        if (m_Entries.size() >= 2 && m_Entries[1].Visible) {
+            const Entry& b = m_Entries[1];
+            out = Lerp(a.Position, b.Position, (t - a.HostTime) / (b.HostTime - a.HostTime));
+        } else {
+            out = a.Position;
+        }
+        return true;
+    }
+
+    void PointerTrack::Reset()
+    {
+        m_Entries.clear();
+        m_HasPrevious  = false;
+        m_Offset       = 0.0;
+        m_LastTransit  = 0.0;
+        m_Interval     = 0.0;
+        m_LastHost     = 0.0;
+        m_LastArrival  = 0.0;
+        m_LastSeq      = 0;
+        m_Stats.Jitter = 0.f;
+    }
+
+    float PointerTrack::PlayoutDelay() const
+    {
+        float delay = static_cast<float>(m_Interval) + 3.0f * m_Stats.Jitter;
+        return std::clamp(delay, m_Settings.MinDelay, m_Settings.MaxDelay);
+    }
+
+} // namespace Atometa
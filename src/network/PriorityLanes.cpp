@@ -0,0 +1,253 @@
+#include "Atometa/Network/PriorityLanes.h"
+
+#include <algorithm>
+
+namespace Atometa {
+
+    Lane LaneFor(NetMsgType type)
+    {
+        switch (type) {
+            case NetMsgType::CameraSync:
+            case NetMsgType::NodeSelect:
+            case NetMsgType::Pointer:
+            case NetMsgType::Ping:
+            case NetMsgType::Pong:
+                return Lane::Realtime;
+            case NetMsgType::AssetChunk:
+                return Lane::Bulk;
+            default:
+                return Lane::Control;
+        }
+    }
+
+    const char* LaneName(Lane lane)
+    {
+        switch (lane) {
+            case Lane::Realtime: return "realtime";
+            case Lane::Control:  return "control";
+            case Lane::Bulk:     return "bulk";
+        }
+        return "?";
+    }
+
+    // =========================================================================
+    // LaneScheduler
+    // =========================================================================
+
+    LaneScheduler::LaneScheduler(LaneWeights weights, size_t maxFragment)
+        : m_Weights(weights), m_MaxFragment(std::max<size_t>(maxFragment, 1))
+    {
+    }
+
+    LaneScheduler::PushResult LaneScheduler::Push(SharedPayload payload, NetMsgType type,
+                                                  Lane lane, uint64_t nowUs)
+    {
+        auto& queue = m_Lanes[static_cast<size_t>(lane)];
+
+        // Latest wins — but never swap out a frame already partly written.
+        // A pointer message behind a newer one only trails the pointer.
+        if (type == NetMsgType::CameraSync || type == NetMsgType::Pointer) {
+            for (auto& entry : queue) {
+                if (entry.Type == type && entry.Sent == 0) {
+                    entry.Payload    = std::move(payload);
+                    entry.EnqueuedUs = nowUs;
+                    return PushResult::Coalesced;
+                }
+            }
+        }
+
+        queue.push_back({ std::move(payload), type, nowUs });
+
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        ++m_Stats[static_cast<size_t>(lane)].Queued;
+        return PushResult::Queued;
+    }
+
+    size_t LaneScheduler::SliceSize(const Entry& entry) const
+    {
+        size_t total = entry.Payload->size();
+        if (!m_Fragmenting || total <= m_MaxFragment)
+            return total;
+        return std::min(m_MaxFragment, total - entry.Sent) + kFragmentHeaderSize;
+    }
+
+    // Deficit round-robin between the control and bulk lanes: each turn
+    // credits the lane its quantum, and it sends while the credit covers
+    // the next slice
+    Lane LaneScheduler::PickWeighted()
+    {
+        auto flip = [this] {
+            m_Turn  = m_Turn == Lane::Control ? Lane::Bulk : Lane::Control;
+            m_Fresh = true;
+        };
+
+        for (;;) {
+            size_t i     = static_cast<size_t>(m_Turn);
+            auto&  queue = m_Lanes[i];
+            if (queue.empty()) {
+                m_Deficit[i] = 0;
+                flip();
+                continue;
+            }
+
+            if (m_Fresh) {
+                uint32_t weight = m_Turn == Lane::Control ? m_Weights.Control : m_Weights.Bulk;
+                m_Deficit[i] += std::max<uint32_t>(weight, 1)
+                              * (m_MaxFragment + kFragmentHeaderSize);
+                m_Fresh = false;
+            }
+
+            size_t size = SliceSize(queue.front());
+            if (m_Deficit[i] >= size) {
+                m_Deficit[i] -= size;
+                return m_Turn;
+            }
+            flip();
+        }
+    }
+
+    void LaneScheduler::Take(Lane lane, LaneSlice& out)
+    {
+        auto&  queue = m_Lanes[static_cast<size_t>(lane)];
+        Entry& entry = queue.front();
+        size_t total = entry.Payload->size();
+
+        out.Payload    = entry.Payload;
+        out.From       = lane;
+        out.Type       = entry.Type;
+        out.EnqueuedUs = entry.EnqueuedUs;
+
+        if (!m_Fragmenting || total <= m_MaxFragment) {
+            out.Header.clear();
+            out.Offset = 0;
+            out.Size   = total;
+            out.Last   = true;
+        } else {
+            if (entry.Sent == 0)
+                entry.Id = ++m_NextId;
+            out.Offset  = entry.Sent;
+            out.Size    = std::min(m_MaxFragment, total - entry.Sent);
+            out.Header  = EncodeFragmentHeader(entry.Id, static_cast<uint32_t>(total),
+                                               static_cast<uint32_t>(entry.Sent));
+            entry.Sent += out.Size;
+            out.Last    = entry.Sent == total;
+        }
+
+        if (out.Last) {
+            queue.pop_front();
+            std::lock_guard<std::mutex> lock(m_StatsMutex);
+            --m_Stats[static_cast<size_t>(lane)].Queued;
+        }
+    }
+
+    bool LaneScheduler::Next(LaneSlice& out)
+    {
+        if (IsEmpty()) return false;
+
+        Take(IsEmpty(Lane::Realtime) ? PickWeighted() : Lane::Realtime, out);
+        return true;
+    }
+
+    void LaneScheduler::Done(const LaneSlice& slice, uint64_t nowUs)
+    {
+        size_t i = static_cast<size_t>(slice.From);
+
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        auto& stats = m_Stats[i];
+        stats.Bytes += slice.Header.size() + slice.Size;
+        if (slice.IsFragment()) ++stats.Fragments;
+        if (!slice.Last) return;
+
+        ++stats.Messages;
+        auto&    history = m_History[i];
+        uint64_t latency = nowUs > slice.EnqueuedUs ? nowUs - slice.EnqueuedUs : 0;
+        history.LatencyUs[history.Next] = static_cast<uint32_t>(std::min<uint64_t>(latency, UINT32_MAX));
+        history.Next  = (history.Next + 1) % kWindow;
+        history.Count = std::min(history.Count + 1, kWindow);
+    }
+
+    size_t LaneScheduler::Pending() const
+    {
+        return m_Lanes[static_cast<size_t>(Lane::Realtime)].size()
+             + m_Lanes[static_cast<size_t>(Lane::Control)].size();
+    }
+
+    bool LaneScheduler::IsEmpty() const
+    {
+        for (const auto& queue : m_Lanes)
+            if (!queue.empty()) return false;
+        return true;
+    }
+
+    void LaneScheduler::Clear()
+    {
+        for (auto& queue : m_Lanes) queue.clear();
+        m_Deficit.fill(0);
+        m_Fresh = true;
+
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        for (auto& stats : m_Stats) stats.Queued = 0;
+    }
+
+    std::array<LaneStats, kLaneCount> LaneScheduler::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_StatsMutex);
+        auto out = m_Stats;
+
+        for (size_t i = 0; i < kLaneCount; ++i) {
+            const auto& history = m_History[i];
+            if (history.Count == 0) continue;
+
+            std::array<uint32_t, kWindow> sorted;
+            std::copy(history.LatencyUs.begin(), history.LatencyUs.begin() + history.Count,
+                      sorted.begin());
+            std::sort(sorted.begin(), sorted.begin() + history.Count);
+
+            size_t count = history.Count;
+            size_t p50   = (count - 1) / 2;
+            size_t p99   = std::min(count - 1, (count * 99 + 99) / 100 - 1);
+            out[i].P50Ms = sorted[p50] / 1000.f;
+            out[i].P99Ms = sorted[p99] / 1000.f;
+            out[i].MaxMs = sorted[count - 1] / 1000.f;
+        }
+        return out;
+    }
+
+    // =========================================================================
+    // FragmentAssembler
+    // =========================================================================
+
+    FragmentAssembler::Result FragmentAssembler::Add(const NetMessage& fragment, std::string& frame)
+    {
+        if (fragment.Type != NetMsgType::Fragment) return Result::Invalid;
+
+        uint32_t id     = fragment.Sequence;
+        uint32_t total  = fragment.FragmentTotal;
+        uint32_t offset = fragment.FragmentOffset;
+        if (total == 0 || total > kMaxFrame) return Result::Invalid;
+
+        auto it = std::find_if(m_Open.begin(), m_Open.end(),
+                               [id](const Partial& p) { return p.Id == id; });
+        if (it == m_Open.end()) {
+            if (offset != 0) return Result::Invalid;
+            if (m_Open.size() >= kMaxOpen)
+                m_Open.erase(m_Open.begin());   // oldest is the least likely to finish
+            m_Open.push_back({ id, total, {} });
+            it = m_Open.end() - 1;
+        }
+
+        if (it->Total != total || offset != it->Data.size() ||
+            fragment.Blob.size() > total - offset) {
+            m_Open.erase(it);
+            return Result::Invalid;
+        }
+
+        it->Data += fragment.Blob;
+        if (it->Data.size() < total) return Result::Partial;
+
+        frame = std::move(it->Data);
+        m_Open.erase(it);
+        return Result::Complete;
+    }
+
+} // namespace Atometa
@@ -0,0 +1,193 @@
+#include "Atometa/Network/SceneReplication.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace Atometa {
+
+    namespace {
+
+        // Copies the fields set in mask from src to dst
+        void MergeFields(NetNode& dst, const NetNode& src, uint8_t mask)
+        {
+            if (mask & kNodeFieldPosition) dst.Position = src.Position;
+            if (mask & kNodeFieldRotation) dst.Rotation = src.Rotation;
+            if (mask & kNodeFieldScale)    dst.Scale    = src.Scale;
+            if (mask & kNodeFieldVisible)  dst.Visible  = src.Visible;
+            if (mask & kNodeFieldName)     dst.Name     = src.Name;
+        }
+
+    } // namespace
+
+    // =========================================================================
+    // SceneReplicator
+    // =========================================================================
+
+    void SceneReplicator::SetNodeCount(size_t count)
+    {
+        count = std::min<size_t>(count, UINT16_MAX);
+        if (count == m_Nodes.size()) return;
+
+        size_t old = m_Nodes.size();
+        m_Nodes.resize(count);
+        for (size_t i = old; i < count; ++i) {
+            m_Nodes[i].Index  = static_cast<uint16_t>(i);
+            m_Nodes[i].Fields = kNodeFieldAll;
+        }
+        m_CountDirty = true;
+    }
+
+    void SceneReplicator::SetNode(size_t index, const NetNode& state)
+    {
+        if (index >= m_Nodes.size()) return;
+
+        NetNode& node = m_Nodes[index];
+        uint8_t  changed = 0;
+        if (node.Position != state.Position) changed |= kNodeFieldPosition;
+        if (node.Rotation != state.Rotation) changed |= kNodeFieldRotation;
+        if (node.Scale    != state.Scale)    changed |= kNodeFieldScale;
+        if (node.Visible  != state.Visible)  changed |= kNodeFieldVisible;
+        if (node.Name     != state.Name)     changed |= kNodeFieldName;
+
+        MergeFields(node, state, changed);
+        node.Fields |= changed;
+    }
+
+    void SceneReplicator::SetSelection(int32_t index)
+    {
+        if (index == m_Selection) return;
+        m_Selection      = index;
+        m_SelectionDirty = true;
+    }
+
+    bool SceneReplicator::HasChanges() const
+    {
+        if (m_SelectionDirty || m_CountDirty) return true;
+        for (const auto& node : m_Nodes)
+            if (node.Fields) return true;
+        return false;
+    }
+
+    bool SceneReplicator::BuildDelta(NetMessage& out)
+    {
+        if (!HasChanges()) return false;
+
+        out = NetMessage();
+        out.Type      = NetMsgType::SceneDelta;
+        out.Sequence  = ++m_Sequence;
+        out.NodeCount = static_cast<uint16_t>(m_Nodes.size());
+        out.NodeIndex = m_Selection;
+
+        for (auto& node : m_Nodes) {
+            if (!node.Fields) continue;
+            out.Nodes.push_back(node);
+            m_Stats.FieldsSent += std::bitset<8>(node.Fields).count();
+            node.Fields = 0;
+        }
+
+        m_SelectionDirty = false;
+        m_CountDirty     = false;
+        ++m_Stats.DeltasBuilt;
+        m_Stats.NodesSent += out.Nodes.size();
+        return true;
+    }
+
+    NetMessage SceneReplicator::BuildSnapshot()
+    {
+        NetMessage out;
+        out.Type      = NetMsgType::SceneSnapshot;
+        out.Sequence  = m_Sequence;
+        out.NodeCount = static_cast<uint16_t>(m_Nodes.size());
+        out.NodeIndex = m_Selection;
+        out.Nodes     = m_Nodes;
+        for (auto& node : out.Nodes)
+            node.Fields = kNodeFieldAll;
+
+        ++m_Stats.SnapshotsBuilt;
+        return out;
+    }
+
+    void SceneReplicator::Reset()
+    {
+        m_Nodes.clear();
+        m_Selection      = -1;
+        m_SelectionDirty = true;
+        m_CountDirty     = true;
+        m_Sequence       = 0;
+    }
+
+    // =========================================================================
+    // SceneMirror
+    // =========================================================================
+
+    bool SceneMirror::Apply(const NetMessage& msg)
+    {
+        if (msg.Type == NetMsgType::SceneSnapshot) {
+            m_Nodes.assign(msg.NodeCount, NetNode());
+            for (size_t i = 0; i < m_Nodes.size(); ++i)
+                m_Nodes[i].Index = static_cast<uint16_t>(i);
+            for (const auto& node : msg.Nodes)
+                if (node.Index < m_Nodes.size())
+                    MergeFields(m_Nodes[node.Index], node, node.Fields);
+            for (auto& node : m_Nodes)
+                node.Fields = kNodeFieldAll;
+
+            m_Selection = msg.NodeIndex;
+            m_Sequence  = msg.Sequence;
+            m_HasState  = true;
+            ++m_Stats.Snapshots;
+            return true;
+        }
+
+        if (msg.Type != NetMsgType::SceneDelta) return false;
+
+        // The host's first delta after a reset carries every field, so it
+        // can stand in for a snapshot
+        bool baseline = msg.Sequence == 1;
+        if ((!m_HasState && !baseline) ||
+            (m_HasState && msg.Sequence <= m_Sequence && !baseline)) {
+            ++m_Stats.Stale;
+            return false;
+        }
+        if (m_HasState && !baseline && msg.Sequence != m_Sequence + 1)
+            m_Stats.Gaps += msg.Sequence - m_Sequence - 1;
+
+        if (baseline) m_Nodes.clear();
+
+        size_t old = m_Nodes.size();
+        m_Nodes.resize(msg.NodeCount);
+        for (size_t i = old; i < m_Nodes.size(); ++i) {
+            m_Nodes[i].Index  = static_cast<uint16_t>(i);
+            m_Nodes[i].Fields = kNodeFieldAll;
+        }
+        for (const auto& node : msg.Nodes)
+            if (node.Index < m_Nodes.size())
+                MergeFields(m_Nodes[node.Index], node, node.Fields);
+
+        m_Selection = msg.NodeIndex;
+        m_Sequence  = msg.Sequence;
+        m_HasState  = true;
+        ++m_Stats.Deltas;
+        return true;
+    }
+
+    NetMessage SceneMirror::ToSnapshot() const
+    {
+        NetMessage out;
+        out.Type      = NetMsgType::SceneSnapshot;
+        out.Sequence  = m_Sequence;
+        out.NodeCount = static_cast<uint16_t>(m_Nodes.size());
+        out.NodeIndex = m_Selection;
+        out.Nodes     = m_Nodes;
+        return out;
+    }
+
+    void SceneMirror::Reset()
+    {
+        m_Nodes.clear();
+        m_Selection = -1;
+        m_Sequence  = 0;
+        m_HasState  = false;
+    }
+
+} // namespace Atometa
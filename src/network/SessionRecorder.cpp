@@ -0,0 +1,536 @@
+#include "Atometa/Network/SessionRecorder.h"
+#include "Atometa/Core/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace Atometa {
+
+    namespace {
+
+        constexpr size_t kFlushBytes = 64 * 1024;   // write out once this much is buffered
+        constexpr size_t kWakeBatch  = 256;         // pending messages that wake the writer
+        constexpr size_t kMaxVarint  = 10;
+
+        void PutVarint(std::string& out, uint64_t v)
+        {
+            while (v >= 0x80) {
+                out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<char>(v));
+        }
+
+        bool GetVarint(std::istream& in, uint64_t& v)
+        {
+            v = 0;
+            for (size_t i = 0; i < kMaxVarint; ++i) {
+                int c = in.get();
+                if (c == std::char_traits<char>::eof()) return false;
+                v |= static_cast<uint64_t>(c & 0x7F) << (7 * i);
+                if (!(c & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool GetVarint(WireReader& in, uint64_t& v)
+        {
+            v = 0;
+            for (size_t i = 0; i < kMaxVarint; ++i) {
+                uint8_t c = in.U8();
+                if (!in.Ok()) return false;
+                v |= static_cast<uint64_t>(c & 0x7F) << (7 * i);
+                if (!(c & 0x80)) return true;
+            }
+            return false;
+        }
+
+        uint64_t UnixMicros()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+    } // namespace
+
+    // =========================================================================
+    // SessionRecorder
+    // =========================================================================
+
+    SessionRecorder::SessionRecorder(RecorderSettings settings)
+        : m_Settings(settings)
+    {
+    }
+
+    SessionRecorder::~SessionRecorder()
+    {
+        Stop();
+    }
+
+    bool SessionRecorder::Start(const std::string& path)
+    {
+        Stop();
+
+        std::error_code ec;
+        if (fs::path(path).has_parent_path())
+            fs::create_directories(fs::path(path).parent_path(), ec);
+
+        m_File.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_File) {
+            ATOMETA_ERROR("SessionRecorder: cannot create ", path);
+            return false;
+        }
+
+        m_Path         = path;
+        m_Buffer.clear();
+        m_LastTimeUs   = 0;
+        m_LastKeyframe = 0;
+        m_HasCamera    = false;
+        m_Scene.Reset();
+        m_Keyframes.clear();
+        m_Written      = RecorderStats();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Pending.clear();
+            m_Stopping = false;
+            m_Dropped  = 0;
+            m_Stats    = RecorderStats();
+        }
+
+        WireWriter header(m_Buffer);
+        header.Bytes(kRecordingMagic, sizeof(kRecordingMagic));
+        header.U16(kRecordingVersion);
+        header.U16(0);
+        header.U64(UnixMicros());
+        m_Offset = m_Buffer.size();
+
+        m_Start     = std::chrono::steady_clock::now();
+        m_Recording = true;
+        m_Writer    = std::thread([this]() { WriterLoop(); });
+
+        ATOMETA_INFO("Recording session to ", path);
+        return true;
+    }
+
+    void SessionRecorder::Stop()
+    {
+        if (!m_Recording.exchange(false)) return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Wake.notify_one();
+        if (m_Writer.joinable()) m_Writer.join();
+
+        ATOMETA_INFO("Recording stopped: ", m_Written.Messages, " messages, ",
+                     m_Written.Keyframes, " keyframes, ", m_Written.Bytes, " bytes");
+    }
+
+    void SessionRecorder::Record(const NetMessage& msg)
+    {
+        auto elapsed = std::chrono::steady_clock::now() - m_Start;
+        Record(msg, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+
+    void SessionRecorder::Record(const NetMessage& msg, uint64_t timeUs)
+    {
+        if (!m_Recording.load()) return;
+
+        bool wake = false;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Stopping) return;
+            if (m_Pending.size() >= m_Settings.MaxPending) {
+                ++m_Dropped;
+                return;
+            }
+            m_Pending.push_back({ timeUs, msg });
+            wake = m_Pending.size() == kWakeBatch;
+        }
+        if (wake) m_Wake.notify_one();
+    }
+
+    double SessionRecorder::GetElapsed() const
+    {
+        if (!m_Recording.load()) return 0.0;
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_Start).count();
+    }
+
+    RecorderStats SessionRecorder::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        RecorderStats stats = m_Stats;
+        stats.Dropped = m_Dropped;
+        return stats;
+    }
+
+    void SessionRecorder::WriterLoop()
+    {
+        auto interval = std::chrono::duration<double>(m_Settings.FlushInterval);
+        std::vector<Pending> batch;
+
+        for (;;) {
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Wake.wait_for(lock, interval, [this]() {
+                    return m_Stopping || m_Pending.size() >= kWakeBatch;
+                });
+                batch.swap(m_Pending);
+                stopping = m_Stopping;
+            }
+
+            WriteBatch(batch);
+            batch.clear();
+            if (stopping) WriteIndex();
+            FlushBuffer();
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                m_Stats = m_Written;
+            }
+            if (stopping) break;
+        }
+
+        m_File.close();
+    }
+
+    void SessionRecorder::WriteBatch(std::vector<Pending>& batch)
+    {
+        auto keyframeUs = static_cast<uint64_t>(m_Settings.KeyframeInterval * 1e6);
+
+        for (auto& pending : batch) {
+            const NetMessage& msg = pending.Msg;
+            uint64_t time = std::max(pending.TimeUs, m_LastTimeUs);
+
+            if (msg.Type == NetMsgType::CameraSync) {
+                m_Camera    = msg;
+                m_HasCamera = true;
+            } else {
+                m_Scene.Apply(msg);
+            }
+
+            AppendRecord(kRecordMessage, time, msg.Serialize(WireFormat::Binary));
+            ++m_Written.Messages;
+
+            // Taken after the message, so a keyframe covers everything
+            // recorded up to its own time
+            if (time - m_LastKeyframe >= keyframeUs && (m_HasCamera || m_Scene.HasState())) {
+                AppendKeyframe(time);
+                m_LastKeyframe = time;
+            }
+        }
+    }
+
+    void SessionRecorder::AppendRecord(uint8_t kind, uint64_t timeUs, const std::string& payload)
+    {
+        size_t before = m_Buffer.size();
+        m_Buffer.push_back(static_cast<char>(kind));
+        PutVarint(m_Buffer, timeUs - m_LastTimeUs);
+        PutVarint(m_Buffer, payload.size());
+        m_Buffer += payload;
+
+        m_LastTimeUs = timeUs;
+        m_Offset    += m_Buffer.size() - before;
+
+        if (m_Buffer.size() >= kFlushBytes) FlushBuffer();
+    }
+
+    void SessionRecorder::AppendKeyframe(uint64_t timeUs)
+    {
+        std::string payload;
+        std::string frame;
+        uint64_t    count = (m_Scene.HasState() ? 1 : 0) + (m_HasCamera ? 1 : 0);
+        PutVarint(payload, count);
+
+        if (m_Scene.HasState()) {
+            frame = m_Scene.ToSnapshot().Serialize(WireFormat::Binary);
+            PutVarint(payload, frame.size());
+            payload += frame;
+        }
+        if (m_HasCamera) {
+            frame = m_Camera.Serialize(WireFormat::Binary);
+            PutVarint(payload, frame.size());
+            payload += frame;
+        }
+
+        m_Keyframes.push_back({ timeUs, m_Offset });
+        AppendRecord(kRecordKeyframe, timeUs, payload);
+        ++m_Written.Keyframes;
+    }
+
+    void SessionRecorder::FlushBuffer()
+    {
+        if (m_Buffer.empty()) return;
+
+        m_File.write(m_Buffer.data(), static_cast<std::streamsize>(m_Buffer.size()));
+        m_File.flush();
+        if (!m_File) {
+            ATOMETA_ERROR("SessionRecorder: write to ", m_Path, " failed");
+        }
+        m_Written.Bytes += m_Buffer.size();
+        m_Buffer.clear();
+    }
+
+    void SessionRecorder::WriteIndex()
+    {
+        std::string payload;
+        PutVarint(payload, m_LastTimeUs);
+        PutVarint(payload, m_Keyframes.size());
+        for (const auto& keyframe : m_Keyframes) {
+            PutVarint(payload, keyframe.TimeUs);
+            PutVarint(payload, keyframe.Offset);
+        }
+
+        uint64_t indexOffset = m_Offset;
+        AppendRecord(kRecordIndex, m_LastTimeUs, payload);
+
+        WireWriter trailer(m_Buffer);
+        trailer.U64(indexOffset);
+        trailer.Bytes(kRecordingIndexMagic, sizeof(kRecordingIndexMagic));
+        m_Offset += kRecordingTrailerSize;
+    }
+
+    // =========================================================================
+    // SessionPlayer
+    // =========================================================================
+
+    bool SessionPlayer::Open(const std::string& path)
+    {
+        Close();
+
+        m_File.open(path, std::ios::binary);
+        if (!m_File) {
+            ATOMETA_WARN("SessionPlayer: cannot open ", path);
+            return false;
+        }
+
+        m_File.seekg(0, std::ios::end);
+        auto fileSize = static_cast<uint64_t>(m_File.tellg());
+        m_File.seekg(0);
+
+        char header[kRecordingHeaderSize];
+        if (fileSize < kRecordingHeaderSize || !m_File.read(header, sizeof(header))) {
+            ATOMETA_WARN("SessionPlayer: ", path, " is not a recording");
+            Close();
+            return false;
+        }
+
+        WireReader reader(header, sizeof(header));
+        reader.Skip(sizeof(kRecordingMagic));
+        if (std::memcmp(header, kRecordingMagic, sizeof(kRecordingMagic)) != 0 ||
+            reader.U16() != kRecordingVersion) {
+            ATOMETA_WARN("SessionPlayer: ", path, " is not a recording");
+            Close();
+            return false;
+        }
+
+        if (!LoadIndex(fileSize)) {
+            ATOMETA_WARN("SessionPlayer: ", path, " has no index, scanning");
+            ScanIndex(fileSize);
+        }
+
+        SeekFile(kRecordingHeaderSize, 0, false);
+        return true;
+    }
+
+    void SessionPlayer::Close()
+    {
+        if (m_File.is_open()) m_File.close();
+        m_File.clear();
+        m_Keyframes.clear();
+        m_DurationUs = 0;
+        m_DataEnd    = 0;
+        m_Recovered  = false;
+        m_PositionUs = 0.0;
+        m_CursorUs   = 0;
+        m_Rebase     = false;
+        m_HasNext    = false;
+        m_AtEnd      = false;
+    }
+
+    void SessionPlayer::SetSpeed(double speed)
+    {
+        m_Speed = std::clamp(speed, kMinSpeed, kMaxSpeed);
+    }
+
+    size_t SessionPlayer::Seek(double seconds, const DeliverFn& deliver)
+    {
+        if (!IsOpen()) return 0;
+
+        double target = std::clamp(seconds * 1e6, 0.0, static_cast<double>(m_DurationUs));
+        auto   it     = std::upper_bound(m_Keyframes.begin(), m_Keyframes.end(),
+                                         static_cast<uint64_t>(target),
+            [](uint64_t time, const RecordingKeyframe& k) { return time < k.TimeUs; });
+
+        size_t delivered = 0;
+        if (it == m_Keyframes.begin()) {
+            SeekFile(kRecordingHeaderSize, 0, false);
+        } else {
+            const auto& keyframe = *(it - 1);
+            SeekFile(keyframe.Offset, keyframe.TimeUs, true);
+
+            Record record;
+            if (ReadRecord(record) && record.Kind == kRecordKeyframe) {
+                WireReader reader(record.Payload.data(), record.Payload.size());
+                uint64_t   count = 0;
+                GetVarint(reader, count);
+
+                NetMessage msg;
+                for (uint64_t i = 0; i < count; ++i) {
+                    uint64_t size = 0;
+                    if (!GetVarint(reader, size) || size > reader.Remaining()) break;
+
+                    std::string frame(reinterpret_cast<const char*>(reader.Current()),
+                                      static_cast<size_t>(size));
+                    reader.Skip(static_cast<size_t>(size));
+                    if (NetMessage::Deserialize(frame, msg)) {
+                        deliver(msg);
+                        ++delivered;
+                    }
+                }
+            }
+        }
+
+        m_PositionUs = target;
+        return delivered + PlayUntil(static_cast<uint64_t>(target), deliver);
+    }
+
+    size_t SessionPlayer::Advance(double dt, const DeliverFn& deliver)
+    {
+        if (!IsOpen() || m_Paused || m_AtEnd) return 0;
+
+        m_PositionUs = std::min(m_PositionUs + dt * m_Speed * 1e6,
+                                static_cast<double>(m_DurationUs));
+        return PlayUntil(static_cast<uint64_t>(m_PositionUs), deliver);
+    }
+
+    size_t SessionPlayer::PlayUntil(uint64_t timeUs, const DeliverFn& deliver)
+    {
+        size_t     delivered = 0;
+        NetMessage msg;
+
+        for (;;) {
+            if (!m_HasNext) {
+                if (!ReadRecord(m_Next)) {
+                    m_AtEnd = true;
+                    break;
+                }
+                m_HasNext = true;
+            }
+            if (m_Next.TimeUs > timeUs) break;
+
+            // Keyframes repeat state already delivered; only Seek() uses them
+            if (m_Next.Kind == kRecordMessage && NetMessage::Deserialize(m_Next.Payload, msg)) {
+                deliver(msg);
+                ++delivered;
+            }
+            m_HasNext = false;
+        }
+        return delivered;
+    }
+
+    bool SessionPlayer::ReadRecord(Record& out)
+    {
+        auto pos = m_File.tellg();
+        if (pos < 0 || static_cast<uint64_t>(pos) >= m_DataEnd) return false;
+
+        int      kind = m_File.get();
+        uint64_t delta = 0, size = 0;
+        if (kind == std::char_traits<char>::eof() ||
+            !GetVarint(m_File, delta) || !GetVarint(m_File, size))
+            return false;
+
+        // A length running past the data is a torn or corrupt record
+        auto start = static_cast<uint64_t>(m_File.tellg());
+        if (size > m_DataEnd - start) return false;
+
+        out.Kind = static_cast<uint8_t>(kind);
+        out.Payload.resize(static_cast<size_t>(size));
+        if (!m_File.read(out.Payload.data(), static_cast<std::streamsize>(size)))
+            return false;
+
+        out.TimeUs = m_Rebase ? m_CursorUs : m_CursorUs + delta;
+        m_CursorUs = out.TimeUs;
+        m_Rebase   = false;
+        return true;
+    }
+
+    bool SessionPlayer::LoadIndex(uint64_t fileSize)
+    {
+        if (fileSize < kRecordingHeaderSize + kRecordingTrailerSize) return false;
+
+        char trailer[kRecordingTrailerSize];
+        m_File.clear();
+        m_File.seekg(static_cast<std::streamoff>(fileSize - kRecordingTrailerSize));
+        if (!m_File.read(trailer, sizeof(trailer)) ||
+            std::memcmp(trailer + 8, kRecordingIndexMagic, sizeof(kRecordingIndexMagic)) != 0)
+            return false;
+
+        WireReader tail(trailer, sizeof(trailer));
+        uint64_t   indexOffset = tail.U64();
+        if (indexOffset < kRecordingHeaderSize || indexOffset >= fileSize - kRecordingTrailerSize)
+            return false;
+
+        m_DataEnd = fileSize - kRecordingTrailerSize;
+        SeekFile(indexOffset, 0, true);
+
+        Record record;
+        if (!ReadRecord(record) || record.Kind != kRecordIndex) return false;
+
+        WireReader reader(record.Payload.data(), record.Payload.size());
+        uint64_t   duration = 0, count = 0;
+        if (!GetVarint(reader, duration) || !GetVarint(reader, count) ||
+            count > reader.Remaining() / 2)
+            return false;
+
+        std::vector<RecordingKeyframe> keyframes(static_cast<size_t>(count));
+        for (auto& keyframe : keyframes)
+            if (!GetVarint(reader, keyframe.TimeUs) || !GetVarint(reader, keyframe.Offset) ||
+                keyframe.Offset >= indexOffset)
+                return false;
+
+        m_Keyframes  = std::move(keyframes);
+        m_DurationUs = duration;
+        m_DataEnd    = indexOffset;
+        return true;
+    }
+
+    void SessionPlayer::ScanIndex(uint64_t fileSize)
+    {
+        m_Keyframes.clear();
+        m_DataEnd   = fileSize;
+        m_Recovered = true;
+        SeekFile(kRecordingHeaderSize, 0, false);
+
+        Record   record;
+        uint64_t offset = kRecordingHeaderSize;
+        for (;;) {
+            if (!ReadRecord(record)) break;
+            if (record.Kind == kRecordIndex) break;
+            if (record.Kind == kRecordKeyframe)
+                m_Keyframes.push_back({ record.TimeUs, offset });
+
+            m_DurationUs = record.TimeUs;
+            offset       = static_cast<uint64_t>(m_File.tellg());
+        }
+
+        // Everything past the last whole record is dropped
+        m_DataEnd = offset;
+    }
+
+    void SessionPlayer::SeekFile(uint64_t offset, uint64_t timeUs, bool absolute)
+    {
+        m_File.clear();
+        m_File.seekg(static_cast<std::streamoff>(offset));
+        m_CursorUs = timeUs;
+        m_Rebase   = absolute;
+        m_HasNext  = false;
+        m_AtEnd    = false;
+    }
+
+} // namespace Atometa
@@ -0,0 +1,145 @@
+#include "Atometa/Network/StudentInbox.h"
+
+#include <algorithm>
+
+namespace Atometa {
+
+    // =========================================================================
+    // StudentInbox
+    // =========================================================================
+
+    StudentInbox::StudentInbox(const StudentRateLimit& limit)
+        : m_Limit(limit)
+    {
+    }
+
+    void StudentInbox::SetLimit(const StudentRateLimit& limit)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Limit = limit;
+    }
+
+    StudentRateLimit StudentInbox::GetLimit() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Limit;
+    }
+
+    bool StudentInbox::Admit(SourceId id, size_t bytes, uint64_t nowUs, uint32_t shares)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Source& source = m_Sources[id];
+        double  scale  = std::max<uint32_t>(shares, 1);
+
+        if (source.Bytes.Take(static_cast<double>(bytes), m_Limit.BytesPerSec * scale,
+                              m_Limit.ByteBurst * scale, nowUs))
+            return true;
+
+        ++source.Stats.Throttled;
+        ++m_Totals.Throttled;
+        return false;
+    }
+
+    StudentInbox::Result StudentInbox::Push(SourceId id, NetMessage&& msg,
+                                            uint64_t nowUs, uint32_t shares)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Source& source = m_Sources[id];
+        source.Shares  = std::max<uint32_t>(shares, 1);
+
+        if (!source.Messages.Take(1.0, m_Limit.MessagesPerSec * source.Shares,
+                                  static_cast<double>(m_Limit.MessageBurst) * source.Shares, nowUs)) {
+            ++source.Stats.Throttled;
+            ++m_Totals.Throttled;
+            return Result::Throttled;
+        }
+        if (source.Queue.size() >= static_cast<size_t>(m_Limit.MaxQueued) * source.Shares) {
+            ++source.Stats.Overflow;
+            ++m_Totals.Overflow;
+            return Result::Overflow;
+        }
+
+        if (source.Queue.empty())
+            m_Ready.push_back(id);
+        source.Queue.push_back(std::move(msg));
+        ++m_Queued;
+        return Result::Queued;
+    }
+
+    size_t StudentInbox::Drain(std::vector<NetMessage>& out, size_t max)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        size_t taken = 0;
+
+        while (taken < max && !m_Ready.empty()) {
+            SourceId id = m_Ready.front();
+            m_Ready.pop_front();
+
+            auto it = m_Sources.find(id);
+            if (it == m_Sources.end()) continue;
+            Source& source = it->second;
+
+            for (uint32_t i = 0; i < source.Shares && taken < max && !source.Queue.empty(); ++i) {
+                out.push_back(std::move(source.Queue.front()));
+                source.Queue.pop_front();
+                ++source.Stats.Delivered;
+                ++m_Totals.Delivered;
+                --m_Queued;
+                ++taken;
+            }
+
+            // Back of the line, or gone once a departed student is served
+            if (!source.Queue.empty())
+                m_Ready.push_back(id);
+            else if (source.Removed)
+                m_Sources.erase(it);
+        }
+        return taken;
+    }
+
+    void StudentInbox::Remove(SourceId id)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Sources.find(id);
+        if (it == m_Sources.end()) return;
+
+        if (it->second.Queue.empty())
+            m_Sources.erase(it);
+        else
+            it->second.Removed = true;
+    }
+
+    void StudentInbox::Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Sources.clear();
+        m_Ready.clear();
+        m_Queued = 0;
+    }
+
+    size_t StudentInbox::GetQueued() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Queued;
+    }
+
+    StudentInboxStats StudentInbox::GetStats(SourceId id) const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Sources.find(id);
+        if (it == m_Sources.end()) return {};
+
+        StudentInboxStats stats = it->second.Stats;
+        stats.Queued = static_cast<uint32_t>(it->second.Queue.size());
+        return stats;
+    }
+
+    StudentInboxStats StudentInbox::GetTotals() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        StudentInboxStats totals = m_Totals;
+        totals.Queued = static_cast<uint32_t>(m_Queued);
+        return totals;
+    }
+
+} // namespace Atometa
@@ -0,0 +1,133 @@
+#include "Atometa/Network/NetworkLayer.h"
+#include "Atometa/Core/Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// ── AtometaRelay ──────────────────────────────────────────────────────────
+// Headless fan-out server: no window, no GL context. The professor's app
+// publishes one upstream connection to /publish and the relay rebroadcasts
+// it to every student connected on /.
+//
+//   AtometaRelay [--port 8080] [--threads N] [--key SECRET] [--stats SECONDS]
+//                [--metrics-port PORT] [--compress on|off]
+// ─────────────────────────────────────────────────────────────────────────
+
+namespace {
+
+    std::atomic<bool> g_Quit = false;
+
+    void OnSignal(int) { g_Quit = true; }
+
+    struct RelayOptions {
+        uint16_t    Port          = 8080;
+        size_t      Threads       = std::thread::hardware_concurrency();
+        std::string Key;
+        int         StatsInterval = 5;  // seconds, 0 = silent
+        uint16_t    MetricsPort   = 0;  // Prometheus /metrics, 0 = off
+        bool        Compress      = true;
+    };
+
+    void PrintUsage()
+    {
+        std::cout << "Usage: AtometaRelay [--port 8080] [--threads N] "
+                     "[--key SECRET] [--stats SECONDS] [--metrics-port PORT]\n"
+                     "                    [--compress on|off]\n";
+    }
+
+    bool ParseArgs(int argc, char** argv, RelayOptions& opts)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg  = argv[i];
+            const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (!std::strcmp(arg, "--help") || !std::strcmp(arg, "-h"))
+                return false;
+            if (!next) {
+                std::cerr << "Missing value for " << arg << '\n';
+                return false;
+            }
+
+            if      (!std::strcmp(arg, "--port"))    opts.Port          = static_cast<uint16_t>(std::atoi(next));
+            else if (!std::strcmp(arg, "--threads")) opts.Threads       = static_cast<size_t>(std::atoi(next));
+            else if (!std::strcmp(arg, "--key"))     opts.Key           = next;
+            else if (!std::strcmp(arg, "--stats"))   opts.StatsInterval = std::atoi(next);
+            else if (!std::strcmp(arg, "--metrics-port"))
+                opts.MetricsPort = static_cast<uint16_t>(std::atoi(next));
+            else if (!std::strcmp(arg, "--compress"))
+                opts.Compress = std::strcmp(next, "off") != 0;
+            else {
+                std::cerr << "Unknown option " << arg << '\n';
+                return false;
+            }
+            ++i;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    RelayOptions opts;
+    if (!ParseArgs(argc, argv, opts)) {
+        PrintUsage();
+        return 1;
+    }
+
+    Atometa::Logger::Init();
+    std::signal(SIGINT,  OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    Atometa::NetworkLayer relay;
+    relay.SetRelayMode(true, opts.Key);
+    relay.SetIOThreadCount(opts.Threads);
+    relay.SetMetricsPort(opts.MetricsPort);
+    relay.SetCompression(opts.Compress);
+
+    if (!relay.StartHost(opts.Port)) {
+        std::cerr << "AtometaRelay: could not listen on port " << opts.Port << '\n';
+        return 1;
+    }
+
+    std::cout << "AtometaRelay listening on port " << opts.Port
+              << " with " << relay.GetIOThreadCount() << " io threads"
+              << (opts.Key.empty() ? "" : " (publish key required)") << std::endl;
+
+    using Clock = std::chrono::steady_clock;
+    auto lastReport = Clock::now();
+    auto last       = relay.GetStats();
+
+    while (!g_Quit.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (opts.StatsInterval <= 0) continue;
+
+        auto now     = Clock::now();
+        double secs  = std::chrono::duration<double>(now - lastReport).count();
+        if (secs < opts.StatsInterval) continue;
+
+        auto stats = relay.GetStats();
+        std::cout << "clients="       << stats.Clients
+                  << " relayed/s="    << (stats.MessagesRelayed - last.MessagesRelayed) / secs
+                  << " sent/s="       << (stats.MessagesSent    - last.MessagesSent)    / secs
+                  << " out_kB/s="     << (stats.BytesSent       - last.BytesSent) / 1024.0 / secs
+                  << " in_kB/s="      << (stats.BytesReceived   - last.BytesReceived) / 1024.0 / secs
+                  << " dropped="      << stats.DroppedClients
+                  << std::endl;
+
+        last       = stats;
+        lastReport = now;
+    }
+
+    relay.StopHost();
+    std::cout << "AtometaRelay stopped" << std::endl;
+
+    Atometa::Logger::Shutdown();
+    return 0;
+}
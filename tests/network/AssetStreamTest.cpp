@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/AssetStream.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+using namespace Atometa;
+namespace fs = std::filesystem;
+
+class AssetStreamTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        root = fs::temp_directory_path() / ("atometa_assets_" + std::to_string(stamp));
+        fs::create_directories(root);
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    std::string WriteFile(const std::string& name, size_t size) {
+        std::mt19937 rng(static_cast<unsigned>(size));
+        std::string data(size, '\0');
+        for (auto& c : data) c = static_cast<char>(rng());
+
+        auto path = (root / name).string();
+        std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+        return path;
+    }
+
+    static std::string ReadAll(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    }
+
+    fs::path root;
+};
+
+// ============================================================================
+// Hashing Tests
+// ============================================================================
+
+TEST_F(AssetStreamTest, ContentHashIsSha1Hex) {
+    EXPECT_EQ(ContentHash("abc", 3), "a9993e364706816aba3e25717850c26c9cd0d89d");
+    EXPECT_TRUE(IsContentHash(ContentHash("", 0)));
+    EXPECT_FALSE(IsContentHash("../../etc/passwd"));
+}
+
+// ============================================================================
+// Store Tests
+// ============================================================================
+
+TEST_F(AssetStreamTest, StoreSplitsFileIntoChunks) {
+    auto path = WriteFile("heart.glb", 10 * 1024 + 17);
+
+    AssetStore store(4096);
+    ASSERT_TRUE(store.AddFile(path, "Heart"));
+
+    const auto& asset = store.GetAssets().at(0);
+    EXPECT_EQ(asset.Name,     "Heart");
+    EXPECT_EQ(asset.FileName, "heart.glb");
+    EXPECT_EQ(asset.Size,     10u * 1024 + 17);
+    ASSERT_EQ(asset.Chunks.size(), 3u);
+
+    std::string whole = ReadAll(path);
+    EXPECT_EQ(asset.Hash, ContentHash(whole.data(), whole.size()));
+
+    std::string chunk;
+    ASSERT_TRUE(store.ReadChunk(asset.Chunks[2], chunk));
+    EXPECT_EQ(chunk, whole.substr(8192));
+}
+
+TEST_F(AssetStreamTest, ManifestRoundTrips) {
+    AssetStore store(4096);
+    ASSERT_TRUE(store.AddFile(WriteFile("lung.obj", 5000)));
+
+    NetMessage manifest = store.MakeManifest();
+    AssetInfo  parsed;
+    ASSERT_TRUE(AssetInfo::FromJson(manifest.Data["assets"][0], parsed));
+    EXPECT_EQ(parsed.Hash,   store.GetAssets()[0].Hash);
+    EXPECT_EQ(parsed.Chunks, store.GetAssets()[0].Chunks);
+}
+
+// ============================================================================
+// Cache Tests
+// ============================================================================
+
+TEST_F(AssetStreamTest, CacheRejectsMismatchedChunk) {
+    AssetCache cache((root / "cache").string());
+    std::string data = "chunk";
+
+    EXPECT_FALSE(cache.PutChunk(ContentHash("other", 5), data));
+    EXPECT_TRUE(cache.PutChunk(ContentHash(data.data(), data.size()), data));
+    EXPECT_TRUE(cache.HasChunk(ContentHash(data.data(), data.size())));
+}
+
+TEST_F(AssetStreamTest, CacheAssemblesVerifiedFile) {
+    auto path = WriteFile("brain.glb", 9000);
+    AssetStore store(4096);
+    ASSERT_TRUE(store.AddFile(path));
+    const auto& asset = store.GetAssets()[0];
+
+    AssetCache cache((root / "cache").string());
+    EXPECT_EQ(cache.MissingChunks(asset).size(), 3u);
+    EXPECT_EQ(cache.Assemble(asset), "");
+
+    std::string chunk;
+    for (const auto& hash : asset.Chunks) {
+        ASSERT_TRUE(store.ReadChunk(hash, chunk));
+        ASSERT_TRUE(cache.PutChunk(hash, chunk));
+    }
+    EXPECT_TRUE(cache.MissingChunks(asset).empty());
+
+    std::string local = cache.Assemble(asset);
+    ASSERT_FALSE(local.empty());
+    EXPECT_EQ(fs::path(local).filename(), "brain.glb");
+    EXPECT_EQ(ReadAll(local), ReadAll(path));
+}
+
+TEST_F(AssetStreamTest, HostileFileNameStaysInCache) {
+    AssetInfo asset;
+    json entry = {
+        { "file", "../../evil.glb" }, { "hash", ContentHash("x", 1) },
+        { "size", 1 }, { "chunkSize", 1 }, { "chunks", { ContentHash("x", 1) } },
+    };
+    ASSERT_TRUE(AssetInfo::FromJson(entry, asset));
+    EXPECT_EQ(asset.FileName, "evil.glb");
+
+    entry["chunks"] = { "../../../etc/passwd" };
+    EXPECT_FALSE(AssetInfo::FromJson(entry, asset));
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/CameraJitterBuffer.h"
+
+#include <cmath>
+
+using namespace Atometa;
+
+class CameraJitterBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Fixed 100 ms playout delay keeps the expected values simple
+        settings.MinDelay         = 0.1f;
+        settings.MaxDelay         = 0.1f;
+        settings.MaxExtrapolation = 0.1f;
+    }
+
+    void TearDown() override {
+    }
+
+    static NetCamera Cam(float yaw, float pitch = 0.f, float dist = 10.f) {
+        NetCamera c;
+        c.Yaw = yaw; c.Pitch = pitch; c.Distance = dist;
+        return c;
+    }
+
+    CameraJitterSettings settings;
+    NetCamera            out;
+};
+
+// ============================================================================
+// Interpolation Tests
+// ============================================================================
+
+TEST_F(CameraJitterBufferTest, EmptyBufferHasNothingToApply) {
+    CameraJitterBuffer buffer(settings);
+    EXPECT_FALSE(buffer.Sample(1.0, out));
+}
+
+TEST_F(CameraJitterBufferTest, InterpolatesBetweenSamples) {
+    CameraJitterBuffer buffer(settings);
+    buffer.Push(1, 0.0, 1.0, Cam(0.f, 0.f, 10.f));
+    buffer.Push(2, 0.1, 1.1, Cam(10.f, 20.f, 12.f));
+
+    // Playout point: 1.15 - 1.0 (offset) - 0.1 (delay) = host 0.05
+    ASSERT_TRUE(buffer.Sample(1.15, out));
+    EXPECT_NEAR(out.Yaw,       5.f, 1e-3f);
+    EXPECT_NEAR(out.Pitch,    10.f, 1e-3f);
+    EXPECT_NEAR(out.Distance, 11.f, 1e-3f);
+}
+
+TEST_F(CameraJitterBufferTest, BunchedArrivalsFollowHostClock) {
+    CameraJitterBuffer buffer(settings);
+
+    // Four 30 Hz samples arriving together; yaw = 100 * host time
+    for (uint32_t i = 0; i < 4; ++i) {
+        double host = i / 30.0;
+        buffer.Push(i + 1, host, 1.1, Cam(static_cast<float>(host * 100.0)));
+    }
+
+    // Offset settles on the fastest sample (transit 1.0)
+    ASSERT_TRUE(buffer.Sample(1.15, out));
+    EXPECT_NEAR(out.Yaw, 5.f, 1e-2f);
+    ASSERT_TRUE(buffer.Sample(1.17, out));
+    EXPECT_NEAR(out.Yaw, 7.f, 1e-2f);
+}
+
+TEST_F(CameraJitterBufferTest, YawTakesShortestArc) {
+    CameraJitterBuffer buffer(settings);
+    buffer.Push(1, 0.0, 1.0, Cam(350.f));
+    buffer.Push(2, 0.1, 1.1, Cam(10.f));
+
+    ASSERT_TRUE(buffer.Sample(1.15, out));
+    EXPECT_NEAR(std::fmod(out.Yaw, 360.f), 0.f, 1e-3f);
+}
+
+// ============================================================================
+// Loss Handling Tests
+// ============================================================================
+
+TEST_F(CameraJitterBufferTest, ExtrapolatesBrieflyThenHolds) {
+    CameraJitterBuffer buffer(settings);
+    buffer.Push(1, 0.0, 1.0, Cam(0.f));
+    buffer.Push(2, 0.1, 1.1, Cam(10.f));
+
+    // 50 ms past the newest sample: keep turning at 100°/s
+    ASSERT_TRUE(buffer.Sample(1.25, out));
+    EXPECT_NEAR(out.Yaw, 15.f, 1e-3f);
+    EXPECT_EQ(buffer.GetStats().Extrapolated, 1u);
+
+    // Past MaxExtrapolation: settle on the newest received pose
+    ASSERT_TRUE(buffer.Sample(1.5, out));
+    EXPECT_FLOAT_EQ(out.Yaw, 10.f);
+}
+
+TEST_F(CameraJitterBufferTest, HeldPoseIsAppliedOnce) {
+    CameraJitterBuffer buffer(settings);
+    buffer.Push(1, 0.0, 1.0, Cam(30.f));
+
+    EXPECT_TRUE(buffer.Sample(2.0, out));
+    EXPECT_FALSE(buffer.Sample(2.1, out));
+}
+
+TEST_F(CameraJitterBufferTest, CountsLostAndLateSamples) {
+    CameraJitterBuffer buffer(settings);
+    buffer.Push(1, 0.00, 1.00, Cam(0.f));
+    buffer.Push(3, 0.06, 1.06, Cam(6.f));
+    buffer.Push(2, 0.03, 1.07, Cam(3.f));
+
+    auto& stats = buffer.GetStats();
+    EXPECT_EQ(stats.Received, 2u);
+    EXPECT_EQ(stats.Lost,     1u);
+    EXPECT_EQ(stats.Late,     1u);
+}
+
+TEST_F(CameraJitterBufferTest, HostRestartResetsStream) {
+    CameraJitterBuffer buffer(settings);
+    buffer.Push(500, 50.0, 1.0, Cam(0.f));
+    buffer.Push(1,    0.0, 2.0, Cam(90.f));
+
+    EXPECT_EQ(buffer.GetStats().Late, 0u);
+    ASSERT_TRUE(buffer.Sample(3.0, out));
+    EXPECT_FLOAT_EQ(out.Yaw, 90.f);
+}
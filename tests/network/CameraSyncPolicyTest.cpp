@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/CameraSyncPolicy.h"
+
+using namespace Atometa;
+
+class CameraSyncPolicyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        settings.AngleStep        = 0.1f;
+        settings.DistanceStep     = 0.01f;
+        settings.Epsilon          = 0.05f;
+        settings.MaxRateHz        = 10.0f;
+        settings.KeyframeInterval = 1.0f;
+    }
+
+    void TearDown() override {
+    }
+
+    static NetCamera Cam(float yaw, float pitch = 0.f, float dist = 10.f) {
+        NetCamera c;
+        c.Yaw = yaw; c.Pitch = pitch; c.Distance = dist;
+        return c;
+    }
+
+    CameraSyncSettings settings;
+    NetCamera          out;
+};
+
+// ============================================================================
+// Change Detection Tests
+// ============================================================================
+
+TEST_F(CameraSyncPolicyTest, FirstFrameAlwaysSends) {
+    CameraSyncPolicy policy(settings);
+    EXPECT_TRUE(policy.Update(0.0, Cam(0.f), out));
+}
+
+TEST_F(CameraSyncPolicyTest, StaticCameraIsSuppressed) {
+    CameraSyncPolicy policy(settings);
+    policy.Update(0.0, Cam(5.f), out);
+
+    // 0.5 s of 75 FPS frames with no motion
+    for (int i = 1; i < 37; ++i)
+        EXPECT_FALSE(policy.Update(i / 75.0, Cam(5.f), out));
+
+    EXPECT_EQ(policy.GetStats().MessagesSent, 1u);
+    EXPECT_EQ(policy.GetStats().Suppressed, 36u);
+}
+
+TEST_F(CameraSyncPolicyTest, JitterBelowStepIsIgnored) {
+    CameraSyncPolicy policy(settings);
+    policy.Update(0.0, Cam(5.f), out);
+    EXPECT_FALSE(policy.Update(0.5, Cam(5.03f), out));
+}
+
+TEST_F(CameraSyncPolicyTest, MotionIsSentQuantized) {
+    CameraSyncPolicy policy(settings);
+    policy.Update(0.0, Cam(5.f), out);
+
+    ASSERT_TRUE(policy.Update(0.5, Cam(7.26f, 1.04f, 9.996f), out));
+    EXPECT_NEAR(out.Yaw,      7.3f, 1e-4f);
+    EXPECT_NEAR(out.Pitch,    1.0f, 1e-4f);
+    EXPECT_NEAR(out.Distance, 10.0f, 1e-4f);
+}
+
+// ============================================================================
+// Rate Limit And Keyframe Tests
+// ============================================================================
+
+TEST_F(CameraSyncPolicyTest, RateIsCapped) {
+    CameraSyncPolicy policy(settings);
+
+    // Camera moves every frame for one second at 100 FPS
+    int sent = 0;
+    for (int i = 0; i < 100; ++i)
+        if (policy.Update(i / 100.0, Cam(static_cast<float>(i)), out)) ++sent;
+
+    EXPECT_LE(sent, 11);
+    EXPECT_GE(sent, 9);
+}
+
+TEST_F(CameraSyncPolicyTest, PendingMotionSentWhenRateAllows) {
+    CameraSyncPolicy policy(settings);
+    policy.Update(0.00, Cam(0.f), out);
+    EXPECT_FALSE(policy.Update(0.05, Cam(10.f), out));
+
+    // Camera has stopped, but the last move still has to go out
+    ASSERT_TRUE(policy.Update(0.11, Cam(10.f), out));
+    EXPECT_FLOAT_EQ(out.Yaw, 10.f);
+}
+
+TEST_F(CameraSyncPolicyTest, KeyframeResendsIdleState) {
+    CameraSyncPolicy policy(settings);
+    policy.Update(0.0, Cam(3.f), out);
+
+    EXPECT_FALSE(policy.Update(0.9, Cam(3.f), out));
+    EXPECT_TRUE(policy.Update(1.0, Cam(3.f), out));
+    EXPECT_EQ(policy.GetStats().KeyframesSent, 1u);
+}
+
+TEST_F(CameraSyncPolicyTest, ResetForcesNextSend) {
+    CameraSyncPolicy policy(settings);
+    policy.Update(0.0, Cam(3.f), out);
+    policy.Reset();
+    EXPECT_TRUE(policy.Update(0.01, Cam(3.f), out));
+}
+
+// ============================================================================
+// Counter Tests
+// ============================================================================
+
+TEST_F(CameraSyncPolicyTest, BytesSavedUsesAverageMessageCost) {
+    CameraSyncPolicy policy(settings);
+    policy.Update(0.0, Cam(0.f), out);
+    policy.RecordSent(160);
+    policy.Update(0.01, Cam(0.f), out);
+    policy.Update(0.02, Cam(0.f), out);
+
+    EXPECT_EQ(policy.GetStats().BytesSent, 160u);
+    EXPECT_EQ(policy.GetStats().BytesSaved(), 320u);
+}
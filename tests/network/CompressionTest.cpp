@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/Compression.h"
+
+using namespace Atometa;
+
+class CompressionTest : public ::testing::Test {
+protected:
+    // A snapshot of a classroom scene; offset moves one model, the rest
+    // is as it was
+    static std::string Snapshot(uint32_t seq, float offset = 0.f) {
+        NetMessage msg;
+        msg.Type      = NetMsgType::SceneSnapshot;
+        msg.Sequence  = seq;
+        msg.NodeCount = 40;
+        for (uint16_t i = 0; i < msg.NodeCount; ++i) {
+            NetNode node;
+            node.Index    = i;
+            node.Fields   = kNodeFieldAll;
+            node.Position = { i * 0.37f, i == 3 ? offset : i * -1.91f, i * 0.05f };
+            node.Rotation = { 0.f, i * 9.f, 0.f };
+            node.Name     = "Thorax/Structure_" + std::to_string(i * 7919 % 1000);
+            msg.Nodes.push_back(node);
+        }
+        return msg.Serialize(WireFormat::Binary);
+    }
+
+    static bool RoundTrip(FrameDeflater& deflater, FrameInflater& inflater,
+                          const std::string& frame, size_t* wire = nullptr) {
+        std::string compressed;
+        if (!deflater.Compress(frame, compressed)) return false;
+        if (wire) *wire = compressed.size();
+
+        NetMessage msg;
+        std::string out;
+        return NetMessage::Deserialize(compressed, msg) && inflater.Expand(msg, out) &&
+               out == frame;
+    }
+};
+
+// ============================================================================
+// Stream Tests
+// ============================================================================
+
+TEST_F(CompressionTest, SnapshotShrinksAndRoundTrips) {
+    FrameDeflater deflater(1);
+    FrameInflater inflater;
+
+    std::string frame = Snapshot(7);
+    size_t      wire  = 0;
+    ASSERT_TRUE(RoundTrip(deflater, inflater, frame, &wire));
+    EXPECT_LT(wire * 2, frame.size());
+}
+
+TEST_F(CompressionTest, LaterFramesReuseTheWindow) {
+    FrameDeflater deflater(1);
+    FrameInflater inflater;
+
+    size_t first = 0, second = 0;
+    ASSERT_TRUE(RoundTrip(deflater, inflater, Snapshot(1), &first));
+    ASSERT_TRUE(RoundTrip(deflater, inflater, Snapshot(2, 0.5f), &second));
+
+    // Mostly a back-reference to the first snapshot
+    EXPECT_LT(second * 2, first);
+
+    // A fresh receiver has no window to resolve it against
+    FrameDeflater replay(1);
+    std::string   compressed;
+    ASSERT_TRUE(replay.Compress(Snapshot(1), compressed));
+    ASSERT_TRUE(replay.Compress(Snapshot(2, 0.5f), compressed));
+
+    NetMessage    msg;
+    FrameInflater late;
+    std::string   out;
+    ASSERT_TRUE(NetMessage::Deserialize(compressed, msg));
+    EXPECT_FALSE(late.Expand(msg, out) && out == Snapshot(2, 0.5f));
+}
+
+TEST_F(CompressionTest, IncompressibleChunkStillRoundTrips) {
+    NetMessage chunk;
+    chunk.Type      = NetMsgType::AssetChunk;
+    chunk.ChunkHash = "0123456789abcdef0123456789abcdef01234567";
+    chunk.Blob.resize(64 * 1024);
+    uint32_t state = 12345;
+    for (auto& c : chunk.Blob) {
+        state = state * 1664525u + 1013904223u;
+        c     = static_cast<char>(state >> 24);
+    }
+
+    FrameDeflater deflater(2);
+    FrameInflater inflater;
+    std::string   frame = chunk.Serialize(WireFormat::Binary);
+    size_t        wire  = 0;
+    ASSERT_TRUE(RoundTrip(deflater, inflater, frame, &wire));
+    EXPECT_LT(wire, frame.size() + frame.size() / 100);
+}
+
+TEST_F(CompressionTest, ResetStartsAFreshStream) {
+    FrameInflater inflater;
+    {
+        FrameDeflater deflater(1);
+        ASSERT_TRUE(RoundTrip(deflater, inflater, Snapshot(1)));
+    }
+
+    // Reconnected: the host starts over with a new deflater
+    inflater.Reset();
+    FrameDeflater deflater(1);
+    EXPECT_TRUE(RoundTrip(deflater, inflater, Snapshot(2)));
+}
+
+// ============================================================================
+// Validation Tests
+// ============================================================================
+
+TEST_F(CompressionTest, WrongSizeIsRejected) {
+    FrameDeflater deflater(1);
+    std::string   compressed;
+    ASSERT_TRUE(deflater.Compress(Snapshot(1), compressed));
+
+    NetMessage msg;
+    ASSERT_TRUE(NetMessage::Deserialize(compressed, msg));
+    EXPECT_EQ(msg.Type, NetMsgType::Compressed);
+    EXPECT_EQ(msg.Sequence, 1u);
+
+    std::string out;
+    NetMessage  shorter = msg;
+    shorter.InflatedSize -= 1;
+    EXPECT_FALSE(FrameInflater().Expand(shorter, out));
+
+    NetMessage longer = msg;
+    longer.InflatedSize += 1;
+    EXPECT_FALSE(FrameInflater().Expand(longer, out));
+
+    NetMessage huge = msg;
+    huge.InflatedSize = kMaxInflatedSize + 1;
+    EXPECT_FALSE(FrameInflater().Expand(huge, out));
+}
+
+TEST_F(CompressionTest, GarbageIsRejected) {
+    NetMessage msg;
+    msg.Type         = NetMsgType::Compressed;
+    msg.InflatedSize = 100;
+    msg.Blob         = std::string("\xff\xfe\xfd\xfc\xfb\xfa", 6);
+
+    std::string out;
+    EXPECT_FALSE(FrameInflater().Expand(msg, out));
+}
+
+TEST_F(CompressionTest, JsonRoundTrip) {
+    NetMessage msg;
+    msg.Type         = NetMsgType::Compressed;
+    msg.Sequence     = 2;
+    msg.InflatedSize = 300;
+    msg.Blob         = std::string("\x00\x01\xff", 3);
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(WireFormat::Json), out));
+    EXPECT_EQ(out.Type, NetMsgType::Compressed);
+    EXPECT_EQ(out.Sequence, 2u);
+    EXPECT_EQ(out.InflatedSize, 300u);
+    EXPECT_EQ(out.Blob, msg.Blob);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/InboundQueue.h"
+
+#include <thread>
+#include <vector>
+
+using namespace Atometa;
+
+class InboundQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+    }
+
+    void TearDown() override {
+    }
+
+    static NetMessage Camera(float yaw) {
+        NetMessage msg;
+        msg.Type       = NetMsgType::CameraSync;
+        msg.Camera.Yaw = yaw;
+        return msg;
+    }
+
+    static NetMessage Select(int32_t index) {
+        NetMessage msg;
+        msg.Type      = NetMsgType::NodeSelect;
+        msg.NodeIndex = index;
+        return msg;
+    }
+};
+
+// ============================================================================
+// Basic Queue Tests
+// ============================================================================
+
+TEST_F(InboundQueueTest, CapacityRoundsUpToPowerOfTwo) {
+    InboundQueue queue(100);
+    EXPECT_EQ(queue.Capacity(), 128u);
+}
+
+TEST_F(InboundQueueTest, PopsInPushOrder) {
+    InboundQueue queue(8);
+    for (int i = 0; i < 5; ++i)
+        EXPECT_TRUE(queue.Push(Select(i)));
+
+    NetMessage out;
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(queue.Pop(out));
+        EXPECT_EQ(out.NodeIndex, i);
+    }
+    EXPECT_FALSE(queue.Pop(out));
+}
+
+TEST_F(InboundQueueTest, FullQueueDropsAndCounts) {
+    InboundQueue queue(4);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_TRUE(queue.Push(Select(i)));
+    EXPECT_FALSE(queue.Push(Select(4)));
+
+    auto stats = queue.GetStats();
+    EXPECT_EQ(stats.Pushed,  4u);
+    EXPECT_EQ(stats.Dropped, 1u);
+
+    // Space is reusable once drained
+    NetMessage out;
+    ASSERT_TRUE(queue.Pop(out));
+    EXPECT_TRUE(queue.Push(Select(5)));
+}
+
+// ============================================================================
+// Drain Tests
+// ============================================================================
+
+TEST_F(InboundQueueTest, DrainCollapsesCameraToNewest) {
+    InboundQueue queue(16);
+    queue.Push(Camera(1.f));
+    queue.Push(Select(7));
+    queue.Push(Camera(2.f));
+    queue.Push(Camera(3.f));
+
+    std::vector<NetMessage> seen;
+    size_t n = queue.Drain([&](const NetMessage& msg) { seen.push_back(msg); });
+
+    ASSERT_EQ(n, 2u);
+    EXPECT_EQ(seen[0].Type, NetMsgType::NodeSelect);
+    EXPECT_EQ(seen[1].Type, NetMsgType::CameraSync);
+    EXPECT_FLOAT_EQ(seen[1].Camera.Yaw, 3.f);
+
+    auto stats = queue.GetStats();
+    EXPECT_EQ(stats.Collapsed, 2u);
+    EXPECT_EQ(stats.Delivered, 2u);
+    EXPECT_GE(stats.MaxLatencyUs, stats.LastLatencyUs);
+}
+
+TEST_F(InboundQueueTest, EmptyDrainDeliversNothing) {
+    InboundQueue queue(8);
+    int calls = 0;
+    EXPECT_EQ(queue.Drain([&](const NetMessage&) { ++calls; }), 0u);
+    EXPECT_EQ(calls, 0);
+}
+
+TEST_F(InboundQueueTest, ConcurrentProducersLoseNothing) {
+    constexpr int kProducers = 4;
+    constexpr int kPerThread = 5000;
+
+    InboundQueue queue(64);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < kPerThread; ++i)
+                while (!queue.Push(Select(p * kPerThread + i)))
+                    std::this_thread::yield();
+        });
+    }
+
+    std::vector<int> lastPerProducer(kProducers, -1);
+    int received = 0;
+    NetMessage out;
+    while (received < kProducers * kPerThread) {
+        if (!queue.Pop(out)) { std::this_thread::yield(); continue; }
+
+        // Each producer's messages arrive in its own order
+        int producer = out.NodeIndex / kPerThread;
+        EXPECT_GT(out.NodeIndex, lastPerProducer[producer]);
+        lastPerProducer[producer] = out.NodeIndex;
+        ++received;
+    }
+
+    for (auto& t : producers) t.join();
+    EXPECT_FALSE(queue.Pop(out));
+}
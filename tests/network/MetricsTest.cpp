@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/Metrics.h"
+
+#include <thread>
+#include <vector>
+
+using namespace Atometa;
+
+class MetricsTest : public ::testing::Test {
+protected:
+    static bool Contains(const std::string& text, const std::string& line) {
+        return text.find(line) != std::string::npos;
+    }
+};
+
+// ============================================================================
+// Histogram Tests
+// ============================================================================
+
+TEST_F(MetricsTest, ObservationsLandInTheirBucket) {
+    LatencyHistogram histogram;
+    histogram.Observe(0);
+    histogram.Observe(100);        // on a bound: le is inclusive
+    histogram.Observe(101);
+    histogram.Observe(16'000);
+    histogram.Observe(10'000'000); // past the last bound
+
+    auto snapshot = histogram.Read();
+    EXPECT_EQ(snapshot.Count, 5u);
+    EXPECT_EQ(snapshot.SumUs, 10'016'201u);
+    EXPECT_EQ(snapshot.Counts[0], 2u);
+    EXPECT_EQ(snapshot.Counts[1], 1u);
+    EXPECT_EQ(snapshot.Counts[7], 1u);
+    EXPECT_EQ(snapshot.Counts[LatencyHistogram::kBuckets - 1], 1u);
+}
+
+TEST_F(MetricsTest, ConcurrentWritersLoseNothing) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t)
+        writers.emplace_back([&histogram] {
+            for (int i = 0; i < 10'000; ++i)
+                histogram.Observe(static_cast<uint64_t>(i % 3000));
+        });
+    for (auto& writer : writers)
+        writer.join();
+
+    EXPECT_EQ(histogram.Read().Count, 40'000u);
+}
+
+// ============================================================================
+// Exposition Tests
+// ============================================================================
+
+TEST_F(MetricsTest, HistogramIsCumulativeInSeconds) {
+    LatencyHistogram histogram;
+    histogram.Observe(50);
+    histogram.Observe(200);
+    histogram.Observe(3'000'000);
+
+    MetricsText out;
+    out.Family("lat_seconds", "histogram", "Latency.");
+    out.Histogram("lat_seconds", histogram.Read(), "lane=\"bulk\"");
+    const std::string& text = out.Str();
+
+    EXPECT_TRUE(Contains(text, "# HELP lat_seconds Latency.\n# TYPE lat_seconds histogram\n"));
+    EXPECT_TRUE(Contains(text, "lat_seconds_bucket{lane=\"bulk\",le=\"0.0001\"} 1\n"));
+    EXPECT_TRUE(Contains(text, "lat_seconds_bucket{lane=\"bulk\",le=\"0.00025\"} 2\n"));
+    EXPECT_TRUE(Contains(text, "lat_seconds_bucket{lane=\"bulk\",le=\"2.5\"} 2\n"));
+    EXPECT_TRUE(Contains(text, "lat_seconds_bucket{lane=\"bulk\",le=\"+Inf\"} 3\n"));
+    EXPECT_TRUE(Contains(text, "lat_seconds_sum{lane=\"bulk\"} 3.00025\n"));
+    EXPECT_TRUE(Contains(text, "lat_seconds_count{lane=\"bulk\"} 3\n"));
+}
+
+TEST_F(MetricsTest, SamplesWithAndWithoutLabels) {
+    MetricsText out;
+    out.Sample("clients", uint64_t(12));
+    out.Sample("ratio", 0.25, "lane=\"realtime\"");
+
+    EXPECT_EQ(out.Str(), "clients 12\nratio{lane=\"realtime\"} 0.25\n");
+}
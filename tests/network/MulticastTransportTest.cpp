@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/MulticastTransport.h"
+
+using namespace Atometa;
+
+class MulticastTransportTest : public ::testing::Test {
+protected:
+    static NetMessage Camera(float yaw) {
+        NetMessage msg;
+        msg.Type       = NetMsgType::CameraSync;
+        msg.Camera.Yaw = yaw;
+        return msg;
+    }
+
+    static MulticastHeader Data(uint32_t sequence) {
+        MulticastHeader header;
+        header.Stream   = 7;
+        header.Sequence = sequence;
+        return header;
+    }
+
+    static MulticastHeader Beat(uint32_t sequence) {
+        MulticastHeader header = Data(sequence);
+        header.Flags = kMulticastFlagHeartbeat;
+        return header;
+    }
+};
+
+// ============================================================================
+// Datagram Tests
+// ============================================================================
+
+TEST_F(MulticastTransportTest, DatagramRoundTrip) {
+    MulticastSender sender(0xC0FFEE);
+
+    std::string datagram = sender.Encode(Camera(12.5f));
+    ASSERT_FALSE(datagram.empty());
+    EXPECT_EQ(static_cast<uint8_t>(datagram[0]), kMulticastMagic);
+
+    MulticastHeader header;
+    NetMessage      msg;
+    ASSERT_TRUE(DecodeMulticast(datagram.data(), datagram.size(), header, msg));
+    EXPECT_FALSE(header.IsHeartbeat());
+    EXPECT_EQ(header.Stream, 0xC0FFEEu);
+    EXPECT_EQ(header.Sequence, 1u);
+    EXPECT_EQ(msg.Type, NetMsgType::CameraSync);
+    EXPECT_FLOAT_EQ(msg.Camera.Yaw, 12.5f);
+
+    // A heartbeat repeats the last sequence and carries no message
+    std::string beat = sender.Heartbeat();
+    EXPECT_EQ(beat.size(), kMulticastHeaderSize);
+    ASSERT_TRUE(DecodeMulticast(beat.data(), beat.size(), header, msg));
+    EXPECT_TRUE(header.IsHeartbeat());
+    EXPECT_EQ(header.Sequence, 1u);
+}
+
+TEST_F(MulticastTransportTest, RejectsForeignAndTruncatedDatagrams) {
+    MulticastSender sender(1);
+    std::string datagram = sender.Encode(Camera(1.f));
+
+    MulticastHeader header;
+    NetMessage      msg;
+    EXPECT_FALSE(DecodeMulticast(datagram.data(), 6, header, msg));
+
+    datagram[0] = static_cast<char>(kWireMagic);
+    EXPECT_FALSE(DecodeMulticast(datagram.data(), datagram.size(), header, msg));
+}
+
+TEST_F(MulticastTransportTest, OversizeMessagesStayOnWebSocket) {
+    MulticastSender sender(1);
+
+    NetMessage big;
+    big.Type = NetMsgType::SessionInfo;
+    big.Data = { { "label", std::string(kMaxMulticastPayload, 'x') } };
+    EXPECT_TRUE(sender.Encode(big).empty());
+    EXPECT_EQ(sender.GetStats().Oversize, 1u);
+    EXPECT_EQ(sender.GetStats().Datagrams, 0u);
+}
+
+// ============================================================================
+// Repair Tests
+// ============================================================================
+
+TEST_F(MulticastTransportTest, RepairsOnlyTheNewestOfEachType) {
+    MulticastSender sender(1);
+
+    NetMessage select;
+    select.Type      = NetMsgType::NodeSelect;
+    select.NodeIndex = 3;
+
+    sender.Encode(Camera(1.f));   // 1
+    sender.Encode(select);        // 2
+    sender.Encode(Camera(2.f));   // 3
+
+    NetMessage out;
+    EXPECT_TRUE(sender.Repair(2, out));
+    EXPECT_EQ(out.Type, NetMsgType::NodeSelect);
+    EXPECT_EQ(out.NodeIndex, 3);
+
+    EXPECT_TRUE(sender.Repair(3, out));
+    EXPECT_FLOAT_EQ(out.Camera.Yaw, 2.f);
+
+    // Camera 1 was superseded by camera 3
+    EXPECT_FALSE(sender.Repair(1, out));
+    EXPECT_FALSE(sender.Repair(99, out));
+
+    auto stats = sender.GetStats();
+    EXPECT_EQ(stats.Repaired, 2u);
+    EXPECT_EQ(stats.Superseded, 1u);
+}
+
+TEST_F(MulticastTransportTest, ForgetsBeyondHistory) {
+    MulticastSender sender(1);
+
+    NetMessage select;
+    select.Type = NetMsgType::NodeSelect;
+    sender.Encode(select);
+    for (size_t i = 0; i < MulticastSender::kHistory; ++i)
+        sender.Encode(Camera(static_cast<float>(i)));
+
+    NetMessage out;
+    EXPECT_FALSE(sender.Repair(1, out));
+}
+
+// ============================================================================
+// Tracker Tests
+// ============================================================================
+
+TEST_F(MulticastTransportTest, TrackerNacksGapsOnce) {
+    MulticastTracker      tracker;
+    std::vector<uint32_t> nacks;
+
+    // Joined mid-stream: nothing before the first datagram is missing
+    EXPECT_TRUE(tracker.Accept(Data(10), nacks));
+    EXPECT_TRUE(nacks.empty());
+
+    EXPECT_TRUE(tracker.Accept(Data(13), nacks));
+    EXPECT_EQ(nacks, (std::vector<uint32_t>{ 11, 12 }));
+
+    // Late arrival is delivered, its duplicate is not
+    EXPECT_TRUE(tracker.Accept(Data(12), nacks));
+    EXPECT_FALSE(tracker.Accept(Data(12), nacks));
+    EXPECT_FALSE(tracker.Accept(Data(13), nacks));
+    EXPECT_EQ(nacks.size(), 2u);
+
+    auto stats = tracker.GetStats();
+    EXPECT_EQ(stats.Received, 3u);
+    EXPECT_EQ(stats.Lost, 2u);
+    EXPECT_EQ(stats.Late, 1u);
+    EXPECT_EQ(stats.Duplicates, 2u);
+}
+
+TEST_F(MulticastTransportTest, HeartbeatRevealsLostTail) {
+    MulticastTracker      tracker;
+    std::vector<uint32_t> nacks;
+
+    EXPECT_TRUE(tracker.Accept(Data(1), nacks));
+
+    // Datagrams 2 and 3 were lost and nothing followed but the heartbeat
+    EXPECT_FALSE(tracker.Accept(Beat(3), nacks));
+    EXPECT_EQ(nacks, (std::vector<uint32_t>{ 2, 3 }));
+
+    // A repeated heartbeat asks for nothing new
+    nacks.clear();
+    EXPECT_FALSE(tracker.Accept(Beat(3), nacks));
+    EXPECT_TRUE(nacks.empty());
+    EXPECT_EQ(tracker.GetStats().Heartbeats, 2u);
+}
+
+TEST_F(MulticastTransportTest, LongGapNacksOnlyTheNewest) {
+    MulticastTracker      tracker;
+    std::vector<uint32_t> nacks;
+
+    tracker.Accept(Data(1), nacks);
+    tracker.Accept(Data(1001), nacks);
+
+    ASSERT_EQ(nacks.size(), MulticastTracker::kMaxNack);
+    EXPECT_EQ(nacks.front(), 1001 - MulticastTracker::kMaxNack);
+    EXPECT_EQ(nacks.back(), 1000u);
+    EXPECT_EQ(tracker.GetHighest(), 1001u);
+}
@@ -0,0 +1,308 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/NetProtocol.h"
+
+using namespace Atometa;
+
+class NetProtocolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+    }
+
+    void TearDown() override {
+    }
+
+    static NetMessage MakeCamera(float yaw, float pitch, float dist) {
+        NetMessage msg;
+        msg.Type            = NetMsgType::CameraSync;
+        msg.Camera.Yaw      = yaw;
+        msg.Camera.Pitch    = pitch;
+        msg.Camera.Distance = dist;
+        return msg;
+    }
+};
+
+// ============================================================================
+// Binary Format Tests
+// ============================================================================
+
+TEST_F(NetProtocolTest, BinaryCameraSyncIsCompact) {
+    std::string raw = MakeCamera(12.5f, -30.0f, 7.25f).Serialize(WireFormat::Binary);
+
+    EXPECT_EQ(raw.size(), kWireHeaderSize + 12);
+    EXPECT_EQ(static_cast<uint8_t>(raw[0]), kWireMagic);
+    EXPECT_EQ(static_cast<uint8_t>(raw[1]), kWireVersion);
+}
+
+TEST_F(NetProtocolTest, BinaryCameraSyncRoundTrip) {
+    std::string raw = MakeCamera(12.5f, -30.0f, 7.25f).Serialize(WireFormat::Binary);
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(raw, out));
+    EXPECT_EQ(out.Type, NetMsgType::CameraSync);
+    EXPECT_FLOAT_EQ(out.Camera.Yaw,      12.5f);
+    EXPECT_FLOAT_EQ(out.Camera.Pitch,   -30.0f);
+    EXPECT_FLOAT_EQ(out.Camera.Distance,  7.25f);
+}
+
+TEST_F(NetProtocolTest, BinaryStampedCameraSyncRoundTrip) {
+    NetMessage msg = MakeCamera(1.f, 2.f, 3.f);
+    msg.Sequence   = 42;
+    msg.Timestamp  = 123456789ull;
+
+    std::string raw = msg.Serialize(WireFormat::Binary);
+    EXPECT_EQ(raw.size(), kWireHeaderSize + 24);
+    EXPECT_EQ(static_cast<uint8_t>(raw[3]), kWireFlagStamped);
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(raw, out));
+    EXPECT_FLOAT_EQ(out.Camera.Distance, 3.f);
+    EXPECT_EQ(out.Sequence,  42u);
+    EXPECT_EQ(out.Timestamp, 123456789ull);
+}
+
+TEST_F(NetProtocolTest, BinaryIsLittleEndian) {
+    NetMessage msg;
+    msg.Type      = NetMsgType::NodeSelect;
+    msg.NodeIndex = 0x01020304;
+
+    std::string raw = msg.Serialize(WireFormat::Binary);
+    ASSERT_EQ(raw.size(), kWireHeaderSize + 4);
+    EXPECT_EQ(raw[kWireHeaderSize + 0], 0x04);
+    EXPECT_EQ(raw[kWireHeaderSize + 3], 0x01);
+}
+
+TEST_F(NetProtocolTest, BinaryPingRoundTrip) {
+    NetMessage msg;
+    msg.Type      = NetMsgType::Pong;
+    msg.Timestamp = 0x0123456789ABCDEFull;
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(WireFormat::Binary), out));
+    EXPECT_EQ(out.Type, NetMsgType::Pong);
+    EXPECT_EQ(out.Timestamp, msg.Timestamp);
+}
+
+TEST_F(NetProtocolTest, ProbeFieldsRoundTripInBothFormats) {
+    NetMessage pong;
+    pong.Type          = NetMsgType::Pong;
+    pong.Timestamp     = 2000;
+    pong.EchoTimestamp = 1500;
+
+    NetMessage ping;
+    ping.Type      = NetMsgType::Ping;
+    ping.Timestamp = 3000;
+    ping.RoundTrip = 420;
+
+    for (auto format : { WireFormat::Json, WireFormat::Binary }) {
+        NetMessage out;
+        ASSERT_TRUE(NetMessage::Deserialize(pong.Serialize(format), out));
+        EXPECT_EQ(out.Timestamp,     2000u);
+        EXPECT_EQ(out.EchoTimestamp, 1500u);
+
+        ASSERT_TRUE(NetMessage::Deserialize(ping.Serialize(format), out));
+        EXPECT_EQ(out.Timestamp, 3000u);
+        EXPECT_EQ(out.RoundTrip, 420u);
+    }
+}
+
+TEST_F(NetProtocolTest, SceneDeltaRoundTripInBothFormats) {
+    NetMessage msg;
+    msg.Type      = NetMsgType::SceneDelta;
+    msg.Sequence  = 42;
+    msg.NodeCount = 3;
+    msg.NodeIndex = 2;
+
+    NetNode moved;
+    moved.Index    = 1;
+    moved.Fields   = kNodeFieldPosition | kNodeFieldVisible;
+    moved.Position = { 1.f, -2.f, 3.5f };
+    moved.Visible  = false;
+    NetNode renamed;
+    renamed.Index  = 2;
+    renamed.Fields = kNodeFieldName;
+    renamed.Name   = "Left lung";
+    msg.Nodes = { moved, renamed };
+
+    // Only the flagged fields go on the wire
+    EXPECT_EQ(msg.Serialize(WireFormat::Binary).size(),
+              kWireHeaderSize + 12 + (3 + 12 + 1) + (3 + 1 + 9));
+
+    for (auto format : { WireFormat::Json, WireFormat::Binary }) {
+        NetMessage out;
+        ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(format), out));
+        EXPECT_EQ(out.Type,      NetMsgType::SceneDelta);
+        EXPECT_EQ(out.Sequence,  42u);
+        EXPECT_EQ(out.NodeCount, 3u);
+        EXPECT_EQ(out.NodeIndex, 2);
+        ASSERT_EQ(out.Nodes.size(), 2u);
+        EXPECT_EQ(out.Nodes[0].Fields,   moved.Fields);
+        EXPECT_EQ(out.Nodes[0].Position, moved.Position);
+        EXPECT_FALSE(out.Nodes[0].Visible);
+        EXPECT_EQ(out.Nodes[1].Index, 2u);
+        EXPECT_EQ(out.Nodes[1].Name,  "Left lung");
+    }
+}
+
+TEST_F(NetProtocolTest, PointerRoundTripInBothFormats) {
+    NetMessage msg;
+    msg.Type      = NetMsgType::Pointer;
+    msg.Sequence  = 7;
+    msg.Timestamp = 5'000'000;
+    for (uint32_t i = 0; i < 10; ++i)
+        msg.Pointer.push_back({ i * 1000, { 0.1f * i, 1.f - 0.0333f * i, -2.f } });
+
+    // Absolute first sample, 8 bytes for each one after it
+    EXPECT_EQ(msg.Serialize(WireFormat::Binary).size(), kWireHeaderSize + 25 + 9 * 8);
+
+    for (auto format : { WireFormat::Json, WireFormat::Binary }) {
+        NetMessage out;
+        ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(format), out));
+        EXPECT_EQ(out.Type,      NetMsgType::Pointer);
+        EXPECT_EQ(out.Sequence,  7u);
+        EXPECT_EQ(out.Timestamp, 5'000'000u);
+        ASSERT_EQ(out.Pointer.size(), 10u);
+        for (size_t i = 0; i < 10; ++i) {
+            EXPECT_EQ(out.Pointer[i].OffsetUs, msg.Pointer[i].OffsetUs);
+            for (size_t axis = 0; axis < 3; ++axis)
+                EXPECT_NEAR(out.Pointer[i].Position[axis], msg.Pointer[i].Position[axis],
+                            kPointerStep / 2 + 1e-5f);
+        }
+    }
+
+    // Hidden: no samples at all
+    msg.Pointer.clear();
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(WireFormat::Binary), out));
+    EXPECT_TRUE(out.Pointer.empty());
+    EXPECT_EQ(out.Sequence, 7u);
+}
+
+TEST_F(NetProtocolTest, BinaryPointerRejectsMissingSamples) {
+    NetMessage msg;
+    msg.Type     = NetMsgType::Pointer;
+    msg.Sequence = 1;
+    msg.Pointer  = { { 0, { 1.f, 2.f, 3.f } }, { 100, { 1.f, 2.f, 3.f } } };
+
+    std::string raw = msg.Serialize(WireFormat::Binary);
+    raw.resize(raw.size() - 1);
+    NetMessage out;
+    EXPECT_FALSE(NetMessage::Deserialize(raw, out));
+}
+
+TEST_F(NetProtocolTest, BinaryChatKeepsJsonPayload) {
+    NetMessage msg;
+    msg.Type         = NetMsgType::ChatMessage;
+    msg.Data["text"] = "Look at the left ventricle";
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(WireFormat::Binary), out));
+    EXPECT_EQ(out.Type, NetMsgType::ChatMessage);
+    EXPECT_EQ(out.Data.value("text", ""), "Look at the left ventricle");
+}
+
+TEST_F(NetProtocolTest, BinaryRejectsTruncatedFrame) {
+    std::string raw = MakeCamera(1.f, 2.f, 3.f).Serialize(WireFormat::Binary);
+    raw.resize(raw.size() - 1);
+
+    NetMessage out;
+    EXPECT_FALSE(NetMessage::Deserialize(raw, out));
+}
+
+TEST_F(NetProtocolTest, BinaryRejectsUnknownVersion) {
+    std::string raw = MakeCamera(1.f, 2.f, 3.f).Serialize(WireFormat::Binary);
+    raw[1] = static_cast<char>(kWireVersion + 1);
+
+    NetMessage out;
+    EXPECT_FALSE(NetMessage::Deserialize(raw, out));
+}
+
+// ============================================================================
+// Json (Legacy) Format Tests
+// ============================================================================
+
+TEST_F(NetProtocolTest, JsonCameraSyncMatchesLegacyLayout) {
+    json root = json::parse(MakeCamera(1.f, 2.f, 3.f).Serialize(WireFormat::Json));
+
+    EXPECT_EQ(root["type"].get<int>(), 0);
+    EXPECT_FLOAT_EQ(root["data"]["yaw"].get<float>(),   1.f);
+    EXPECT_FLOAT_EQ(root["data"]["pitch"].get<float>(), 2.f);
+    EXPECT_FLOAT_EQ(root["data"]["dist"].get<float>(),  3.f);
+}
+
+TEST_F(NetProtocolTest, JsonParsesLegacyCameraSync) {
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(
+        R"({"type":0,"data":{"yaw":45.0,"pitch":10.0,"dist":5.0}})", out));
+
+    EXPECT_EQ(out.Type, NetMsgType::CameraSync);
+    EXPECT_FLOAT_EQ(out.Camera.Yaw,      45.f);
+    EXPECT_FLOAT_EQ(out.Camera.Pitch,    10.f);
+    EXPECT_FLOAT_EQ(out.Camera.Distance,  5.f);
+}
+
+TEST_F(NetProtocolTest, JsonStampedCameraSyncRoundTrip) {
+    NetMessage msg = MakeCamera(1.f, 2.f, 3.f);
+    msg.Sequence   = 7;
+    msg.Timestamp  = 5000;
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(WireFormat::Json), out));
+    EXPECT_EQ(out.Sequence,  7u);
+    EXPECT_EQ(out.Timestamp, 5000u);
+
+    // Unstamped frames from older hosts stay unstamped
+    ASSERT_TRUE(NetMessage::Deserialize(MakeCamera(1.f, 2.f, 3.f).Serialize(), out));
+    EXPECT_FALSE(out.IsStamped());
+}
+
+TEST_F(NetProtocolTest, MalformedInputRejected) {
+    NetMessage out;
+    EXPECT_FALSE(NetMessage::Deserialize("", out));
+    EXPECT_FALSE(NetMessage::Deserialize("{not json", out));
+    EXPECT_FALSE(NetMessage::Deserialize(R"({"type":99,"data":{}})", out));
+}
+
+// ============================================================================
+// Batch Tests
+// ============================================================================
+
+TEST_F(NetProtocolTest, BatchRoundTripInBothFormats) {
+    NetMessage chat;
+    chat.Type         = NetMsgType::ChatMessage;
+    chat.Data["text"] = "Now the aorta";
+
+    for (auto format : { WireFormat::Binary, WireFormat::Json }) {
+        std::vector<std::string> frames = {
+            MakeCamera(1.f, 2.f, 3.f).Serialize(format),
+            chat.Serialize(format),
+            MakeCamera(4.f, 5.f, 6.f).Serialize(format),
+        };
+
+        NetMessage batch;
+        ASSERT_TRUE(NetMessage::Deserialize(EncodeBatch(format, frames), batch));
+        EXPECT_EQ(batch.Type, NetMsgType::Batch);
+
+        std::vector<NetMessage> out;
+        ASSERT_TRUE(UnpackBatch(batch, out));
+        ASSERT_EQ(out.size(), 3u);
+        EXPECT_FLOAT_EQ(out[0].Camera.Yaw, 1.f);
+        EXPECT_EQ(out[1].Data.value("text", ""), "Now the aorta");
+        EXPECT_FLOAT_EQ(out[2].Camera.Distance, 6.f);
+    }
+}
+
+TEST_F(NetProtocolTest, BatchRejectsTruncatedAndNestedFrames) {
+    std::vector<std::string> frames = { MakeCamera(1.f, 2.f, 3.f).Serialize(WireFormat::Binary) };
+    std::string raw = EncodeBatch(WireFormat::Binary, frames);
+
+    NetMessage              batch;
+    std::vector<NetMessage> out;
+    raw.resize(raw.size() - 1);
+    ASSERT_TRUE(NetMessage::Deserialize(raw, batch));
+    EXPECT_FALSE(UnpackBatch(batch, out));
+
+    frames = { EncodeBatch(WireFormat::Binary, frames) };
+    out.clear();
+    ASSERT_TRUE(NetMessage::Deserialize(EncodeBatch(WireFormat::Binary, frames), batch));
+    EXPECT_FALSE(UnpackBatch(batch, out));
+}
@@ -0,0 +1,1175 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/NetworkLayer.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/beast/http.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <thread>
+
+using namespace Atometa;
+
+// ============================================================================
+// Allocation counting — only allocations made on a thread that opted in
+// are counted, so io threads and gtest internals don't pollute the numbers
+// ============================================================================
+
+namespace {
+    thread_local bool     t_CountAllocs = false;
+    thread_local uint64_t t_AllocCount  = 0;
+
+    struct AllocScope {
+        AllocScope()  { t_AllocCount = 0; t_CountAllocs = true; }
+        ~AllocScope() { t_CountAllocs = false; }
+        uint64_t Count() const { return t_AllocCount; }
+    };
+}
+
+void* operator new(std::size_t size)
+{
+    if (t_CountAllocs) ++t_AllocCount;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// ============================================================================
+// DropProxy — loopback TCP forwarder whose connections can be cut, to
+// stand in for a student's Wi-Fi dropping out
+// ============================================================================
+
+class DropProxy {
+public:
+    DropProxy(uint16_t listenPort, uint16_t hostPort)
+        : m_Acceptor(m_IO, tcp::endpoint(asio::ip::make_address("127.0.0.1"), listenPort))
+        , m_HostPort(hostPort)
+    {
+        Accept();
+        m_Thread = std::thread([this] { m_IO.run(); });
+    }
+
+    ~DropProxy()
+    {
+        m_IO.stop();
+        m_Thread.join();
+    }
+
+    void Drop()
+    {
+        asio::post(m_IO, [this] {
+            for (auto& socket : m_Sockets) {
+                boost::system::error_code ec;
+                socket->close(ec);
+            }
+            m_Sockets.clear();
+        });
+    }
+
+private:
+    using SocketPtr = std::shared_ptr<tcp::socket>;
+
+    void Accept()
+    {
+        m_Acceptor.async_accept([this](boost::system::error_code ec, tcp::socket client) {
+            if (ec) return;
+            auto down = std::make_shared<tcp::socket>(std::move(client));
+            auto up   = std::make_shared<tcp::socket>(m_IO);
+            up->connect(tcp::endpoint(asio::ip::make_address("127.0.0.1"), m_HostPort), ec);
+            if (!ec) {
+                m_Sockets.push_back(down);
+                m_Sockets.push_back(up);
+                Pump(down, up);
+                Pump(up, down);
+            }
+            Accept();
+        });
+    }
+
+    static void Pump(SocketPtr from, SocketPtr to)
+    {
+        auto buffer = std::make_shared<std::array<char, 16384>>();
+        from->async_read_some(asio::buffer(*buffer),
+            [from, to, buffer](boost::system::error_code ec, size_t bytes) {
+                if (ec) {
+                    to->close(ec);
+                    return;
+                }
+                asio::async_write(*to, asio::buffer(buffer->data(), bytes),
+                    [from, to, buffer](boost::system::error_code ec, size_t) {
+                        if (!ec) Pump(from, to);
+                    });
+            });
+    }
+
+    asio::io_context       m_IO;
+    tcp::acceptor          m_Acceptor;
+    uint16_t               m_HostPort;
+    std::vector<SocketPtr> m_Sockets;
+    std::thread            m_Thread;
+};
+
+class NetworkLayerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+    }
+
+    void TearDown() override {
+    }
+
+    // Polls cond for up to timeoutMs; loopback round trips take well under that
+    template<typename Cond>
+    static bool WaitFor(Cond cond, int timeoutMs = 2000) {
+        auto deadline = std::chrono::steady_clock::now()
+                      + std::chrono::milliseconds(timeoutMs);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (cond()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return cond();
+    }
+
+    static constexpr uint16_t kPort = 18431;
+};
+
+// ============================================================================
+// Loopback Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, ClientNegotiatesBinaryAndReceivesCamera) {
+    // Host is destroyed first so its sockets close and unblock the client
+    NetworkLayer client;
+    NetworkLayer host;
+
+    std::atomic<bool>  received = false;
+    std::atomic<float> yaw      = 0.f;
+    client.SetOnMessage([&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::CameraSync) {
+            yaw      = msg.Camera.Yaw;
+            received = true;
+        }
+    });
+
+    ASSERT_TRUE(host.StartHost(kPort));
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort));
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 1; }));
+    EXPECT_EQ(client.GetWireFormat(), WireFormat::Binary);
+
+    NetMessage msg;
+    msg.Type       = NetMsgType::CameraSync;
+    msg.Camera.Yaw = 42.f;
+    host.Send(msg);
+
+    ASSERT_TRUE(WaitFor([&] { return received.load(); }));
+    EXPECT_FLOAT_EQ(yaw.load(), 42.f);
+}
+
+TEST_F(NetworkLayerTest, BroadcastAllocationsIndependentOfClassSize) {
+    std::vector<std::unique_ptr<NetworkLayer>> clients;
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 1));
+
+    NetMessage msg;
+    msg.Type = NetMsgType::CameraSync;
+
+    auto allocsPerSend = [&]() {
+        AllocScope scope;
+        host.Send(msg);
+        return scope.Count();
+    };
+
+    auto addClients = [&](size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            clients.push_back(std::make_unique<NetworkLayer>());
+            clients.back()->Connect("127.0.0.1", kPort + 1);
+        }
+        return WaitFor([&] { return host.GetClientCount() == clients.size(); });
+    };
+
+    ASSERT_TRUE(addClients(1));
+    uint64_t one = allocsPerSend();
+
+    ASSERT_TRUE(addClients(15));
+    uint64_t sixteen = allocsPerSend();
+
+    EXPECT_EQ(one, sixteen);
+    EXPECT_LE(sixteen, 4u);
+
+    host.StopHost();
+}
+
+TEST_F(NetworkLayerTest, StalledStudentIsCoalescedThenDropped) {
+    NetworkLayer host;
+    host.SetMaxQueueDepth(8);
+    ASSERT_TRUE(host.StartHost(kPort + 2));
+
+    // A student that completes the handshake and then never reads
+    asio::io_context ioc;
+    beast::websocket::stream<tcp::socket> stalled(ioc);
+    asio::connect(stalled.next_layer(),
+                  tcp::resolver(ioc).resolve("127.0.0.1", std::to_string(kPort + 2)));
+    stalled.handshake("127.0.0.1", "/");
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 1; }));
+
+    NetMessage camera;
+    camera.Type = NetMsgType::CameraSync;
+
+    NetMessage bulk;
+    bulk.Type         = NetMsgType::ChatMessage;
+    bulk.Data["text"] = std::string(1 << 20, 'x');
+
+    // Fill the socket buffers, then keep offering camera frames: they must
+    // collapse into one queue slot until bulk traffic overflows the queue
+    uint64_t coalesced = 0;
+    for (int i = 0; i < 64 && host.GetDroppedClientCount() == 0; ++i) {
+        host.Send(bulk);
+        for (int j = 0; j < 10; ++j)
+            host.Send(camera);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        for (const auto& s : host.GetSessionStats())
+            coalesced = std::max(coalesced, s.Coalesced);
+    }
+
+    EXPECT_GT(coalesced, 0u);
+    ASSERT_TRUE(WaitFor([&] { return host.GetDroppedClientCount() == 1; }));
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 0; }));
+
+    host.StopHost();
+}
+
+TEST_F(NetworkLayerTest, SessionStatsTrackSentFrames) {
+    NetworkLayer client;
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 3));
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 3));
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 1; }));
+
+    NetMessage msg;
+    msg.Type = NetMsgType::NodeSelect;
+    for (int i = 0; i < 5; ++i)
+        host.Send(msg);
+
+    ASSERT_TRUE(WaitFor([&] {
+        auto stats = host.GetSessionStats();
+        return stats.size() == 1 && stats[0].MessagesSent == 1 + 5;   // SessionInfo on join
+    }));
+    auto stats = host.GetSessionStats();
+    EXPECT_EQ(stats[0].QueueDepth, 0u);
+    EXPECT_GE(stats[0].MaxQueueDepth, 1u);
+    EXPECT_GT(stats[0].BytesSent, 0u);
+}
+
+TEST_F(NetworkLayerTest, IOPoolDeliversToEveryStudent) {
+    constexpr int kStudents = 8;
+
+    std::vector<std::unique_ptr<NetworkLayer>> clients;
+    std::atomic<int> received = 0;
+
+    NetworkLayer host;
+    host.SetIOThreadCount(4);
+    ASSERT_TRUE(host.StartHost(kPort + 4));
+    EXPECT_EQ(host.GetIOThreadCount(), 4u);
+
+    for (int i = 0; i < kStudents; ++i) {
+        clients.push_back(std::make_unique<NetworkLayer>());
+        clients.back()->SetOnMessage([&](const NetMessage& msg) {
+            if (msg.Type == NetMsgType::NodeSelect) ++received;
+        });
+        clients.back()->Connect("127.0.0.1", kPort + 4);
+    }
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == kStudents; }));
+
+    NetMessage msg;
+    msg.Type = NetMsgType::NodeSelect;
+    for (int i = 0; i < 10; ++i)
+        host.Send(msg);
+
+    ASSERT_TRUE(WaitFor([&] { return received.load() == kStudents * 10; }));
+    host.StopHost();
+}
+
+TEST_F(NetworkLayerTest, HostCanRestartAfterStop) {
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 5));
+    host.StopHost();
+    ASSERT_TRUE(host.StartHost(kPort + 5));
+
+    NetworkLayer client;
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 5));
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 1; }));
+    host.StopHost();
+}
+
+// ============================================================================
+// Round-trip Probe Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, PingMeasuresRoundTripOnBothEnds) {
+    NetworkLayer client;
+    NetworkLayer host;
+    host.SetPingInterval(20);
+    ASSERT_TRUE(host.StartHost(kPort + 6));
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 6));
+
+    ASSERT_TRUE(WaitFor([&] {
+        auto stats = host.GetSessionStats();
+        return stats.size() == 1 && stats[0].RoundTrip.Samples >= 3;
+    }));
+    auto rtt = host.GetSessionStats()[0].RoundTrip;
+    EXPECT_GT(rtt.AvgMs, 0.f);
+    EXPECT_LE(rtt.MinMs, rtt.AvgMs);
+    EXPECT_LE(rtt.AvgMs, rtt.P99Ms);
+
+    // Same machine, same clock: the offset is bounded by the RTT
+    EXPECT_LE(std::abs(rtt.ClockOffsetMs), rtt.P99Ms);
+
+    ASSERT_TRUE(WaitFor([&] { return client.GetRoundTrip().Samples >= 1; }));
+    auto seen = client.GetRoundTrip();
+    EXPECT_GT(seen.AvgMs, 0.f);
+    EXPECT_LE(std::abs(seen.ClockOffsetMs), seen.P99Ms);
+}
+
+// ============================================================================
+// Asset Streaming Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, StudentDownloadsSceneAssetsOnceIntoCache) {
+    namespace fs = std::filesystem;
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    fs::path dir = fs::temp_directory_path() / ("atometa_stream_" + std::to_string(stamp));
+    fs::create_directories(dir);
+
+    std::string model((300 << 10) + 123, '\0');
+    for (size_t i = 0; i < model.size(); ++i) model[i] = static_cast<char>(i * 31 + 7);
+    std::ofstream((dir / "heart.glb").string(), std::ios::binary).write(model.data(), model.size());
+
+    auto store = std::make_shared<AssetStore>();
+    ASSERT_TRUE(store->AddFile((dir / "heart.glb").string(), "Heart"));
+
+    auto join = [&](NetworkLayer& client, std::atomic<bool>& ready, std::string& path) {
+        client.SetAssetCacheDir((dir / "cache").string());
+        client.SetOnMessage([&](const NetMessage& msg) {
+            if (msg.Type != NetMsgType::AssetManifest) return;
+            path  = msg.Data["assets"][0]["localPath"].get<std::string>();
+            ready = true;
+        });
+        client.Connect("127.0.0.1", kPort + 7);
+    };
+
+    NetworkLayer      first, second;
+    std::atomic<bool> firstReady = false, secondReady = false;
+    std::string       firstPath, secondPath;
+
+    NetworkLayer host;
+    host.SetAssetStore(store);
+    ASSERT_TRUE(host.StartHost(kPort + 7));
+
+    join(first, firstReady, firstPath);
+    ASSERT_TRUE(WaitFor([&] { return firstReady.load(); }, 5000));
+    EXPECT_EQ(first.GetAssetProgress().ChunksReceived, store->GetChunkCount());
+
+    std::ifstream in(firstPath, std::ios::binary);
+    std::string received{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    EXPECT_EQ(received, model);
+
+    // Same cache: the second student needs nothing from the host
+    join(second, secondReady, secondPath);
+    ASSERT_TRUE(WaitFor([&] { return secondReady.load(); }, 5000));
+    EXPECT_EQ(secondPath, firstPath);
+    EXPECT_EQ(second.GetAssetProgress().ChunksTotal, 0u);
+
+    uint64_t chunksSent = 0;
+    for (const auto& s : host.GetSessionStats()) chunksSent += s.AssetChunksSent;
+    EXPECT_EQ(chunksSent, store->GetChunkCount());
+
+    host.StopHost();
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+// ============================================================================
+// Scene Replication Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, LateJoinerGetsSnapshotThenDeltas) {
+    NetworkLayer client;
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 8));
+
+    SceneReplicator replicator;
+    NetMessage      delta;
+    NetNode         heart;
+    heart.Name     = "Heart";
+    heart.Position = { 1.f, 2.f, 3.f };
+    replicator.SetNodeCount(1);
+    replicator.SetNode(0, heart);
+    ASSERT_TRUE(replicator.BuildDelta(delta));
+    host.Send(delta);
+
+    std::mutex  mutex;
+    SceneMirror mirror;
+    client.SetOnMessage([&](const NetMessage& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        mirror.Apply(msg);
+    });
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 8));
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return mirror.HasState();
+    }));
+
+    heart.Visible = false;
+    replicator.SetNode(0, heart);
+    ASSERT_TRUE(replicator.BuildDelta(delta));
+    host.Send(delta);
+
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return mirror.GetSequence() == 2;
+    }));
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(mirror.GetStats().Snapshots, 1u);
+    EXPECT_EQ(mirror.GetNodes()[0].Name, "Heart");
+    EXPECT_EQ(mirror.GetNodes()[0].Position, heart.Position);
+    EXPECT_FALSE(mirror.GetNodes()[0].Visible);
+}
+
+TEST_F(NetworkLayerTest, JoinBurstCarriesCurrentCameraAndScene) {
+    constexpr int kStudents = 16;
+
+    std::vector<std::unique_ptr<NetworkLayer>> clients;
+    std::vector<std::vector<NetMsgType>>       firstFrames(kStudents);
+    std::mutex                                 mutex;
+
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 9));
+
+    // State set before anyone is connected
+    NetMessage camera;
+    camera.Type       = NetMsgType::CameraSync;
+    camera.Camera.Yaw = 42.f;
+    host.Send(camera);
+
+    SceneReplicator replicator;
+    NetMessage      delta;
+    replicator.SetNodeCount(2);
+    ASSERT_TRUE(replicator.BuildDelta(delta));
+    host.Send(delta);
+
+    for (int i = 0; i < kStudents; ++i) {
+        clients.push_back(std::make_unique<NetworkLayer>());
+        clients.back()->SetOnMessage([&, i](const NetMessage& msg) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (firstFrames[i].size() < 3) firstFrames[i].push_back(msg.Type);
+        });
+        clients.back()->Connect("127.0.0.1", kPort + 9);
+    }
+
+    ASSERT_TRUE(WaitFor([&] {
+        for (auto& client : clients)
+            if (client->GetJoinLatencyMs() <= 0.f) return false;
+        return true;
+    }, 5000));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& frames : firstFrames)
+        EXPECT_EQ(frames, (std::vector<NetMsgType>{ NetMsgType::SessionInfo,
+                                                    NetMsgType::SceneSnapshot,
+                                                    NetMsgType::CameraSync }));
+    EXPECT_EQ(host.GetStats().JoinSnapshots, static_cast<uint64_t>(kStudents));
+    host.StopHost();
+}
+
+// ============================================================================
+// Reconnect Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, DroppedStudentResumesFromMissedDeltas) {
+    NetworkLayer client;
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 10));
+    DropProxy wifi(kPort + 11, kPort + 10);
+
+    SceneReplicator replicator;
+    NetMessage      delta;
+    NetNode         heart;
+    heart.Name = "Heart";
+    replicator.SetNodeCount(1);
+    replicator.SetNode(0, heart);
+    ASSERT_TRUE(replicator.BuildDelta(delta));
+    host.Send(delta);
+
+    std::mutex  mutex;
+    SceneMirror mirror;
+    client.SetOnMessage([&](const NetMessage& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        mirror.Apply(msg);
+    });
+    client.SetReconnectBackoff(20, 100);
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 11));
+    ASSERT_TRUE(WaitFor([&] { return client.GetJoinLatencyMs() > 0.f; }));
+
+    // Changes made while the student is away
+    wifi.Drop();
+    for (int i = 1; i <= 3; ++i) {
+        heart.Position = { static_cast<float>(i), 0.f, 0.f };
+        replicator.SetNode(0, heart);
+        ASSERT_TRUE(replicator.BuildDelta(delta));
+        host.Send(delta);
+    }
+
+    ASSERT_TRUE(WaitFor([&] { return client.GetReconnectStats().Resumed == 1; }));
+    auto stats = client.GetReconnectStats();
+    EXPECT_EQ(stats.Drops,       1u);
+    EXPECT_EQ(stats.FullResyncs, 0u);
+    EXPECT_GT(stats.LastMs,      0.f);
+    EXPECT_EQ(host.GetStats().ResumedJoins, 1u);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(mirror.GetSequence(), 4u);
+    EXPECT_EQ(mirror.GetStats().Snapshots, 1u);   // the first join only
+    EXPECT_EQ(mirror.GetStats().Gaps,      0u);
+    EXPECT_FLOAT_EQ(mirror.GetNodes()[0].Position[0], 3.f);
+}
+
+TEST_F(NetworkLayerTest, RestartedHostGetsFullResync) {
+    NetworkLayer client;
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 12));
+
+    SceneReplicator replicator;
+    NetMessage      delta;
+    replicator.SetNodeCount(1);
+    ASSERT_TRUE(replicator.BuildDelta(delta));
+    host.Send(delta);
+
+    client.SetReconnectBackoff(20, 100);
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 12));
+    ASSERT_TRUE(WaitFor([&] { return client.GetJoinLatencyMs() > 0.f; }));
+
+    // The old token names a stream that no longer exists
+    host.StopHost();
+    ASSERT_TRUE(host.StartHost(kPort + 12));
+    replicator.Reset();
+    replicator.SetNodeCount(2);
+    ASSERT_TRUE(replicator.BuildDelta(delta));
+    host.Send(delta);
+
+    ASSERT_TRUE(WaitFor([&] { return client.GetReconnectStats().FullResyncs == 1; }));
+    EXPECT_EQ(client.GetReconnectStats().Resumed, 0u);
+    EXPECT_TRUE(client.IsConnected());
+}
+
+// ============================================================================
+// Multicast Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, SubscribedStudentsGetCameraOverMulticast) {
+    constexpr int kStudents = 3;
+
+    std::vector<std::unique_ptr<NetworkLayer>> clients;
+    std::array<std::atomic<float>, kStudents>  lastYaw{};
+
+    NetworkLayer host;
+    MulticastConfig config;
+    config.Enabled   = true;
+    config.Port      = kPort + 13;
+    config.Interface = "127.0.0.1";
+    host.SetMulticast(config);
+    ASSERT_TRUE(host.StartHost(kPort + 13));
+    ASSERT_TRUE(host.GetMulticastStats().Active);
+
+    for (int i = 0; i < kStudents; ++i) {
+        lastYaw[i] = -1.f;
+        clients.push_back(std::make_unique<NetworkLayer>());
+        clients.back()->SetOnMessage([&, i](const NetMessage& msg) {
+            if (msg.Type == NetMsgType::CameraSync) lastYaw[i] = msg.Camera.Yaw;
+        });
+        clients.back()->Connect("127.0.0.1", kPort + 13);
+    }
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == kStudents; }));
+
+    // Heartbeats reach the group; each student subscribes on its next frame
+    ASSERT_TRUE(WaitFor([&] { return host.GetMulticastStats().Subscribers == kStudents; }, 5000));
+
+    uint64_t unicastBefore = host.GetStats().MessagesSent;
+    NetMessage msg;
+    msg.Type = NetMsgType::CameraSync;
+    for (int i = 0; i < 50; ++i) {
+        msg.Camera.Yaw = static_cast<float>(i);
+        host.Send(msg);
+    }
+
+    ASSERT_TRUE(WaitFor([&] {
+        return std::all_of(lastYaw.begin(), lastYaw.end(),
+                           [](const std::atomic<float>& yaw) { return yaw.load() == 49.f; });
+    }));
+
+    // One datagram per camera, not one frame per student
+    EXPECT_LT(host.GetStats().MessagesSent - unicastBefore, 10u);
+    EXPECT_GE(host.GetMulticastStats().Sent.Datagrams, 50u);
+    for (auto& client : clients)
+        EXPECT_GE(client->GetMulticastStats().Received.Received, 1u);
+}
+
+TEST_F(NetworkLayerTest, StudentDecliningMulticastStaysOnUnicast) {
+    NetworkLayer client;
+    NetworkLayer host;
+
+    MulticastConfig config;
+    config.Enabled   = true;
+    config.Port      = kPort + 14;
+    config.Interface = "127.0.0.1";
+    host.SetMulticast(config);
+    ASSERT_TRUE(host.StartHost(kPort + 14));
+
+    std::atomic<float> yaw = -1.f;
+    client.SetAcceptMulticast(false);
+    client.SetOnMessage([&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::CameraSync) yaw = msg.Camera.Yaw;
+    });
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 14));
+    ASSERT_TRUE(WaitFor([&] { return client.GetJoinLatencyMs() > 0.f; }));
+
+    NetMessage msg;
+    msg.Type = NetMsgType::CameraSync;
+    for (int i = 0; i < 10; ++i) {
+        msg.Camera.Yaw = static_cast<float>(i);
+        host.Send(msg);
+    }
+
+    ASSERT_TRUE(WaitFor([&] { return yaw.load() == 9.f; }));
+    EXPECT_EQ(host.GetMulticastStats().Subscribers, 0u);
+    EXPECT_EQ(client.GetMulticastStats().Received.Received, 0u);
+}
+
+// ============================================================================
+// Priority Lane Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, CameraLatencyHoldsDuringAssetTransfer) {
+    namespace fs = std::filesystem;
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    fs::path dir = fs::temp_directory_path() / ("atometa_lanes_" + std::to_string(stamp));
+    fs::create_directories(dir);
+
+    // Noise, so chunks stay full size with compression on
+    std::string model(8 << 20, '\0');
+    uint32_t    noise = 7;
+    for (auto& c : model) {
+        noise = noise * 1664525u + 1013904223u;
+        c     = static_cast<char>(noise >> 24);
+    }
+    std::ofstream((dir / "skull.glb").string(), std::ios::binary).write(model.data(), model.size());
+
+    auto store = std::make_shared<AssetStore>();
+    ASSERT_TRUE(store->AddFile((dir / "skull.glb").string(), "Skull"));
+
+    NetworkLayer client;
+    NetworkLayer host;
+    host.SetAssetStore(store);
+    ASSERT_TRUE(host.StartHost(kPort + 15));
+
+    std::atomic<bool>  ready = false;
+    std::atomic<float> yaw   = -1.f;
+    client.SetAssetCacheDir((dir / "cache").string());
+    client.SetOnMessage([&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::AssetManifest) ready = true;
+        if (msg.Type == NetMsgType::CameraSync)    yaw   = msg.Camera.Yaw;
+    });
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 15));
+
+    // The professor keeps orbiting while the download runs
+    NetMessage camera;
+    camera.Type = NetMsgType::CameraSync;
+    int frames  = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!ready.load() && std::chrono::steady_clock::now() < deadline) {
+        camera.Camera.Yaw = static_cast<float>(++frames);
+        host.Send(camera);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(ready.load());
+    camera.Camera.Yaw = -2.f;
+    host.Send(camera);
+    ASSERT_TRUE(WaitFor([&] { return yaw.load() == -2.f; }));
+
+    auto stats = host.GetSessionStats();
+    ASSERT_EQ(stats.size(), 1u);
+    const auto& realtime = stats[0].Lanes[static_cast<size_t>(Lane::Realtime)];
+    const auto& bulk     = stats[0].Lanes[static_cast<size_t>(Lane::Bulk)];
+    EXPECT_EQ(bulk.Messages, store->GetChunkCount());
+    EXPECT_GE(bulk.Fragments, bulk.Messages * 4);
+    EXPECT_GT(realtime.Messages, 0u);
+
+    // A camera frame waits for at most one fragment, never a whole chunk
+    // queue; the bound is loose for slow CI machines
+    EXPECT_LT(realtime.P99Ms, 20.f);
+    EXPECT_EQ(client.GetAssetProgress().ChunksReceived, store->GetChunkCount());
+
+    host.StopHost();
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+}
+
+// ============================================================================
+// Tick Batching Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, TickSendsOneFramePerLane) {
+    NetworkLayer client;
+    NetworkLayer host;
+    host.SetPingInterval(0);
+    host.SetTickRate(5);
+    ASSERT_TRUE(host.StartHost(kPort + 16));
+
+    std::mutex               mutex;
+    std::vector<std::string> chats;
+    std::atomic<float>       yaw     = -1.f;
+    std::atomic<int>         cameras = 0;
+    client.SetOnMessage([&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::CameraSync) {
+            yaw = msg.Camera.Yaw;
+            ++cameras;
+        }
+        if (msg.Type == NetMsgType::ChatMessage) {
+            std::lock_guard<std::mutex> lock(mutex);
+            chats.push_back(msg.Data.value("text", ""));
+        }
+    });
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 16));
+    ASSERT_TRUE(WaitFor([&] { return client.GetJoinLatencyMs() > 0.f; }));
+    uint64_t framesBefore = host.GetSessionStats()[0].MessagesSent;
+
+    NetMessage camera;
+    camera.Type = NetMsgType::CameraSync;
+    NetMessage chat;
+    chat.Type = NetMsgType::ChatMessage;
+    for (int i = 0; i < 10; ++i) {
+        camera.Camera.Yaw = static_cast<float>(i);
+        host.Send(camera);
+        chat.Data["text"] = std::to_string(i);
+        host.Send(chat);
+    }
+
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return chats.size() == 10 && yaw.load() == 9.f;
+    }));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < 10; ++i) EXPECT_EQ(chats[i], std::to_string(i));
+    }
+
+    // 20 sends in (at most) two ticks: a camera and a chat batch per tick
+    EXPECT_LE(host.GetSessionStats()[0].MessagesSent - framesBefore, 4u);
+    EXPECT_LE(cameras.load(), 2);
+    auto stats = host.GetStats();
+    EXPECT_GE(stats.Batches, 1u);
+    EXPECT_GE(stats.BatchedMessages, 9u);
+}
+
+TEST_F(NetworkLayerTest, TickSendsLegacyClientsOneFramePerMessage) {
+    NetworkLayer host;
+    host.SetPingInterval(0);
+    host.SetTickRate(5);
+    ASSERT_TRUE(host.StartHost(kPort + 28));
+
+    // Offers no subprotocol: predates Batch
+    asio::io_context ioc;
+    beast::websocket::stream<tcp::socket> legacy(ioc);
+    asio::connect(legacy.next_layer(),
+                  tcp::resolver(ioc).resolve("127.0.0.1", std::to_string(kPort + 28)));
+    legacy.handshake("127.0.0.1", "/");
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 1; }));
+
+    NetMessage camera;
+    camera.Type = NetMsgType::CameraSync;
+    NetMessage chat;
+    chat.Type = NetMsgType::ChatMessage;
+    for (int i = 0; i < 3; ++i) {
+        camera.Camera.Yaw = static_cast<float>(i);
+        host.Send(camera);
+        chat.Data["text"] = std::to_string(i);
+        host.Send(chat);
+    }
+
+    std::vector<std::string> chats;
+    while (chats.size() < 3) {
+        beast::flat_buffer buffer;
+        legacy.read(buffer);
+
+        NetMessage msg;
+        ASSERT_TRUE(NetMessage::Deserialize(beast::buffers_to_string(buffer.data()), msg));
+        ASSERT_NE(msg.Type, NetMsgType::Batch);
+        if (msg.Type == NetMsgType::ChatMessage)
+            chats.push_back(msg.Data.value("text", ""));
+    }
+    EXPECT_EQ(chats, (std::vector<std::string>{ "0", "1", "2" }));
+    EXPECT_EQ(host.GetStats().Batches, 0u);
+
+    beast::error_code ec;
+    legacy.close(beast::websocket::close_code::normal, ec);
+    host.StopHost();
+}
+
+// ============================================================================
+// Inbound Allocation Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, CameraFramesParseWithoutDom) {
+    NetMessage camera;
+    camera.Type            = NetMsgType::CameraSync;
+    camera.Camera.Yaw      = 12.5f;
+    camera.Camera.Distance = 4.f;
+    camera.Sequence        = 7;
+    camera.Timestamp       = 123456789;
+
+    std::string binary = camera.Serialize(WireFormat::Binary);
+    std::string text   = camera.Serialize(WireFormat::Json);
+
+    NetMessage out;
+    uint64_t   binaryAllocs, saxAllocs, domAllocs;
+    {
+        AllocScope scope;
+        for (int i = 0; i < 100; ++i)
+            ASSERT_TRUE(NetMessage::Deserialize(binary.data(), binary.size(), out));
+        binaryAllocs = scope.Count();
+    }
+    {
+        AllocScope scope;
+        ASSERT_TRUE(NetMessage::Deserialize(text.data(), text.size(), out));
+        saxAllocs = scope.Count();
+    }
+    {
+        AllocScope scope;
+        json dom = json::parse(text);
+        domAllocs = scope.Count();
+    }
+
+    EXPECT_EQ(binaryAllocs, 0u);
+    EXPECT_LT(saxAllocs, domAllocs);
+    EXPECT_FLOAT_EQ(out.Camera.Yaw, 12.5f);
+    EXPECT_FLOAT_EQ(out.Camera.Distance, 4.f);
+    EXPECT_EQ(out.Sequence, 7u);
+    EXPECT_EQ(out.Timestamp, 123456789u);
+}
+
+TEST_F(NetworkLayerTest, StudentReceivesCameraWithoutAllocating) {
+    constexpr int kFrames = 200;
+
+    NetworkLayer client;
+    NetworkLayer host;
+    host.SetPingInterval(0);
+    ASSERT_TRUE(host.StartHost(kPort + 17));
+
+    // Counted on the client's read thread, from the first camera frame
+    // to the last: every read, decode and dispatch in between
+    std::atomic<int>      received = 0;
+    std::atomic<uint64_t> allocs   = UINT64_MAX;
+    client.SetOnMessage([&](const NetMessage& msg) {
+        if (msg.Type != NetMsgType::CameraSync || msg.Camera.Yaw < 0.f) return;
+        int n = ++received;
+        if (n == 1) {
+            t_AllocCount  = 0;
+            t_CountAllocs = true;
+        } else if (n == kFrames) {
+            t_CountAllocs = false;
+            allocs        = t_AllocCount;
+        }
+    });
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 17));
+    ASSERT_TRUE(WaitFor([&] { return client.GetJoinLatencyMs() > 0.f; }));
+
+    NetMessage camera;
+    camera.Type = NetMsgType::CameraSync;
+    for (int i = 0; i < kFrames; ++i) {
+        camera.Camera.Yaw = static_cast<float>(i);
+        host.Send(camera);
+        // Keep frames from coalescing on the host
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    ASSERT_TRUE(WaitFor([&] { return allocs.load() != UINT64_MAX; }));
+    EXPECT_EQ(allocs.load(), 0u);
+}
+
+// ============================================================================
+// Student Message Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, NoisyStudentIsThrottledWithoutDelayingOthers) {
+    NetworkLayer host;
+    StudentRateLimit limit;
+    limit.MessagesPerSec = 5.f;
+    limit.MessageBurst   = 10;
+    host.SetStudentRateLimit(limit);
+
+    std::mutex       mutex;
+    std::vector<int> quiet;
+    int              noisy = 0;
+    host.SetOnMessage([&](const NetMessage& msg) {
+        if (msg.Type != NetMsgType::ChatMessage) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (msg.Data["from"] == "quiet") quiet.push_back(msg.Data["n"].get<int>());
+        else                             ++noisy;
+    });
+    ASSERT_TRUE(host.StartHost(kPort + 18));
+
+    NetworkLayer loud, calm;
+    ASSERT_TRUE(loud.Connect("127.0.0.1", kPort + 18));
+    ASSERT_TRUE(calm.Connect("127.0.0.1", kPort + 18));
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 2; }));
+
+    NetMessage chat;
+    chat.Type = NetMsgType::ChatMessage;
+    for (int i = 0; i < 100; ++i) {
+        chat.Data = { { "from", "noisy" }, { "n", i } };
+        loud.Send(chat);
+    }
+    for (int i = 0; i < 3; ++i) {
+        chat.Data = { { "from", "quiet" }, { "n", i } };
+        EXPECT_GT(calm.Send(chat), 0u);
+    }
+
+    // The outbox is written out as it fills; past kMaxUplink waiting,
+    // frames never leave the student
+    uint64_t dropped = loud.GetStats().UplinkDropped;
+    EXPECT_LE(dropped, 100 - NetworkLayer::kMaxUplink);
+
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return quiet.size() == 3;
+    }));
+    EXPECT_EQ(quiet, (std::vector<int>{ 0, 1, 2 }));
+
+    // Every frame the noisy student wrote is accounted for
+    ASSERT_TRUE(WaitFor([&] {
+        auto totals = host.GetStats().StudentMessages;
+        return totals.Delivered + totals.Throttled == 100 - dropped + 3;
+    }));
+    auto totals = host.GetStats().StudentMessages;
+    EXPECT_GE(totals.Throttled, 40u);
+    EXPECT_EQ(totals.Overflow, 0u);
+
+    // Burst plus what the rate refilled while the test ran
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_GE(noisy, 10);
+    EXPECT_LE(noisy, 25);
+}
+
+// ============================================================================
+// Client Lifecycle Tests
+// ============================================================================
+
+TEST_F(NetworkLayerTest, LeaveAndRejoinDoNotWaitOnTheNetwork) {
+    NetworkLayer client;
+    NetworkLayer host;
+    host.SetPingInterval(0);   // a host with nothing to say
+    std::atomic<int> chats = 0;
+    host.SetOnMessage([&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::ChatMessage) ++chats;
+    });
+    ASSERT_TRUE(host.StartHost(kPort + 24));
+
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 24));
+    ASSERT_TRUE(WaitFor([&] { return client.IsConnected() && host.GetClientCount() == 1; }));
+
+    // Goes out at once, not with the next frame from the host
+    NetMessage chat;
+    chat.Type = NetMsgType::ChatMessage;
+    client.Send(chat);
+    ASSERT_TRUE(WaitFor([&] { return chats == 1; }));
+
+    auto start = std::chrono::steady_clock::now();
+    client.Disconnect();
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 24));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_LT(elapsed, std::chrono::milliseconds(16));
+
+    ASSERT_TRUE(WaitFor([&] { return client.IsConnected() && host.GetClientCount() == 1; }));
+    client.Send(chat);
+    ASSERT_TRUE(WaitFor([&] { return chats == 2; }));
+
+    // The close handshake lets the host drop the student right away
+    client.Disconnect();
+    EXPECT_FALSE(client.IsConnected());
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 0; }));
+    host.StopHost();
+}
+
+TEST_F(NetworkLayerTest, DisconnectCancelsPendingRetry) {
+    NetworkLayer client;
+    client.SetReconnectBackoff(5000, 5000);
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 25));   // nobody listening
+    ASSERT_TRUE(WaitFor([&] { return client.GetReconnectStats().FailedAttempts == 1; }));
+
+    auto start = std::chrono::steady_clock::now();
+    client.Disconnect();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(16));
+
+    // Hosting on the same layer right after
+    ASSERT_TRUE(client.StartHost(kPort + 25));
+    NetworkLayer student;
+    ASSERT_TRUE(student.Connect("127.0.0.1", kPort + 25));
+    ASSERT_TRUE(WaitFor([&] { return client.GetClientCount() == 1; }));
+    client.StopHost();
+}
+
+// ============================================================================
+// Metrics Tests
+// ============================================================================
+
+namespace {
+    // One plain GET, as a Prometheus scraper sends it
+    beast::http::response<beast::http::string_body> HttpGet(uint16_t port, const char* target)
+    {
+        asio::io_context ioc;
+        beast::tcp_stream stream(ioc);
+        stream.connect(tcp::endpoint(asio::ip::make_address("127.0.0.1"), port));
+
+        beast::http::request<beast::http::empty_body> req(beast::http::verb::get, target, 11);
+        req.set(beast::http::field::host, "127.0.0.1");
+        beast::http::write(stream, req);
+
+        beast::flat_buffer buffer;
+        beast::http::response<beast::http::string_body> res;
+        beast::http::read(stream, buffer, res);
+        return res;
+    }
+}
+
+TEST_F(NetworkLayerTest, MetricsPortServesPrometheusText) {
+    NetworkLayer client;
+    NetworkLayer host;
+    host.SetMetricsPort(kPort + 20);
+    ASSERT_TRUE(host.StartHost(kPort + 19));
+
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 19));
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 1; }));
+
+    NetMessage camera;
+    camera.Type = NetMsgType::CameraSync;
+    host.Send(camera);
+    ASSERT_TRUE(WaitFor([&] { return host.GetStats().MessagesSent > 0; }));
+    host.RecordFrameTime(0.004f);
+
+    auto res = HttpGet(kPort + 20, "/metrics");
+    ASSERT_EQ(res.result_int(), 200);
+    EXPECT_EQ(res[beast::http::field::content_type], "text/plain; version=0.0.4; charset=utf-8");
+
+    const std::string& body = res.body();
+    EXPECT_NE(body.find("# TYPE atometa_clients gauge\natometa_clients 1\n"), std::string::npos);
+    EXPECT_NE(body.find("atometa_lane_queued{lane=\"bulk\"} 0\n"), std::string::npos);
+    EXPECT_NE(body.find("atometa_send_latency_seconds_count{lane=\"realtime\"} "), std::string::npos);
+    EXPECT_EQ(body.find("atometa_send_latency_seconds_count{lane=\"realtime\"} 0\n"), std::string::npos);
+    EXPECT_NE(body.find("atometa_frame_time_seconds_bucket{le=\"0.005\"} 1\n"), std::string::npos);
+
+    EXPECT_EQ(HttpGet(kPort + 20, "/").result_int(), 404);
+    host.StopHost();
+}
+
+TEST_F(NetworkLayerTest, BusyMetricsPortDoesNotStopTheHost) {
+    NetworkLayer first, second;
+    first.SetMetricsPort(kPort + 22);
+    second.SetMetricsPort(kPort + 22);
+    ASSERT_TRUE(first.StartHost(kPort + 21));
+    EXPECT_TRUE(second.StartHost(kPort + 23));
+
+    second.StopHost();
+    first.StopHost();
+}
+
+// ============================================================================
+// Compression Tests
+// ============================================================================
+
+namespace {
+    // Join snapshot of a scene with many named models
+    void SendLargeScene(NetworkLayer& host, size_t models)
+    {
+        SceneReplicator replicator;
+        NetMessage      delta;
+        replicator.SetNodeCount(models);
+        for (size_t i = 0; i < models; ++i) {
+            NetNode node;
+            node.Name     = "Anatomy/Thorax/Structure_" + std::to_string(i);
+            node.Position = { 0.25f * i, 1.f, 0.f };
+            replicator.SetNode(i, node);
+        }
+        ASSERT_TRUE(replicator.BuildDelta(delta));
+        host.Send(delta);
+    }
+}
+
+TEST_F(NetworkLayerTest, SceneArrivesCompressedButCameraDoesNot) {
+    NetworkLayer client;
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 26));
+    SendLargeScene(host, 100);
+
+    std::mutex         mutex;
+    SceneMirror        mirror;
+    std::atomic<float> yaw = 0.f;
+    client.SetOnMessage([&](const NetMessage& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        mirror.Apply(msg);
+        if (msg.Type == NetMsgType::CameraSync) yaw = msg.Camera.Yaw;
+    });
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 26));
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return mirror.HasState();
+    }));
+
+    auto joined = host.GetStats();
+    EXPECT_GT(joined.CompressedIn, 100 * 30u);
+    EXPECT_LT(joined.CompressedOut * 2, joined.CompressedIn);
+
+    NetMessage camera;
+    camera.Type       = NetMsgType::CameraSync;
+    camera.Camera.Yaw = 45.f;
+    host.Send(camera);
+    ASSERT_TRUE(WaitFor([&] { return yaw.load() == 45.f; }));
+    EXPECT_EQ(host.GetStats().CompressedIn, joined.CompressedIn);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(mirror.GetNodes().size(), 100u);
+    EXPECT_EQ(mirror.GetNodes()[99].Name, "Anatomy/Thorax/Structure_99");
+    host.StopHost();
+}
+
+TEST_F(NetworkLayerTest, StudentCanDeclineCompression) {
+    NetworkLayer client;
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(kPort + 27));
+    SendLargeScene(host, 100);
+
+    std::mutex  mutex;
+    SceneMirror mirror;
+    client.SetCompression(false);
+    client.SetOnMessage([&](const NetMessage& msg) {
+        std::lock_guard<std::mutex> lock(mutex);
+        mirror.Apply(msg);
+    });
+    ASSERT_TRUE(client.Connect("127.0.0.1", kPort + 27));
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return mirror.HasState();
+    }));
+
+    EXPECT_EQ(host.GetStats().CompressedIn, 0u);
+    host.StopHost();
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/PointerStream.h"
+
+#include <cmath>
+
+using namespace Atometa;
+
+class PointerStreamTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        settings.TickHz           = 30.f;
+        settings.BudgetBytes      = 2048.f;
+        settings.MinMove          = 0.f;
+        settings.KeyframeInterval = 0.5f;
+
+        track.MinDelay  = 0.1f;   // fixed playout delay
+        track.MaxDelay  = 0.1f;
+        track.HideAfter = 1.0f;
+    }
+
+    void TearDown() override {
+    }
+
+    static std::array<float, 3> Circle(double t) {
+        return { static_cast<float>(std::cos(t * 6.0)), static_cast<float>(std::sin(t * 6.0)), 0.f };
+    }
+
+    static NetMessage Pointer(uint32_t seq, uint64_t timeUs,
+                              std::vector<NetPointerSample> samples) {
+        NetMessage msg;
+        msg.Type      = NetMsgType::Pointer;
+        msg.Sequence  = seq;
+        msg.Timestamp = timeUs;
+        msg.Pointer   = std::move(samples);
+        return msg;
+    }
+
+    PointerStreamSettings settings;
+    PointerTrackSettings  track;
+    NetMessage            msg;
+};
+
+// ============================================================================
+// Host Stream Tests
+// ============================================================================
+
+TEST_F(PointerStreamTest, CoalescesSamplesPerTick) {
+    settings.BudgetBytes = 1e6f;
+    PointerStream stream(settings);
+
+    for (int i = 0; i < 10; ++i)
+        stream.AddSample(i * 0.001, { 0.01f * i, 0.f, 0.f });
+
+    ASSERT_TRUE(stream.Update(0.010, msg));
+    EXPECT_EQ(msg.Type, NetMsgType::Pointer);
+    EXPECT_EQ(msg.Sequence, 1u);
+    EXPECT_EQ(msg.Timestamp, 0u);
+    ASSERT_EQ(msg.Pointer.size(), 10u);
+    EXPECT_EQ(msg.Pointer.back().OffsetUs, 9000u);
+
+    // Nothing more until the next tick, however many samples arrive
+    stream.AddSample(0.011, { 1.f, 0.f, 0.f });
+    EXPECT_FALSE(stream.Update(0.020, msg));
+    ASSERT_TRUE(stream.Update(0.045, msg));
+    EXPECT_EQ(msg.Pointer.size(), 1u);
+}
+
+TEST_F(PointerStreamTest, StaysInBudgetAtAnyInputRate) {
+    PointerStream stream(settings);
+    size_t        bytes = 0, messages = 0;
+
+    // 10 s of a fast sweep sampled at 1 kHz
+    for (int ms = 0; ms < 10'000; ++ms) {
+        double now = ms * 0.001;
+        stream.AddSample(now, Circle(now));
+        if (!stream.Update(now, msg)) continue;
+
+        std::string wire = msg.Serialize(WireFormat::Binary);
+        EXPECT_EQ(PointerStream::WireCost(msg.Pointer.size()), wire.size() + 2);
+        bytes += wire.size() + 2;
+        ++messages;
+
+        // Thinned, never stale: the sample just taken is in the message
+        EXPECT_EQ(msg.Pointer.back().Position, Circle(now));
+    }
+
+    EXPECT_LE(bytes, 10 * 2048 + 2 * 2048 / 30 + 1);
+    EXPECT_GE(bytes, 9 * 2048);
+    EXPECT_LE(messages, 301u);
+    EXPECT_EQ(stream.GetStats().BytesSent, bytes);
+    EXPECT_GT(stream.GetStats().SamplesDropped, stream.GetStats().SamplesSent);
+}
+
+TEST_F(PointerStreamTest, ThinnedTickKeepsFirstAndNewest) {
+    settings.BudgetBytes = 30.f * PointerStream::WireCost(3);
+    PointerStream stream(settings);
+
+    for (int i = 0; i <= 20; ++i)
+        stream.AddSample(i * 0.001, { 0.01f * i, 0.f, 0.f });
+
+    ASSERT_TRUE(stream.Update(0.020, msg));
+    ASSERT_GE(msg.Pointer.size(), 3u);
+    ASSERT_LT(msg.Pointer.size(), 21u);
+    EXPECT_EQ(msg.Pointer.front().OffsetUs, 0u);
+    EXPECT_EQ(msg.Pointer.back().OffsetUs, 20000u);
+    EXPECT_FLOAT_EQ(msg.Pointer.back().Position[0], 0.2f);
+}
+
+TEST_F(PointerStreamTest, HideSendsEmptyMessageOnce) {
+    PointerStream stream(settings);
+    stream.AddSample(0.0, { 1.f, 2.f, 3.f });
+    ASSERT_TRUE(stream.Update(0.0, msg));
+
+    stream.Hide(0.05);
+    EXPECT_FALSE(stream.IsVisible());
+    ASSERT_TRUE(stream.Update(0.1, msg));
+    EXPECT_TRUE(msg.Pointer.empty());
+    EXPECT_EQ(msg.Timestamp, 50'000u);
+
+    // No keyframes while hidden
+    EXPECT_FALSE(stream.Update(2.0, msg));
+}
+
+TEST_F(PointerStreamTest, RestingPointerIsRepeated) {
+    PointerStream stream(settings);
+    stream.AddSample(0.0, { 1.f, 2.f, 3.f });
+    ASSERT_TRUE(stream.Update(0.0, msg));
+    EXPECT_FALSE(stream.Update(0.4, msg));
+
+    ASSERT_TRUE(stream.Update(0.5, msg));
+    ASSERT_EQ(msg.Pointer.size(), 1u);
+    EXPECT_EQ(msg.Timestamp, 500'000u);
+    EXPECT_EQ(msg.Pointer[0].Position, (std::array<float, 3>{ 1.f, 2.f, 3.f }));
+}
+
+TEST_F(PointerStreamTest, JumpPastDeltaRangeStartsOver) {
+    settings.BudgetBytes = 1e6f;
+    PointerStream stream(settings);
+    stream.AddSample(0.000, { 0.f, 0.f, 0.f });
+    stream.AddSample(0.001, { 0.1f, 0.f, 0.f });
+    stream.AddSample(0.002, { 100.f, 0.f, 0.f });
+
+    ASSERT_TRUE(stream.Update(0.003, msg));
+    ASSERT_EQ(msg.Pointer.size(), 1u);
+    EXPECT_EQ(msg.Timestamp, 2000u);
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(WireFormat::Binary), out));
+    EXPECT_FLOAT_EQ(out.Pointer[0].Position[0], 100.f);
+}
+
+// ============================================================================
+// Student Track Tests
+// ============================================================================
+
+TEST_F(PointerStreamTest, TrackInterpolatesBetweenSamples) {
+    PointerTrack pointer(track);
+    std::array<float, 3> out;
+    EXPECT_FALSE(pointer.Sample(1.0, out));
+
+    pointer.Push(Pointer(1, 0, { { 0, { 0.f, 0.f, 0.f } }, { 100'000, { 1.f, 2.f, 0.f } } }), 1.1);
+
+    // Offset 1.0; playout point at 1.15 is host 0.05
+    ASSERT_TRUE(pointer.Sample(1.15, out));
+    EXPECT_NEAR(out[0], 0.5f, 1e-4f);
+    EXPECT_NEAR(out[1], 1.0f, 1e-4f);
+
+    // No extrapolation: rests on the newest sample
+    ASSERT_TRUE(pointer.Sample(1.5, out));
+    EXPECT_FLOAT_EQ(out[0], 1.f);
+}
+
+TEST_F(PointerStreamTest, TrackHidesOnEmptyMessageAndSilence) {
+    PointerTrack pointer(track);
+    std::array<float, 3> out;
+    pointer.Push(Pointer(1, 0, { { 0, { 1.f, 1.f, 1.f } } }), 1.0);
+    pointer.Push(Pointer(2, 200'000, {}), 1.2);
+
+    EXPECT_TRUE(pointer.Sample(1.2, out));    // host 0.1: still shown
+    EXPECT_FALSE(pointer.Sample(1.35, out));  // host 0.25: hidden
+
+    PointerTrack quiet(track);
+    quiet.Push(Pointer(1, 0, { { 0, { 1.f, 1.f, 1.f } } }), 1.0);
+    EXPECT_TRUE(quiet.Sample(1.5, out));
+    EXPECT_FALSE(quiet.Sample(2.5, out));
+}
+
+TEST_F(PointerStreamTest, TrackFollowsStreamThroughTheWire) {
+    settings.BudgetBytes = 1e6f;
+    PointerStream stream(settings);
+    PointerTrack  pointer(track);
+
+    for (int ms = 0; ms <= 500; ++ms) {
+        double now = ms * 0.001;
+        stream.AddSample(now, Circle(now));
+        if (stream.Update(now, msg)) {
+            NetMessage wire;
+            ASSERT_TRUE(NetMessage::Deserialize(msg.Serialize(WireFormat::Binary), wire));
+            pointer.Push(wire, 1.0 + now);
+        }
+    }
+
+    // Playout 100 ms behind; 1 ms samples keep the chord error tiny
+    std::array<float, 3> out;
+    ASSERT_TRUE(pointer.Sample(1.3505, out));
+    auto expected = Circle(0.2505);
+    EXPECT_NEAR(out[0], expected[0], 0.005f);
+    EXPECT_NEAR(out[1], expected[1], 0.005f);
+    EXPECT_EQ(pointer.GetStats().Lost, 0u);
+}
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/PriorityLanes.h"
+
+using namespace Atometa;
+
+class PriorityLanesTest : public ::testing::Test {
+protected:
+    static SharedPayload Payload(size_t size, char fill = 'x') {
+        return std::make_shared<const std::string>(size, fill);
+    }
+
+    static SharedPayload Camera(float yaw) {
+        NetMessage msg;
+        msg.Type       = NetMsgType::CameraSync;
+        msg.Camera.Yaw = yaw;
+        return std::make_shared<const std::string>(msg.Serialize(WireFormat::Binary));
+    }
+
+    // What the session would put on the wire for a slice
+    static std::string Wire(const LaneSlice& slice) {
+        return slice.Header + slice.Payload->substr(slice.Offset, slice.Size);
+    }
+};
+
+// ============================================================================
+// Scheduling Tests
+// ============================================================================
+
+TEST_F(PriorityLanesTest, CameraPreemptsBulkBetweenFragments) {
+    LaneScheduler lanes;
+    lanes.SetFragmenting(true);
+    lanes.Push(Payload(4 * kMaxFragment), NetMsgType::AssetChunk, 0);
+
+    LaneSlice slice;
+    ASSERT_TRUE(lanes.Next(slice));
+    EXPECT_EQ(slice.From, Lane::Bulk);
+    EXPECT_TRUE(slice.IsFragment());
+    EXPECT_FALSE(slice.Last);
+
+    // Arrives mid-transfer: goes out before the next fragment
+    lanes.Push(Camera(1.f), NetMsgType::CameraSync, 0);
+    ASSERT_TRUE(lanes.Next(slice));
+    EXPECT_EQ(slice.From, Lane::Realtime);
+    EXPECT_FALSE(slice.IsFragment());
+
+    size_t fragments = 0;
+    while (lanes.Next(slice)) {
+        EXPECT_EQ(slice.From, Lane::Bulk);
+        EXPECT_EQ(slice.Offset, (fragments + 1) * kMaxFragment);
+        ++fragments;
+    }
+    EXPECT_EQ(fragments, 3u);
+    EXPECT_TRUE(slice.Last);
+}
+
+TEST_F(PriorityLanesTest, ControlAndBulkShareByWeight) {
+    LaneScheduler lanes;
+    for (int i = 0; i < 40; ++i) {
+        lanes.Push(Payload(kMaxFragment), NetMsgType::SceneDelta, 0);
+        lanes.Push(Payload(kMaxFragment), NetMsgType::AssetChunk, 0);
+    }
+
+    size_t control = 0, bulk = 0;
+    LaneSlice slice;
+    for (int i = 0; i < 50 && lanes.Next(slice); ++i)
+        (slice.From == Lane::Control ? control : bulk)++;
+
+    EXPECT_EQ(control, 40u);
+    EXPECT_EQ(bulk, 10u);
+}
+
+TEST_F(PriorityLanesTest, WaitingCameraIsReplaced) {
+    LaneScheduler lanes;
+    EXPECT_EQ(lanes.Push(Camera(1.f), NetMsgType::CameraSync, 0), LaneScheduler::PushResult::Queued);
+    EXPECT_EQ(lanes.Push(Camera(2.f), NetMsgType::CameraSync, 0), LaneScheduler::PushResult::Coalesced);
+    EXPECT_EQ(lanes.Push(Camera(3.f), NetMsgType::CameraSync, 0), LaneScheduler::PushResult::Coalesced);
+    EXPECT_EQ(lanes.Pending(), 1u);
+
+    LaneSlice slice;
+    ASSERT_TRUE(lanes.Next(slice));
+    NetMessage msg;
+    ASSERT_TRUE(NetMessage::Deserialize(Wire(slice), msg));
+    EXPECT_FLOAT_EQ(msg.Camera.Yaw, 3.f);
+    EXPECT_FALSE(lanes.Next(slice));
+}
+
+TEST_F(PriorityLanesTest, WaitingPointerIsReplacedButCameraKept) {
+    LaneScheduler lanes;
+    lanes.Push(Camera(1.f), NetMsgType::CameraSync, 0);
+    lanes.Push(Payload(40, 'a'), NetMsgType::Pointer, 0);
+    EXPECT_EQ(lanes.Push(Payload(40, 'b'), NetMsgType::Pointer, 0),
+              LaneScheduler::PushResult::Coalesced);
+    EXPECT_EQ(lanes.Pending(), 2u);
+
+    LaneSlice slice;
+    ASSERT_TRUE(lanes.Next(slice));
+    EXPECT_EQ(slice.Type, NetMsgType::CameraSync);
+    ASSERT_TRUE(lanes.Next(slice));
+    EXPECT_EQ(slice.From, Lane::Realtime);
+    EXPECT_EQ(Wire(slice), std::string(40, 'b'));
+}
+
+TEST_F(PriorityLanesTest, JsonFramesAreNeverSliced) {
+    LaneScheduler lanes;
+    lanes.Push(Payload(4 * kMaxFragment), NetMsgType::AssetChunk, 0);
+
+    LaneSlice slice;
+    ASSERT_TRUE(lanes.Next(slice));
+    EXPECT_FALSE(slice.IsFragment());
+    EXPECT_TRUE(slice.Last);
+    EXPECT_EQ(slice.Size, 4 * kMaxFragment);
+}
+
+TEST_F(PriorityLanesTest, StatsMeasureQueueToWireLatency) {
+    LaneScheduler lanes;
+    lanes.SetFragmenting(true);
+    lanes.Push(Camera(1.f), NetMsgType::CameraSync, 1000);
+    lanes.Push(Payload(2 * kMaxFragment), NetMsgType::AssetChunk, 1000);
+    EXPECT_EQ(lanes.GetStats()[static_cast<size_t>(Lane::Bulk)].Queued, 1u);
+
+    LaneSlice slice;
+    uint64_t  now = 1000;
+    while (lanes.Next(slice))
+        lanes.Done(slice, now += 2000);
+
+    auto stats    = lanes.GetStats();
+    auto realtime = stats[static_cast<size_t>(Lane::Realtime)];
+    auto bulk     = stats[static_cast<size_t>(Lane::Bulk)];
+    EXPECT_EQ(realtime.Messages, 1u);
+    EXPECT_FLOAT_EQ(realtime.P99Ms, 2.f);
+    EXPECT_EQ(bulk.Messages, 1u);
+    EXPECT_EQ(bulk.Fragments, 2u);
+    EXPECT_EQ(bulk.Queued, 0u);
+    EXPECT_EQ(bulk.Bytes, 2 * (kMaxFragment + kFragmentHeaderSize));
+    EXPECT_FLOAT_EQ(bulk.MaxMs, 6.f);
+}
+
+// ============================================================================
+// Reassembly Tests
+// ============================================================================
+
+TEST_F(PriorityLanesTest, FragmentsReassembleIntoOriginalFrame) {
+    NetMessage chunk;
+    chunk.Type      = NetMsgType::AssetChunk;
+    chunk.ChunkHash = "abc123";
+    chunk.Blob.resize(3 * kMaxFragment + 77);
+    for (size_t i = 0; i < chunk.Blob.size(); ++i)
+        chunk.Blob[i] = static_cast<char>(i * 13);
+
+    LaneScheduler lanes;
+    lanes.SetFragmenting(true);
+    lanes.Push(std::make_shared<const std::string>(chunk.Serialize(WireFormat::Binary)),
+               NetMsgType::AssetChunk, 0);
+
+    FragmentAssembler assembler;
+    LaneSlice         slice;
+    std::string       frame;
+    size_t            fragments = 0;
+    while (lanes.Next(slice)) {
+        NetMessage fragment;
+        ASSERT_TRUE(NetMessage::Deserialize(Wire(slice), fragment));
+        ASSERT_EQ(fragment.Type, NetMsgType::Fragment);
+        auto result = assembler.Add(fragment, frame);
+        EXPECT_EQ(result, slice.Last ? FragmentAssembler::Result::Complete
+                                     : FragmentAssembler::Result::Partial);
+        ++fragments;
+    }
+    EXPECT_EQ(fragments, 4u);
+    EXPECT_EQ(assembler.GetOpen(), 0u);
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(frame, out));
+    EXPECT_EQ(out.Type, NetMsgType::AssetChunk);
+    EXPECT_EQ(out.ChunkHash, chunk.ChunkHash);
+    EXPECT_EQ(out.Blob, chunk.Blob);
+}
+
+TEST_F(PriorityLanesTest, AssemblerDropsMisplacedFragments) {
+    FragmentAssembler assembler;
+    std::string       frame;
+
+    NetMessage fragment;
+    fragment.Type          = NetMsgType::Fragment;
+    fragment.Sequence      = 5;
+    fragment.FragmentTotal = 10;
+    fragment.Blob          = "abcd";
+
+    // Joined mid-frame
+    fragment.FragmentOffset = 4;
+    EXPECT_EQ(assembler.Add(fragment, frame), FragmentAssembler::Result::Invalid);
+
+    fragment.FragmentOffset = 0;
+    EXPECT_EQ(assembler.Add(fragment, frame), FragmentAssembler::Result::Partial);
+
+    // Skips bytes 4…7
+    fragment.FragmentOffset = 8;
+    EXPECT_EQ(assembler.Add(fragment, frame), FragmentAssembler::Result::Invalid);
+    EXPECT_EQ(assembler.GetOpen(), 0u);
+}
+
+TEST_F(PriorityLanesTest, FragmentJsonRoundTrip) {
+    NetMessage fragment;
+    fragment.Type           = NetMsgType::Fragment;
+    fragment.Sequence       = 9;
+    fragment.FragmentTotal  = 100;
+    fragment.FragmentOffset = 40;
+    fragment.Blob           = std::string("\x00\x01\xff", 3);
+
+    NetMessage out;
+    ASSERT_TRUE(NetMessage::Deserialize(fragment.Serialize(WireFormat::Json), out));
+    EXPECT_EQ(out.Type, NetMsgType::Fragment);
+    EXPECT_EQ(out.Sequence, 9u);
+    EXPECT_EQ(out.FragmentTotal, 100u);
+    EXPECT_EQ(out.FragmentOffset, 40u);
+    EXPECT_EQ(out.Blob, fragment.Blob);
+}
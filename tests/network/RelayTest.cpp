@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/NetworkLayer.h"
+
+#include <boost/asio/connect.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace Atometa;
+
+class RelayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+    }
+
+    void TearDown() override {
+    }
+
+    template<typename Cond>
+    static bool WaitFor(Cond cond, int timeoutMs = 2000) {
+        auto deadline = std::chrono::steady_clock::now()
+                      + std::chrono::milliseconds(timeoutMs);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (cond()) return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return cond();
+    }
+
+    static constexpr uint16_t kPort = 18531;
+};
+
+// ============================================================================
+// Relay Fan-out Tests
+// ============================================================================
+
+TEST_F(RelayTest, PublisherStreamReachesEveryStudent) {
+    constexpr int kStudents = 6;
+
+    std::vector<std::unique_ptr<NetworkLayer>> students;
+    std::atomic<int>   received = 0;
+    std::atomic<float> lastYaw  = 0.f;
+
+    NetworkLayer relay;
+    relay.SetRelayMode(true, "lecture");
+    relay.SetIOThreadCount(2);
+    ASSERT_TRUE(relay.StartHost(kPort));
+
+    for (int i = 0; i < kStudents; ++i) {
+        students.push_back(std::make_unique<NetworkLayer>());
+        students.back()->SetOnMessage([&](const NetMessage& msg) {
+            if (msg.Type == NetMsgType::CameraSync) {
+                lastYaw = msg.Camera.Yaw;
+                ++received;
+            }
+        });
+        students.back()->Connect("127.0.0.1", kPort);
+    }
+    ASSERT_TRUE(WaitFor([&] { return relay.GetClientCount() == kStudents; }));
+
+    NetworkLayer professor;
+    ASSERT_TRUE(professor.Publish("127.0.0.1", kPort, "lecture"));
+    ASSERT_TRUE(WaitFor([&] { return professor.IsConnected(); }));
+    EXPECT_EQ(professor.GetRole(), NetworkRole::Publisher);
+
+    // The publisher is the upstream, not one of the students
+    EXPECT_EQ(relay.GetClientCount(), static_cast<uint32_t>(kStudents));
+
+    NetMessage msg;
+    msg.Type       = NetMsgType::CameraSync;
+    msg.Camera.Yaw = 90.f;
+    EXPECT_GT(professor.Send(msg), 0u);
+
+    ASSERT_TRUE(WaitFor([&] { return received.load() == kStudents; }));
+    EXPECT_FLOAT_EQ(lastYaw.load(), 90.f);
+    EXPECT_EQ(relay.GetStats().MessagesRelayed, 1u);
+
+    professor.Disconnect();
+    relay.StopHost();
+}
+
+TEST_F(RelayTest, PublisherWithWrongKeyIsRejected) {
+    NetworkLayer relay;
+    relay.SetRelayMode(true, "lecture");
+    ASSERT_TRUE(relay.StartHost(kPort + 1));
+
+    NetworkLayer professor;
+    ASSERT_TRUE(professor.Publish("127.0.0.1", kPort + 1, "guess"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_FALSE(professor.IsConnected());
+
+    NetMessage msg;
+    msg.Type = NetMsgType::CameraSync;
+    EXPECT_EQ(professor.Send(msg), 0u);
+
+    professor.Disconnect();
+    relay.StopHost();
+}
+
+// ============================================================================
+// Relay Tree Tests
+// ============================================================================
+
+TEST_F(RelayTest, MultiLevelTreeReachesEveryStudent) {
+    constexpr int      kRelays   = 6;
+    constexpr int      kStudents = 4;
+    constexpr uint32_t kFanout   = 2;
+
+    std::vector<std::unique_ptr<NetworkLayer>> nodes;
+    std::vector<std::unique_ptr<std::atomic<float>>> lastYaw;
+
+    NetworkLayer host;
+    host.SetTreeFanout(kFanout);
+    host.SetPingInterval(50);
+    ASSERT_TRUE(host.StartHost(kPort + 2));
+
+    // Relays first so every later joiner has somewhere to be handed down to
+    for (int i = 0; i < kRelays + kStudents; ++i) {
+        nodes.push_back(std::make_unique<NetworkLayer>());
+        lastYaw.push_back(std::make_unique<std::atomic<float>>(-1.f));
+        auto& node = *nodes.back();
+        auto& yaw  = *lastYaw.back();
+        node.SetOnMessage([&yaw](const NetMessage& msg) {
+            if (msg.Type == NetMsgType::CameraSync) yaw = msg.Camera.Yaw;
+        });
+        node.SetPingInterval(50);
+        if (i < kRelays) {
+            node.SetTreeFanout(kFanout);
+            node.SetTreeRelay(static_cast<uint16_t>(kPort + 3 + i));
+        }
+        ASSERT_TRUE(node.Connect("127.0.0.1", kPort + 2));
+        ASSERT_TRUE(WaitFor([&] { return node.GetJoinLatencyMs() > 0.f; }));
+        // Let the new load reach the host before the next joiner arrives
+        ASSERT_TRUE(WaitFor([&] { return host.GetTreeStats().Subtree == static_cast<uint32_t>(i + 1); }));
+    }
+
+    EXPECT_EQ(host.GetClientCount(), kFanout);
+    EXPECT_GT(host.GetTreeStats().Redirects, 0u);
+
+    uint32_t maxDepth = 0;
+    for (auto& node : nodes) {
+        auto tree = node->GetTreeStats();
+        EXPECT_LE(tree.Children, kFanout);
+        maxDepth = std::max(maxDepth, tree.Depth);
+    }
+    EXPECT_GE(maxDepth, 3u);   // 2 + 4 nodes fill the first two levels
+
+    NetMessage msg;
+    msg.Type = NetMsgType::CameraSync;
+    for (int i = 0; i < 10; ++i) {
+        msg.Camera.Yaw = static_cast<float>(i);
+        host.Send(msg);
+    }
+    ASSERT_TRUE(WaitFor([&] {
+        for (auto& yaw : lastYaw)
+            if (yaw->load() != 9.f) return false;
+        return true;
+    }));
+
+    // Hop latencies add up along the path
+    for (auto& node : nodes) {
+        if (node->GetTreeStats().Depth < 3) continue;
+        ASSERT_TRUE(WaitFor([&] {
+            auto tree = node->GetTreeStats();
+            return tree.HopLatencyMs > 0.f && tree.PathLatencyMs > tree.HopLatencyMs;
+        }));
+    }
+}
+
+TEST_F(RelayTest, LegacyStudentStaysPastFanout) {
+    NetworkLayer host;
+    host.SetTreeFanout(1);
+    ASSERT_TRUE(host.StartHost(kPort + 12));
+
+    NetworkLayer relay;
+    relay.SetTreeRelay(kPort + 13);
+    ASSERT_TRUE(relay.Connect("127.0.0.1", kPort + 12));
+    ASSERT_TRUE(WaitFor([&] {
+        auto sessions = host.GetSessionStats();
+        return sessions.size() == 1 && sessions[0].TreeRelay;
+    }));
+
+    // Offers no subprotocol, so it could not read a redirect: the full
+    // host keeps it
+    asio::io_context ioc;
+    beast::websocket::stream<tcp::socket> legacy(ioc);
+    asio::connect(legacy.next_layer(),
+                  tcp::resolver(ioc).resolve("127.0.0.1", std::to_string(kPort + 12)));
+    legacy.handshake("127.0.0.1", "/");
+
+    beast::flat_buffer buffer;
+    legacy.read(buffer);
+    NetMessage first;
+    ASSERT_TRUE(NetMessage::Deserialize(beast::buffers_to_string(buffer.data()), first));
+    EXPECT_EQ(first.Type, NetMsgType::SessionInfo);
+
+    ASSERT_TRUE(WaitFor([&] { return host.GetClientCount() == 2; }));
+    EXPECT_EQ(relay.GetClientCount(), 0u);
+    EXPECT_EQ(host.GetTreeStats().Redirects, 0u);
+
+    beast::error_code ec;
+    legacy.close(beast::websocket::close_code::normal, ec);
+}
+
+TEST_F(RelayTest, StudentClimbsToAncestorWhenRelayLeaves) {
+    NetworkLayer host;
+    host.SetTreeFanout(1);
+    host.SetPingInterval(50);
+    ASSERT_TRUE(host.StartHost(kPort + 10));
+
+    SceneReplicator replicator;
+    NetMessage      delta;
+    replicator.SetNodeCount(1);
+    ASSERT_TRUE(replicator.BuildDelta(delta));
+    host.Send(delta);
+
+    auto relay = std::make_unique<NetworkLayer>();
+    relay->SetTreeRelay(kPort + 11);
+    relay->SetPingInterval(50);
+    ASSERT_TRUE(relay->Connect("127.0.0.1", kPort + 10));
+    ASSERT_TRUE(WaitFor([&] { return relay->GetJoinLatencyMs() > 0.f; }));
+    ASSERT_TRUE(WaitFor([&] {
+        auto sessions = host.GetSessionStats();
+        return sessions.size() == 1 && sessions[0].TreeRelay;
+    }));
+
+    // The host is full, so the student is handed to the relay
+    NetworkLayer student;
+    SceneMirror  mirror;
+    std::mutex   mirrorMutex;
+    student.SetReconnectBackoff(20, 100);
+    student.SetOnMessage([&](const NetMessage& msg) {
+        std::lock_guard<std::mutex> lock(mirrorMutex);
+        mirror.Apply(msg);
+    });
+    ASSERT_TRUE(student.Connect("127.0.0.1", kPort + 10));
+    ASSERT_TRUE(WaitFor([&] { return student.GetJoinLatencyMs() > 0.f; }));
+    EXPECT_EQ(student.GetTreeStats().Depth, 2u);
+    EXPECT_EQ(relay->GetClientCount(), 1u);
+
+    // The relay leaves; a delta goes out while the student re-attaches
+    relay.reset();
+    NetNode moved;
+    moved.Position = { 4.f, 0.f, 0.f };
+    replicator.SetNode(0, moved);
+    ASSERT_TRUE(replicator.BuildDelta(delta));
+    host.Send(delta);
+
+    ASSERT_TRUE(WaitFor([&] { return student.GetReconnectStats().Resumed == 1; }, 5000));
+    EXPECT_EQ(student.GetTreeStats().Depth, 1u);
+    EXPECT_GE(student.GetTreeStats().Repairs, 1u);
+    EXPECT_EQ(student.GetReconnectStats().FullResyncs, 0u);
+
+    std::lock_guard<std::mutex> lock(mirrorMutex);
+    EXPECT_EQ(mirror.GetSequence(), 2u);
+    EXPECT_FLOAT_EQ(mirror.GetNodes()[0].Position[0], 4.f);
+}
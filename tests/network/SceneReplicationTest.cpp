@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/SceneReplication.h"
+
+using namespace Atometa;
+
+class SceneReplicationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+    }
+
+    void TearDown() override {
+    }
+
+    static NetNode Node(const std::string& name, float x = 0.f) {
+        NetNode node;
+        node.Name     = name;
+        node.Position = { x, 0.f, 0.f };
+        return node;
+    }
+
+    // Host with a two-model scene whose baseline has already gone out
+    void StartScene(SceneReplicator& host) {
+        host.SetNodeCount(2);
+        host.SetNode(0, Node("Heart"));
+        host.SetNode(1, Node("Lung"));
+        NetMessage baseline;
+        ASSERT_TRUE(host.BuildDelta(baseline));
+    }
+};
+
+// ============================================================================
+// Replicator Tests
+// ============================================================================
+
+TEST_F(SceneReplicationTest, FirstDeltaCarriesEverything) {
+    SceneReplicator host;
+    host.SetNodeCount(1);
+    host.SetNode(0, Node("Heart", 1.f));
+
+    NetMessage delta;
+    ASSERT_TRUE(host.BuildDelta(delta));
+    EXPECT_EQ(delta.Sequence, 1u);
+    ASSERT_EQ(delta.Nodes.size(), 1u);
+    EXPECT_EQ(delta.Nodes[0].Fields, kNodeFieldAll);
+}
+
+TEST_F(SceneReplicationTest, OnlyChangedFieldsAreSent) {
+    SceneReplicator host;
+    StartScene(host);
+
+    NetMessage delta;
+    host.SetNode(0, Node("Heart"));
+    host.SetNode(1, Node("Lung"));
+    EXPECT_FALSE(host.BuildDelta(delta));
+
+    NetNode lung = Node("Lung");
+    lung.Visible = false;
+    host.SetNode(0, Node("Heart"));
+    host.SetNode(1, lung);
+    ASSERT_TRUE(host.BuildDelta(delta));
+    EXPECT_EQ(delta.Sequence, 2u);
+    ASSERT_EQ(delta.Nodes.size(), 1u);
+    EXPECT_EQ(delta.Nodes[0].Index,  1u);
+    EXPECT_EQ(delta.Nodes[0].Fields, kNodeFieldVisible);
+}
+
+TEST_F(SceneReplicationTest, SelectionAloneMakesADelta) {
+    SceneReplicator host;
+    StartScene(host);
+
+    NetMessage delta;
+    host.SetSelection(1);
+    ASSERT_TRUE(host.BuildDelta(delta));
+    EXPECT_EQ(delta.NodeIndex, 1);
+    EXPECT_TRUE(delta.Nodes.empty());
+}
+
+// ============================================================================
+// Mirror Tests
+// ============================================================================
+
+TEST_F(SceneReplicationTest, SnapshotThenDeltasMatchHost) {
+    SceneReplicator host;
+    StartScene(host);
+    host.SetNode(0, Node("Heart", 5.f));
+    NetMessage covered;
+    ASSERT_TRUE(host.BuildDelta(covered));
+
+    // Late joiner: snapshot includes seq 2, so delta 2 is skipped
+    SceneMirror student;
+    ASSERT_TRUE(student.Apply(host.BuildSnapshot()));
+    EXPECT_FALSE(student.Apply(covered));
+    EXPECT_EQ(student.GetStats().Stale, 1u);
+
+    host.SetNode(1, Node("Lung", -3.f));
+    host.SetSelection(0);
+    NetMessage delta;
+    ASSERT_TRUE(host.BuildDelta(delta));
+    ASSERT_TRUE(student.Apply(delta));
+
+    ASSERT_EQ(student.GetNodes().size(), 2u);
+    EXPECT_FLOAT_EQ(student.GetNodes()[0].Position[0],  5.f);
+    EXPECT_FLOAT_EQ(student.GetNodes()[1].Position[0], -3.f);
+    EXPECT_EQ(student.GetNodes()[1].Name, "Lung");
+    EXPECT_EQ(student.GetSelection(), 0);
+    EXPECT_EQ(student.GetStats().Gaps, 0u);
+}
+
+TEST_F(SceneReplicationTest, DeltaBeforeAnyStateIsIgnored) {
+    SceneReplicator host;
+    StartScene(host);
+    host.SetNode(0, Node("Heart", 1.f));
+    NetMessage delta;
+    ASSERT_TRUE(host.BuildDelta(delta));
+
+    SceneMirror student;
+    EXPECT_FALSE(student.Apply(delta));
+    EXPECT_FALSE(student.HasState());
+}
+
+TEST_F(SceneReplicationTest, RemovedModelsAreTruncated) {
+    SceneReplicator host;
+    SceneMirror     student;
+    host.SetNodeCount(2);
+    host.SetNode(0, Node("Heart"));
+    host.SetNode(1, Node("Lung"));
+    NetMessage delta;
+    ASSERT_TRUE(host.BuildDelta(delta));
+    ASSERT_TRUE(student.Apply(delta));
+
+    host.SetNodeCount(1);
+    ASSERT_TRUE(host.BuildDelta(delta));
+    ASSERT_TRUE(student.Apply(delta));
+    EXPECT_EQ(student.GetNodes().size(), 1u);
+}
+
+TEST_F(SceneReplicationTest, SkippedSequenceCountsGap) {
+    SceneReplicator host;
+    SceneMirror     student;
+    NetMessage delta;
+    host.SetNodeCount(1);
+    ASSERT_TRUE(host.BuildDelta(delta));
+    ASSERT_TRUE(student.Apply(delta));
+
+    host.SetNode(0, Node("A"));
+    ASSERT_TRUE(host.BuildDelta(delta));   // never delivered
+    host.SetNode(0, Node("B"));
+    ASSERT_TRUE(host.BuildDelta(delta));
+    ASSERT_TRUE(student.Apply(delta));
+
+    EXPECT_EQ(student.GetStats().Gaps, 1u);
+    EXPECT_EQ(student.GetNodes()[0].Name, "B");
+}
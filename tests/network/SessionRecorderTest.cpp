@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/SessionRecorder.h"
+#include "Atometa/Network/NetworkLayer.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace Atometa;
+namespace fs = std::filesystem;
+
+class SessionRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        root = fs::temp_directory_path() / ("atometa_rec_" + std::to_string(stamp));
+        fs::create_directories(root);
+        path = (root / "lecture.atrec").string();
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    static NetMessage Camera(float yaw) {
+        NetMessage msg;
+        msg.Type       = NetMsgType::CameraSync;
+        msg.Camera.Yaw = yaw;
+        return msg;
+    }
+
+    // Ten seconds of lecture: a camera update every 100 ms and a scene
+    // delta moving model 0 every second, keyframes every second
+    void RecordLecture() {
+        RecorderSettings settings;
+        settings.KeyframeInterval = 1.0;
+        SessionRecorder recorder(settings);
+        ASSERT_TRUE(recorder.Start(path));
+
+        SceneReplicator scene;
+        scene.SetNodeCount(2);
+        for (int i = 0; i < 100; ++i) {
+            uint64_t time = i * 100000ull;
+            if (i % 10 == 0) {
+                NetNode node;
+                node.Position = { static_cast<float>(i / 10), 0.f, 0.f };
+                scene.SetNode(0, node);
+                NetMessage delta;
+                ASSERT_TRUE(scene.BuildDelta(delta));
+                recorder.Record(delta, time);
+            }
+            recorder.Record(Camera(static_cast<float>(i)), time);
+        }
+        recorder.Stop();
+
+        auto stats = recorder.GetStats();
+        EXPECT_EQ(stats.Messages, 110u);
+        EXPECT_EQ(stats.Keyframes, 9u);
+        EXPECT_EQ(stats.Bytes, fs::file_size(path));
+    }
+
+    fs::path    root;
+    std::string path;
+};
+
+// ============================================================================
+// Playback Tests
+// ============================================================================
+
+TEST_F(SessionRecorderTest, ReplaysEveryMessageInOrder) {
+    RecordLecture();
+
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(path));
+    EXPECT_FALSE(player.WasRecovered());
+    EXPECT_DOUBLE_EQ(player.GetDuration(), 9.9);
+    EXPECT_EQ(player.GetKeyframes().size(), 9u);
+
+    std::vector<float> yaws;
+    size_t             deltas = 0;
+    player.Advance(20.0, [&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::CameraSync) yaws.push_back(msg.Camera.Yaw);
+        if (msg.Type == NetMsgType::SceneDelta) ++deltas;
+    });
+
+    ASSERT_EQ(yaws.size(), 100u);
+    for (size_t i = 0; i < yaws.size(); ++i)
+        EXPECT_FLOAT_EQ(yaws[i], static_cast<float>(i));
+    EXPECT_EQ(deltas, 10u);
+    EXPECT_TRUE(player.AtEnd());
+}
+
+TEST_F(SessionRecorderTest, SpeedScalesPlayback) {
+    RecordLecture();
+
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(path));
+    player.SetSpeed(4.0);
+
+    float lastYaw = -1.f;
+    auto  deliver = [&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::CameraSync) lastYaw = msg.Camera.Yaw;
+    };
+
+    player.Advance(1.0, deliver);
+    EXPECT_DOUBLE_EQ(player.GetPosition(), 4.0);
+    EXPECT_FLOAT_EQ(lastYaw, 40.f);
+
+    player.SetPaused(true);
+    EXPECT_EQ(player.Advance(1.0, deliver), 0u);
+
+    player.SetSpeed(100.0);
+    EXPECT_DOUBLE_EQ(player.GetSpeed(), SessionPlayer::kMaxSpeed);
+}
+
+// ============================================================================
+// Seek Tests
+// ============================================================================
+
+TEST_F(SessionRecorderTest, SeekStartsFromNearestKeyframe) {
+    RecordLecture();
+
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(path));
+    player.Advance(8.0, [](const NetMessage&) {});
+
+    // Backwards to 5.55 s: the keyframe written after the 5.0 s delta,
+    // then the cameras at 5.0 … 5.5 s
+    std::vector<NetMessage> got;
+    player.Seek(5.55, [&](const NetMessage& msg) { got.push_back(msg); });
+
+    ASSERT_EQ(got.size(), 8u);
+    EXPECT_EQ(got[0].Type, NetMsgType::SceneSnapshot);
+    ASSERT_EQ(got[0].Nodes.size(), 2u);
+    EXPECT_FLOAT_EQ(got[0].Nodes[0].Position[0], 5.f);
+    EXPECT_EQ(got[1].Type, NetMsgType::CameraSync);
+    EXPECT_FLOAT_EQ(got[1].Camera.Yaw, 49.f);
+    EXPECT_FLOAT_EQ(got[2].Camera.Yaw, 50.f);
+    EXPECT_FLOAT_EQ(got.back().Camera.Yaw, 55.f);
+
+    // Playback continues from the target
+    float next = -1.f;
+    player.Advance(0.1, [&](const NetMessage& msg) { next = msg.Camera.Yaw; });
+    EXPECT_FLOAT_EQ(next, 56.f);
+}
+
+TEST_F(SessionRecorderTest, SeekBeforeFirstKeyframeReplaysFromStart) {
+    RecordLecture();
+
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(path));
+
+    size_t cameras = 0;
+    player.Seek(0.35, [&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::CameraSync) ++cameras;
+    });
+    EXPECT_EQ(cameras, 4u);
+}
+
+// ============================================================================
+// Recovery Tests
+// ============================================================================
+
+TEST_F(SessionRecorderTest, RebuildsIndexOfTruncatedFile) {
+    RecordLecture();
+
+    // Drop the trailer and most of the index, as a crash while closing would
+    fs::resize_file(path, fs::file_size(path) - 60);
+
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(path));
+    EXPECT_TRUE(player.WasRecovered());
+    EXPECT_EQ(player.GetKeyframes().size(), 9u);
+    EXPECT_GT(player.GetDuration(), 9.0);
+
+    float yaw = -1.f;
+    player.Seek(7.0, [&](const NetMessage& msg) {
+        if (msg.Type == NetMsgType::CameraSync) yaw = msg.Camera.Yaw;
+    });
+    EXPECT_FLOAT_EQ(yaw, 70.f);
+}
+
+TEST_F(SessionRecorderTest, RejectsForeignFile) {
+    std::ofstream(path) << "definitely not a recording";
+
+    SessionPlayer player;
+    EXPECT_FALSE(player.Open(path));
+    EXPECT_FALSE(player.IsOpen());
+}
+
+// ============================================================================
+// Host Integration Tests
+// ============================================================================
+
+TEST_F(SessionRecorderTest, HostRecordsEverySentMessage) {
+    NetworkLayer host;
+    ASSERT_TRUE(host.StartHost(18631));
+
+    auto recorder = std::make_shared<SessionRecorder>();
+    ASSERT_TRUE(recorder->Start(path));
+    host.SetRecorder(recorder);
+
+    for (int i = 0; i < 20; ++i)
+        host.Send(Camera(static_cast<float>(i)));
+
+    host.SetRecorder(nullptr);
+    host.Send(Camera(99.f));
+    recorder->Stop();
+    EXPECT_EQ(recorder->GetStats().Messages, 20u);
+
+    SessionPlayer player;
+    ASSERT_TRUE(player.Open(path));
+    float lastYaw = -1.f;
+    player.Advance(60.0, [&](const NetMessage& msg) { lastYaw = msg.Camera.Yaw; });
+    EXPECT_FLOAT_EQ(lastYaw, 19.f);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "Atometa/Network/StudentInbox.h"
+
+using namespace Atometa;
+
+class StudentInboxTest : public ::testing::Test {
+protected:
+    static NetMessage Chat(int n) {
+        NetMessage msg;
+        msg.Type = NetMsgType::ChatMessage;
+        msg.Data = { { "n", n } };
+        return msg;
+    }
+
+    static StudentRateLimit Limit(float rate, uint32_t burst, uint32_t queued = 64) {
+        StudentRateLimit limit;
+        limit.MessagesPerSec = rate;
+        limit.MessageBurst   = burst;
+        limit.MaxQueued      = queued;
+        return limit;
+    }
+};
+
+// ============================================================================
+// Token Bucket Tests
+// ============================================================================
+
+TEST_F(StudentInboxTest, BucketStartsFullAndRefillsAtRate) {
+    TokenBucket bucket;
+    for (int i = 0; i < 5; ++i)
+        EXPECT_TRUE(bucket.Take(1.0, 10.0, 5.0, 0));
+    EXPECT_FALSE(bucket.Take(1.0, 10.0, 5.0, 0));
+
+    // 10 per second: one token every 100 ms
+    EXPECT_FALSE(bucket.Take(1.0, 10.0, 5.0, 50'000));
+    EXPECT_TRUE(bucket.Take(1.0, 10.0, 5.0, 100'000));
+
+    // Never more than the burst, however long it was idle
+    EXPECT_TRUE(bucket.Take(5.0, 10.0, 5.0, 60'000'000));
+    EXPECT_FALSE(bucket.Take(1.0, 10.0, 5.0, 60'000'000));
+}
+
+TEST_F(StudentInboxTest, OversizeCostNeverPasses) {
+    TokenBucket bucket;
+    EXPECT_FALSE(bucket.Take(6.0, 10.0, 5.0, 0));
+    EXPECT_FALSE(bucket.Take(6.0, 10.0, 5.0, 10'000'000));
+}
+
+// ============================================================================
+// Inbox Tests
+// ============================================================================
+
+TEST_F(StudentInboxTest, ThrottlesPastTheBurst) {
+    StudentInbox inbox(Limit(1.f, 3));
+    for (int i = 0; i < 5; ++i)
+        inbox.Push(1, Chat(i), 0);
+
+    auto stats = inbox.GetStats(1);
+    EXPECT_EQ(stats.Queued, 3u);
+    EXPECT_EQ(stats.Throttled, 2u);
+
+    // A second later there is room for one more
+    EXPECT_EQ(inbox.Push(1, Chat(5), 1'000'000), StudentInbox::Result::Queued);
+}
+
+TEST_F(StudentInboxTest, RoundRobinKeepsNoisyStudentFromCuttingIn) {
+    StudentInbox inbox(Limit(1000.f, 1000));
+    for (int i = 0; i < 50; ++i)
+        inbox.Push(1, Chat(i), 0);
+    inbox.Push(2, Chat(100), 0);
+    inbox.Push(3, Chat(200), 0);
+
+    // The quiet students are served in the first round, not after the
+    // noisy one's backlog
+    std::vector<NetMessage> out;
+    ASSERT_EQ(inbox.Drain(out, 3), 3u);
+    EXPECT_EQ(out[0].Data["n"], 0);
+    EXPECT_EQ(out[1].Data["n"], 100);
+    EXPECT_EQ(out[2].Data["n"], 200);
+
+    // Only the noisy one is left, in its own order
+    out.clear();
+    EXPECT_EQ(inbox.Drain(out, 100), 49u);
+    EXPECT_EQ(out.front().Data["n"], 1);
+    EXPECT_EQ(out.back().Data["n"], 49);
+    EXPECT_EQ(inbox.GetQueued(), 0u);
+}
+
+TEST_F(StudentInboxTest, FullQueueOverflows) {
+    StudentInbox inbox(Limit(1000.f, 1000, 4));
+    for (int i = 0; i < 6; ++i)
+        inbox.Push(1, Chat(i), 0);
+
+    auto totals = inbox.GetTotals();
+    EXPECT_EQ(totals.Queued, 4u);
+    EXPECT_EQ(totals.Overflow, 2u);
+}
+
+TEST_F(StudentInboxTest, RelaySpeaksForItsSubtree) {
+    StudentInbox inbox(Limit(1.f, 2));
+
+    // A relay with three students below it: four shares
+    for (int i = 0; i < 10; ++i)
+        inbox.Push(1, Chat(i), 0, 4);
+    inbox.Push(2, Chat(100), 0);
+    EXPECT_EQ(inbox.GetStats(1).Queued, 8u);
+
+    std::vector<NetMessage> out;
+    inbox.Drain(out, 6);
+    ASSERT_EQ(out.size(), 6u);
+    EXPECT_EQ(out[3].Data["n"], 3);
+    EXPECT_EQ(out[4].Data["n"], 100);
+    EXPECT_EQ(out[5].Data["n"], 4);
+}
+
+TEST_F(StudentInboxTest, DepartedStudentIsServedThenForgotten) {
+    StudentInbox inbox;
+    inbox.Push(1, Chat(0), 0);
+    inbox.Remove(1);
+    EXPECT_EQ(inbox.GetQueued(), 1u);
+
+    std::vector<NetMessage> out;
+    EXPECT_EQ(inbox.Drain(out, 10), 1u);
+    EXPECT_EQ(inbox.GetStats(1).Delivered, 0u);   // gone
+    EXPECT_EQ(inbox.GetTotals().Delivered, 1u);
+}